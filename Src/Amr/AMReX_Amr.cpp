@@ -1710,6 +1710,10 @@ Amr::checkPoint ()
     VisMF::Header::Version currentVersion(VisMF::GetHeaderVersion());
     VisMF::SetHeaderVersion(checkpoint_headerversion);
 
+    // ---- checkpoints must not be compressed lossily
+    Real thePrevCompressionTolerance = VisMF::GetCompressionTolerance();
+    VisMF::SetCompressionTolerance(0.0);
+
     Real dCheckPointTime0 = amrex::second();
 
     const std::string& ckfile = amrex::Concatenate(check_file_root,level_steps[0],file_name_digits);
@@ -1867,6 +1871,7 @@ Amr::checkPoint ()
   FArrayBox::setFormat(thePrevFormat);
 
   VisMF::SetHeaderVersion(currentVersion);
+  VisMF::SetCompressionTolerance(thePrevCompressionTolerance);
 
   BL_PROFILE_REGION_STOP("Amr::checkPoint()");
 }
@@ -479,6 +479,12 @@ amrex::Initialize (int& argc, char**& argv, bool build_parm_parse,
     BL_PROFILE_INITPARAMS();
 #endif
     machine::Initialize();
+    // The node-aware SFC distribution may be computed on one process only,
+    // e.g., by the weighted makeSFC, so the topology is gathered here, on
+    // all processes.
+    if (DistributionMapping::SFC_NodeAware()) {
+        machine::rank_node_ids();
+    }
 #ifdef AMREX_USE_CUDA
     Gpu::Fuser::Initialize();
 #endif
@@ -523,6 +529,9 @@ amrex::Finalize (amrex::AMReX* pamrex)
 {
     AMReX::erase(pamrex);
 
+    // Finish the output jobs so that the writers are in the profiler output.
+    AsyncOut::Finish();
+
     BL_TINY_PROFILE_FINALIZE();
     BL_PROFILE_FINALIZE();
 
@@ -37,6 +37,7 @@ namespace {
     bool use_buddy_allocator = false;
     Long buddy_allocator_size = 0L;
     Long the_arena_init_size = 0L;
+    bool use_size_classes = false;
 #ifdef AMREX_USE_HIP
     bool the_arena_is_managed = false; // xxxxx HIP FIX HERE
 #else
@@ -167,6 +168,7 @@ Arena::Initialize ()
     pp.query("the_arena_init_size", the_arena_init_size);
     pp.query("the_arena_is_managed", the_arena_is_managed);
     pp.query("abort_on_out_of_gpu_memory", abort_on_out_of_gpu_memory);
+    pp.query("use_size_classes", use_size_classes);
 
 #ifdef AMREX_USE_GPU
     if (use_buddy_allocator)
@@ -192,9 +194,9 @@ Arena::Initialize ()
     {
 #if defined(BL_COALESCE_FABS) || defined(AMREX_USE_GPU)
         if (the_arena_is_managed) {
-            the_arena = new CArena(0, ArenaInfo().SetPreferred());
+            the_arena = new CArena(0, ArenaInfo().SetPreferred().SetSizeClasses(use_size_classes));
         } else {
-            the_arena = new CArena(0, ArenaInfo().SetDeviceMemory());
+            the_arena = new CArena(0, ArenaInfo().SetDeviceMemory().SetSizeClasses(use_size_classes));
         }
 #ifdef AMREX_USE_GPU
         if (the_arena_init_size <= 0) {
@@ -209,12 +211,16 @@ Arena::Initialize ()
         the_arena->free(p);
 #endif
 #else
-        the_arena = new BArena;
+        if (use_size_classes) {
+            the_arena = new CArena(0, ArenaInfo().SetSizeClasses());
+        } else {
+            the_arena = new BArena;
+        }
 #endif
     }
 
 #ifdef AMREX_USE_GPU
-    the_device_arena = new CArena(0, ArenaInfo().SetDeviceMemory());
+    the_device_arena = new CArena(0, ArenaInfo().SetDeviceMemory().SetSizeClasses(use_size_classes));
 #else
     the_device_arena = new BArena;
 #endif
@@ -227,7 +233,7 @@ Arena::Initialize ()
 
     // When USE_CUDA=FALSE, we call mlock to pin the cpu memory.
     // When USE_CUDA=TRUE, we call cudaHostAlloc to pin the host memory.
-    the_pinned_arena = new CArena(0, ArenaInfo().SetHostAlloc());
+    the_pinned_arena = new CArena(0, ArenaInfo().SetHostAlloc().SetSizeClasses(use_size_classes));
 
     std::size_t N = 1024UL*1024UL*8UL;
 
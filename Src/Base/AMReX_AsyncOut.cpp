@@ -4,8 +4,12 @@
 #include <AMReX_Vector.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Utility.H>
+#include <AMReX_BLProfiler.H>
 #include <AMReX.H>
 
+#include <condition_variable>
+#include <mutex>
+
 namespace amrex {
 namespace AsyncOut {
 
@@ -13,52 +17,104 @@ namespace {
 
 int s_asyncout = false;
 int s_noutfiles = 64;
-MPI_Comm s_comm = MPI_COMM_NULL;
+int s_nthreads = 1;
+Long s_max_bytes = 0;
+
+// One communicator for each writer thread so that the turns taken by the
+// processes writing the same file in the jobs of different threads do not
+// get mixed up.
+Vector<MPI_Comm> s_comms;
 
-std::unique_ptr<BackgroundThread> s_thread;
+Vector<std::unique_ptr<BackgroundThread> > s_threads;
+int s_next_thread = 0;
+thread_local int t_ithread = 0;
 
 WriteInfo s_info;
 
+std::mutex s_mutex;
+std::condition_variable s_cond;
+Long s_bytes_in_flight = 0;
+
+// Stats of the jobs done since they were last given to the profiler,
+// which only takes them from the main thread.
+Long s_njobs_done = 0;
+double s_job_time = 0.0;
+Long s_bytes_written = 0;
+
+void record_stats ()
+{
+#ifdef AMREX_TINY_PROFILING
+    Long njobs, nbytes;
+    double dt;
+    {
+        std::lock_guard<std::mutex> lck(s_mutex);
+        njobs = s_njobs_done;
+        dt = s_job_time;
+        nbytes = s_bytes_written;
+        s_njobs_done = 0;
+        s_job_time = 0.0;
+        s_bytes_written = 0;
+    }
+    if (njobs > 0) {
+        TinyProfiler::AddTime("AsyncOut::Job", njobs, dt);
+        TinyProfiler::AddCounter("AsyncOut bytes written", nbytes);
+    }
+#endif
+}
+
 }
 
 void Initialize ()
 {
-    amrex::ignore_unused(s_comm,s_info);
+    amrex::ignore_unused(s_info);
 
     ParmParse pp("amrex");
     pp.query("async_out", s_asyncout);
     pp.query("async_out_nfiles", s_noutfiles);
+    pp.query("async_out_nthreads", s_nthreads);
+    pp.query("async_out_max_bytes", s_max_bytes);
 
     int nprocs = ParallelDescriptor::NProcs();
     s_noutfiles = std::min(s_noutfiles, nprocs);
+    s_nthreads = std::max(s_nthreads, 1);
 
     if (s_asyncout and s_noutfiles < nprocs)
     {
 #ifdef AMREX_MPI_THREAD_MULTIPLE
         int myproc = ParallelDescriptor::MyProc();
         s_info = GetWriteInfo(myproc);
-        MPI_Comm_split(ParallelDescriptor::Communicator(), s_info.ifile, myproc, &s_comm);
+        s_comms.resize(s_nthreads, MPI_COMM_NULL);
+        MPI_Comm_split(ParallelDescriptor::Communicator(), s_info.ifile, myproc, &s_comms[0]);
+        for (int i = 1; i < s_nthreads; ++i) {
+            MPI_Comm_dup(s_comms[0], &s_comms[i]);
+        }
 #else
         amrex::Abort("AsyncOut with " + std::to_string(s_noutfiles) + " and "
                      +std::to_string(nprocs) + " processes requires MPI_THREAD_MULTIPLE");
 #endif
     }
 
-    if (s_asyncout) s_thread.reset(new BackgroundThread());
+    if (s_asyncout) {
+        for (int i = 0; i < s_nthreads; ++i) {
+            s_threads.emplace_back(new BackgroundThread());
+        }
+    }
+    s_next_thread = 0;
+    s_bytes_in_flight = 0;
 
     ExecOnFinalize(Finalize);
 }
 
 void Finalize ()
 {
-    if (s_thread) {
-        s_thread.reset();
-    }
+    s_threads.clear();
 
 #ifdef AMREX_USE_MPI
-    if (s_comm != MPI_COMM_NULL) MPI_Comm_free(&s_comm);
-    s_comm = MPI_COMM_NULL;
+    for (auto& comm : s_comms) {
+        if (comm != MPI_COMM_NULL) MPI_Comm_free(&comm);
+    }
 #endif
+    s_comms.clear();
 }
 
 bool UseAsyncOut () { return s_asyncout; }
@@ -86,19 +142,60 @@ WriteInfo GetWriteInfo (int rank)
     return WriteInfo{ifile, ispot, nspots};
 }
 
-void Submit (std::function<void()>&& a_f)
+void Submit (std::function<void()>&& a_f, Long a_nbytes)
 {
-    s_thread->Submit(std::move(a_f));
+    record_stats();
+
+    const int ithread = s_next_thread;
+    s_next_thread = (s_next_thread+1) % s_threads.size();
+
+    auto f = std::make_shared<std::function<void()> >(std::move(a_f));
+    s_threads[ithread]->Submit([=] ()
+    {
+        t_ithread = ithread;
+        const double t0 = amrex::second();
+        (*f)();
+        const double dt = amrex::second() - t0;
+
+        std::lock_guard<std::mutex> lck(s_mutex);
+        s_bytes_in_flight -= a_nbytes;
+        ++s_njobs_done;
+        s_job_time += dt;
+        s_bytes_written += a_nbytes;
+        s_cond.notify_all();
+    });
 }
 
-void Submit (std::function<void()> const& a_f)
+void Submit (std::function<void()> const& a_f, Long a_nbytes)
 {
-    s_thread->Submit(a_f);
+    Submit(std::function<void()>(a_f), a_nbytes);
+}
+
+void Reserve (Long a_nbytes)
+{
+    BL_PROFILE_VAR_NS("AsyncOut::Reserve::wait", blp_wait);
+    {
+        std::unique_lock<std::mutex> lck(s_mutex);
+        auto fits = [=] () -> bool {
+            return s_max_bytes <= 0 or s_bytes_in_flight == 0
+                or s_bytes_in_flight + a_nbytes <= s_max_bytes;
+        };
+        if (not fits()) {
+            BL_PROFILE_VAR_START(blp_wait);
+            s_cond.wait(lck, fits);
+            BL_PROFILE_VAR_STOP(blp_wait);
+        }
+        s_bytes_in_flight += a_nbytes;
+    }
+    record_stats();
 }
 
 void Finish ()
 {
-    s_thread->Finish();
+    for (auto& t : s_threads) {
+        t->Finish();
+    }
+    record_stats();
 }
 
 void Wait ()
@@ -109,7 +206,7 @@ void Wait ()
         Vector<MPI_Request> reqs(N);
         Vector<MPI_Status> stats(N);
         for (int i = 0; i < N; ++i) {
-            reqs[i] = ParallelDescriptor::Abarrier(s_comm).req();
+            reqs[i] = ParallelDescriptor::Abarrier(s_comms[t_ithread]).req();
         }
         ParallelDescriptor::Waitall(reqs, stats);
     }
@@ -124,7 +221,7 @@ void Notify ()
         Vector<MPI_Request> reqs(N);
         Vector<MPI_Status> stats(N);
         for (int i = 0; i < N; ++i) {
-            reqs[i] = ParallelDescriptor::Abarrier(s_comm).req();
+            reqs[i] = ParallelDescriptor::Abarrier(s_comms[t_ithread]).req();
         }
         ParallelDescriptor::Waitall(reqs, stats);
     }
@@ -3,6 +3,7 @@
 #include <AMReX_BoxArray.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_Utility.H>
+#include <AMReX_ParmParse.H>
 #include <AMReX_MFIter.H>
 #include <AMReX_BaseFab.H>
 
@@ -25,6 +26,7 @@ Long BARef::total_hash_bytes_hwm = 0L;
 
 bool    BARef::initialized = false;
 bool BoxArray::initialized = false;
+bool BoxArray::use_bvh     = false;
 
 namespace {
     const int bl_ignore_max = 100000;
@@ -180,6 +182,8 @@ BARef::resize (Long n) {
     m_abox.resize(n);
     hash.clear();
     has_hashmap = false;
+    tree.clear();
+    has_tree = false;
 #ifdef AMREX_MEM_PROFILING
     updateMemoryUsage_box(1);
 #endif
@@ -206,8 +210,8 @@ BARef::updateMemoryUsage_box (int s)
 void
 BARef::updateMemoryUsage_hash (int s)
 {
-    if (hash.size() > 0) {
-	Long b = sizeof(hash);
+    if (hash.size() > 0 || !tree.empty()) {
+	Long b = sizeof(hash) + tree.bytes();
 	for (const auto& x: hash) {
 	    b += amrex::gcc_map_node_extra_bytes
 		+ sizeof(IntVect) + amrex::bytesOf(x.second);
@@ -258,6 +262,9 @@ BoxArray::Initialize ()
     if (!initialized) {
 	initialized = true;
 	BARef::Initialize();
+
+        ParmParse pp("boxarray");
+        pp.query("use_bvh", use_bvh);
     }
 
     amrex::ExecOnFinalize(BoxArray::Finalize);
@@ -267,6 +274,7 @@ void
 BoxArray::Finalize ()
 {
     initialized = false;
+    use_bvh = false;
 }
 
 BoxArray::BoxArray ()
@@ -1151,6 +1159,51 @@ BoxArray::intersections (const Box&                         bx,
     intersections(bx,isects,first_only,IntVect(ng));
 }
 
+void
+BoxArray::intersections (const Vector<Box>&                          bxs,
+                         Vector<std::vector< std::pair<int,Box> > >& isects,
+                         bool                                        first_only,
+                         const IntVect&                              ng) const
+{
+    BL_PROFILE("BoxArray::intersections(batch)");
+
+    const int N = bxs.size();
+    isects.resize(N);
+
+    // Build the search structure before going parallel.
+    if (use_bvh) {
+        getBoxTree();
+    } else {
+        getHashMap();
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,64) if (!omp_in_parallel())
+#endif
+    for (int i = 0; i < N; ++i) {
+        intersections(bxs[i], isects[i], first_only, ng);
+    }
+}
+
+Box
+BoxArray::searchBox (const Box& bx, const IntVect& ng) const noexcept
+{
+    Box gbx = amrex::grow(bx,ng);
+
+    IntVect glo = gbx.smallEnd();
+    IntVect ghi = gbx.bigEnd();
+    const IntVect& doilo = getDoiLo();
+    const IntVect& doihi = getDoiHi();
+
+    // The boxes in m_abox are cell-centered.  A cell-centered box with the
+    // same corners is at least as large as gbx after refinement.  Grow by
+    // one more cell to be safe.
+    Box cbx(glo - doihi, ghi + doilo);
+    cbx.refine(crseRatio());
+    cbx.grow(1);
+    return cbx;
+}
+
 void
 BoxArray::intersections (const Box&                         bx,
                          std::vector< std::pair<int,Box> >& isects,
@@ -1159,6 +1212,47 @@ BoxArray::intersections (const Box&                         bx,
 {
   // This is called too many times BL_PROFILE("BoxArray::intersections()");
 
+    if (use_bvh)
+    {
+        const BoxTree& tree = getBoxTree();
+
+        isects.resize(0);
+
+        BL_ASSERT(bx.ixType() == ixType());
+
+        const auto& abox = m_ref->m_abox;
+        const bool is_null = m_bat.is_null();
+        const bool is_simple = m_bat.is_simple();
+        const IndexType t = ixType();
+        const IntVect cr = crseRatio();
+
+        tree.query(searchBox(bx,ng), [&] (int index) -> bool
+        {
+            const Box& ibox = is_null ? abox[index]
+                : (is_simple ? amrex::convert(amrex::coarsen(abox[index],cr),t)
+                             : m_bat.m_op.m_bndryReg(abox[index]));
+            const Box& isect = bx & amrex::grow(ibox,ng);
+
+            if (isect.ok())
+            {
+                isects.push_back(std::pair<int,Box>(index,isect));
+                return first_only;
+            }
+            return false;
+        });
+    }
+    else
+    {
+        intersections_hash(bx, isects, first_only, ng);
+    }
+}
+
+void
+BoxArray::intersections_hash (const Box&                         bx,
+                              std::vector< std::pair<int,Box> >& isects,
+                              bool                               first_only,
+                              const IntVect&                     ng) const
+{
     BARef::HashType& BoxHashMap = getHashMap();
 
     isects.resize(0);
@@ -1254,7 +1348,42 @@ BoxArray::complementIn (BoxList& bl, const Box& bx) const
     bl.set(bx.ixType());
     bl.push_back(bx);
 
-    if (!empty()) 
+    if (!empty() && use_bvh)
+    {
+        const BoxTree& tree = getBoxTree();
+
+        BL_ASSERT(bx.ixType() == ixType());
+
+        BoxList newbl(bl.ixType());
+        newbl.reserve(bl.capacity());
+        BoxList newdiff(bl.ixType());
+
+        const auto& abox = m_ref->m_abox;
+        const bool is_null = m_bat.is_null();
+        const bool is_simple = m_bat.is_simple();
+        const IndexType t = ixType();
+        const IntVect cr = crseRatio();
+
+        tree.query(searchBox(bx,IntVect::TheZeroVector()), [&] (int index) -> bool
+        {
+            const Box& ibox = is_null ? abox[index]
+                : (is_simple ? amrex::convert(amrex::coarsen(abox[index],cr),t)
+                             : m_bat.m_op.m_bndryReg(abox[index]));
+            const Box& isect = bx & ibox;
+
+            if (isect.ok())
+            {
+                newbl.clear();
+                for (const Box& b : bl) {
+                    amrex::boxDiff(newdiff, b, isect);
+                    newbl.join(newdiff);
+                }
+                bl.swap(newbl);
+            }
+            return bl.isEmpty();
+        });
+    }
+    else if (!empty())
     {
 	BARef::HashType& BoxHashMap = getHashMap();
 
@@ -1353,13 +1482,15 @@ BoxArray::complementIn (BoxList& bl, const Box& bx) const
 void
 BoxArray::clear_hash_bin () const
 {
-    if (!m_ref->hash.empty())
+    if (!m_ref->hash.empty() || !m_ref->tree.empty())
     {
 #ifdef AMREX_MEM_PROFILING
 	m_ref->updateMemoryUsage_hash(-1);
 #endif
         m_ref->hash.clear();
         m_ref->has_hashmap = false;
+        m_ref->tree.clear();
+        m_ref->has_tree = false;
     }
 }
 
@@ -1399,7 +1530,9 @@ BoxArray::removeOverlap (bool simplify)
     {
         if (m_ref->m_abox[i].ok())
         {
-            intersections(m_ref->m_abox[i],isects);
+            // The hash is updated below as boxes are added, so it has to
+            // be used even if use_bvh is true.
+            intersections_hash(m_ref->m_abox[i],isects,false,IntVect::TheZeroVector());
 
             for (int j = 0, N = isects.size(); j < N; j++)
             {
@@ -1527,6 +1660,40 @@ BoxArray::getHashMap () const
     return BoxHashMap;
 }
 
+const BoxTree&
+BoxArray::getBoxTree () const
+{
+    BoxTree& tree = m_ref->tree;
+
+    if (m_ref->HasBoxTree()) return tree;
+
+#ifdef _OPENMP
+#pragma omp critical(intersections_lock)
+#endif
+    {
+        if (!m_ref->has_tree)
+        {
+            BL_PROFILE("BoxArray::getBoxTree()");
+
+#ifdef AMREX_MEM_PROFILING
+            m_ref->updateMemoryUsage_hash(-1);
+#endif
+            tree.define(m_ref->m_abox);
+#ifdef AMREX_MEM_PROFILING
+            m_ref->updateMemoryUsage_hash(1);
+#endif
+
+#ifdef _OPENMP
+#pragma omp flush
+#pragma omp atomic write
+#endif
+            m_ref->has_tree = true;
+        }
+    }
+
+    return tree;
+}
+
 void
 BoxArray::uniqify ()
 {
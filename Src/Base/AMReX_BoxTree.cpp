@@ -0,0 +1,92 @@
+
+#include <AMReX_BoxTree.H>
+#include <AMReX_BLProfiler.H>
+
+#include <algorithm>
+
+namespace amrex {
+
+void
+BoxTree::define (const Vector<Box>& boxes)
+{
+    BL_PROFILE("BoxTree::define()");
+
+    clear();
+
+    m_index.reserve(boxes.size());
+    for (int i = 0, N = boxes.size(); i < N; ++i) {
+        if (boxes[i].ok()) m_index.push_back(i);
+    }
+
+    const int nboxes = m_index.size();
+    if (nboxes == 0) return;
+
+    m_nodes.reserve(2*(nboxes/leaf_size+1));
+    build(boxes, 0, nboxes);
+
+    // Store the leaf boxes contiguously in tree order.
+    m_lo.resize(nboxes);
+    m_hi.resize(nboxes);
+    for (int k = 0; k < nboxes; ++k) {
+        m_lo[k] = boxes[m_index[k]].smallEnd();
+        m_hi[k] = boxes[m_index[k]].bigEnd();
+    }
+}
+
+int
+BoxTree::build (const Vector<Box>& boxes, int begin, int end)
+{
+    const int inode = m_nodes.size();
+    m_nodes.push_back(Node{});
+
+    IntVect lo = boxes[m_index[begin]].smallEnd();
+    IntVect hi = boxes[m_index[begin]].bigEnd();
+    IntVect clo = lo + hi;  // bounds of the centers, times 2
+    IntVect chi = clo;
+    for (int k = begin+1; k < end; ++k) {
+        const Box& b = boxes[m_index[k]];
+        lo.min(b.smallEnd());
+        hi.max(b.bigEnd());
+        const IntVect c = b.smallEnd() + b.bigEnd();
+        clo.min(c);
+        chi.max(c);
+    }
+
+    if (end - begin <= leaf_size || clo == chi)
+    {
+        m_nodes[inode] = Node{lo, hi, begin, end-begin};
+    }
+    else
+    {
+        const int dir = (chi-clo).maxDir(false);
+        const int mid = (begin+end)/2;
+        std::nth_element(m_index.begin()+begin, m_index.begin()+mid, m_index.begin()+end,
+                         [&boxes,dir] (int a, int b) {
+                             return boxes[a].smallEnd(dir) + boxes[a].bigEnd(dir)
+                                 <  boxes[b].smallEnd(dir) + boxes[b].bigEnd(dir);
+                         });
+        build(boxes, begin, mid);
+        const int right = build(boxes, mid, end);
+        m_nodes[inode] = Node{lo, hi, right, 0};
+    }
+
+    return inode;
+}
+
+void
+BoxTree::clear ()
+{
+    m_nodes.clear();
+    m_index.clear();
+    m_lo.clear();
+    m_hi.clear();
+}
+
+Long
+BoxTree::bytes () const noexcept
+{
+    return m_nodes.capacity()*sizeof(Node) + m_index.capacity()*sizeof(int)
+        + (m_lo.capacity() + m_hi.capacity())*sizeof(IntVect);
+}
+
+}
@@ -1,6 +1,7 @@
 
 #include <utility>
 #include <cstring>
+#include <algorithm>
 
 #include <AMReX_CArena.H>
 #include <AMReX_BLassert.H>
@@ -21,6 +22,12 @@ CArena::CArena (std::size_t hunk_size, ArenaInfo info)
 
     BL_ASSERT(m_hunk >= hunk_size);
     BL_ASSERT(m_hunk%Arena::align_size == 0);
+
+    m_use_size_classes = info.use_size_classes;
+    if (m_use_size_classes) {
+        const int nclasses = numSizeClasses();
+        m_class_bins.resize(nclasses);
+    }
 }
 
 CArena::~CArena ()
@@ -30,12 +37,95 @@ CArena::~CArena ()
     }
 }
 
+int
+CArena::numSizeClasses () noexcept
+{
+    int nclasses = 1;
+    for (std::size_t b = MinSizeClassBytes; b < MaxSizeClassBytes; b *= 2) {
+        nclasses += SizeClassesPerDoubling;
+    }
+    return nclasses;
+}
+
+int
+CArena::sizeClass (std::size_t nbytes, std::size_t& csize) noexcept
+{
+    if (nbytes <= MinSizeClassBytes) {
+        csize = MinSizeClassBytes;
+        return 0;
+    } else if (nbytes > MaxSizeClassBytes) {
+        csize = nbytes;
+        return -1;
+    }
+    //
+    // Find the power of two with lo < nbytes <= 2*lo, and split [lo,2*lo]
+    // into SizeClassesPerDoubling equal steps.
+    //
+    int ipow = 0;
+    std::size_t lo = MinSizeClassBytes;
+    while (2*lo < nbytes) {
+        lo *= 2;
+        ++ipow;
+    }
+    const std::size_t step = lo / SizeClassesPerDoubling;
+    const std::size_t k = (nbytes - lo + step - 1) / step;
+    csize = lo + k*step;
+    return 1 + ipow*SizeClassesPerDoubling + static_cast<int>(k) - 1;
+}
+
 void*
 CArena::alloc (std::size_t nbytes)
 {
+    nbytes = Arena::align(nbytes == 0 ? 1 : nbytes);
+
+    if (!m_use_size_classes)
+    {
+        std::lock_guard<std::mutex> lock(carena_mutex);
+        void* owner;
+        void* vp = alloc_firstfit(nbytes, owner);
+        m_busylist.insert(Node(vp, owner, nbytes));
+        m_actually_used += nbytes;
+        return vp;
+    }
+
+    std::size_t csize;
+    const int ic = sizeClass(nbytes, csize);
+
     std::lock_guard<std::mutex> lock(carena_mutex);
 
-    nbytes = Arena::align(nbytes == 0 ? 1 : nbytes);
+    Node cached(nullptr, nullptr, 0);
+    if (ic < 0) {
+        ++m_class_bypass;
+    } else {
+        m_class_requested += static_cast<double>(nbytes);
+        m_class_rounded += static_cast<double>(csize);
+        if (!m_class_bins[ic].empty()) {
+            cached = m_class_bins[ic].back();
+            m_class_bins[ic].pop_back();
+        }
+    }
+
+    void* vp;
+    if (cached.block() != nullptr) {
+        ++m_class_hits;
+        m_cached_bytes -= csize;
+        vp = cached.block();
+        m_busylist.insert(cached);
+    } else {
+        if (ic >= 0) ++m_class_misses;
+        void* owner;
+        vp = alloc_firstfit(csize, owner);
+        m_busylist.insert(Node(vp, owner, csize));
+    }
+
+    m_actually_used += csize;
+
+    return vp;
+}
+
+void*
+CArena::alloc_firstfit (std::size_t nbytes, void*& owner)
+{
     //
     // Find node in freelist at lowest memory address that'll satisfy request.
     //
@@ -47,6 +137,19 @@ CArena::alloc (std::size_t nbytes)
         }
     }
 
+    if (free_it == m_freelist.end() && flush_class_bins())
+    {
+        //
+        // Blocks parked in the size-class bins might coalesce into a fit
+        // before we go to the system for more memory.
+        //
+        for (free_it = m_freelist.begin(); free_it != m_freelist.end(); ++free_it) {
+            if ((*free_it).size() >= nbytes) {
+                break;
+            }
+        }
+    }
+
     void* vp = 0;
 
     if (free_it == m_freelist.end())
@@ -71,7 +174,7 @@ CArena::alloc (std::size_t nbytes)
             m_freelist.insert(m_freelist.end(), Node(block, vp, m_hunk-nbytes));
         }
 
-        m_busylist.insert(Node(vp, vp, nbytes));
+        owner = vp;
     }
     else
     {
@@ -79,7 +182,7 @@ CArena::alloc (std::size_t nbytes)
         BL_ASSERT(m_busylist.find(*free_it) == m_busylist.end());
 
         vp = (*free_it).block();
-        m_busylist.insert(Node(vp, free_it->owner(), nbytes));
+        owner = free_it->owner();
 
         if ((*free_it).size() > nbytes)
         {
@@ -100,8 +203,6 @@ CArena::alloc (std::size_t nbytes)
         m_freelist.erase(free_it);
     }
 
-    m_actually_used += nbytes;
-
     BL_ASSERT(!(vp == 0));
 
     return vp;
@@ -127,22 +228,38 @@ CArena::free (void* vp)
     }
     BL_ASSERT(m_freelist.find(*busy_it) == m_freelist.end());
 
-    m_actually_used -= busy_it->size();
+    const Node node = *busy_it;
+    m_busylist.erase(busy_it);
+
+    m_actually_used -= node.size();
 
+    std::size_t csize;
+    const int ic = m_use_size_classes ? sizeClass(node.size(), csize) : -1;
+    if (ic >= 0)
+    {
+        BL_ASSERT(csize == node.size());
+        m_cached_bytes += csize;
+        m_class_bins[ic].push_back(node);
+    }
+    else
+    {
+        free_coalesce(node);
+    }
+}
+
+void
+CArena::free_coalesce (const Node& node)
+{
     //
     // Put free'd block on free list and save iterator to insert()ed position.
     //
-    std::pair<NL::iterator,bool> pair_it = m_freelist.insert(*busy_it);
+    std::pair<NL::iterator,bool> pair_it = m_freelist.insert(node);
 
     BL_ASSERT(pair_it.second == true);
 
     NL::iterator free_it = pair_it.first;
 
-    BL_ASSERT(free_it != m_freelist.end() && (*free_it).block() == (*busy_it).block());
-    //
-    // And remove from busy list.
-    //
-    m_busylist.erase(busy_it);
+    BL_ASSERT(free_it != m_freelist.end() && (*free_it).block() == node.block());
     //
     // Coalesce freeblock(s) on lo and hi side of this block.
     //
@@ -218,6 +335,47 @@ CArena::sizeOf (void* p) const noexcept
     }
 }
 
+CArena::SizeClassStats
+CArena::sizeClassStats () const
+{
+    std::lock_guard<std::mutex> lock(carena_mutex);
+
+    SizeClassStats r;
+    r.hits = m_class_hits;
+    r.misses = m_class_misses;
+    r.bypass = m_class_bypass;
+    r.cached_bytes = m_cached_bytes;
+    r.requested_bytes = m_class_requested;
+    r.rounded_bytes = m_class_rounded;
+    for (auto const& node : m_freelist) {
+        r.free_bytes += node.size();
+        r.largest_free = std::max(r.largest_free, node.size());
+    }
+    return r;
+}
+
+void
+CArena::releaseCachedBlocks ()
+{
+    std::lock_guard<std::mutex> lock(carena_mutex);
+    flush_class_bins();
+}
+
+bool
+CArena::flush_class_bins ()
+{
+    bool flushed = false;
+    for (auto& bin : m_class_bins) {
+        for (auto const& node : bin) {
+            m_cached_bytes -= node.size();
+            free_coalesce(node);
+            flushed = true;
+        }
+        bin.clear();
+    }
+    return flushed;
+}
+
 void
 CArena::PrintUsage (std::string const& name) const
 {
@@ -239,6 +397,22 @@ CArena::PrintUsage (std::string const& name) const
     amrex::Print() << "[" << name << "]" << " space allocated (MB): " << min_megabytes << "\n";
     amrex::Print() << "[" << name << "]" << " space used      (MB): " << actual_min_megabytes << "\n";
 #endif
+
+    if (m_use_size_classes)
+    {
+        const SizeClassStats st = sizeClassStats();
+        Real hit_rate = st.hitRate();
+        Real frag = st.fragmentation();
+        Real waste = st.roundingWaste();
+        Long cached_megabytes = st.cached_bytes / (1024*1024);
+        ParallelReduce::Min<Real>(hit_rate, IOProc, ParallelDescriptor::Communicator());
+        ParallelReduce::Max<Real>({frag, waste}, IOProc, ParallelDescriptor::Communicator());
+        ParallelReduce::Max<Long>(cached_megabytes, IOProc, ParallelDescriptor::Communicator());
+        amrex::Print() << "[" << name << "]" << " size classes: min hit rate " << hit_rate
+                       << ", max fragmentation " << frag
+                       << ", max rounding waste " << waste
+                       << ", max cached (MB) " << cached_megabytes << "\n";
+    }
 }
 
 }
@@ -0,0 +1,431 @@
+
+#include <AMReX_Compression.H>
+#include <AMReX_FPC.H>
+#include <AMReX.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace amrex {
+namespace Compression {
+
+namespace {
+
+constexpr int  LZ_MinMatch   = 4;
+constexpr int  LZ_LastLits   = 5;    // ---- the last 5 bytes are always literals
+constexpr int  LZ_MFLimit    = 12;   // ---- no match starts in the last 12 bytes
+constexpr Long LZ_MaxOffset  = 65535;
+constexpr int  LZ_HashLog    = 16;
+
+// ---- per-thread buffers, so that the hash table and the byte buffers are
+// ---- not allocated again for every block
+struct Scratch
+{
+    Vector<Long> table;   // ---- entries below base are from earlier calls
+    Long base = 0;
+    Vector<char> bytes;
+    Vector<std::uint32_t> codes;
+};
+
+Scratch& scratch ()
+{
+    thread_local Scratch s;
+    return s;
+}
+
+inline std::uint32_t read32 (const unsigned char* p) noexcept
+{
+    std::uint32_t r;
+    std::memcpy(&r, p, 4);
+    return r;
+}
+
+inline std::uint32_t lzHash (std::uint32_t seq) noexcept
+{
+    return (seq * 2654435761U) >> (32 - LZ_HashLog);
+}
+
+inline unsigned char* writeLength (unsigned char* op, Long len) noexcept
+{
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = static_cast<unsigned char>(len);
+    return op;
+}
+
+inline unsigned char* writeLiterals (unsigned char* op, unsigned char* token,
+                                     const unsigned char* lits, Long nlits) noexcept
+{
+    if (nlits >= 15) {
+        *token = 15 << 4;
+        op = writeLength(op, nlits - 15);
+    } else {
+        *token = static_cast<unsigned char>(nlits << 4);
+    }
+    std::memcpy(op, lits, nlits);
+    return op + nlits;
+}
+
+// ---- the error bound is checked with a little slack so that readers
+// ---- rounding lo + q*step differently still satisfy it
+constexpr double Q_StepFactor  = 1.99;
+constexpr double Q_CheckFactor = 0.999;
+
+bool quantize (const Real* data, Long n, Real tol, double& lo, double& step,
+               Vector<std::uint32_t>& codes)
+{
+    if (!(tol > 0.0) || n == 0) {
+        return false;
+    }
+    double hi = data[0];
+    lo = data[0];
+    for (Long i = 0; i < n; ++i) {
+        const double x = data[i];
+        if (!std::isfinite(x)) {
+            return false;
+        }
+        lo = std::min(lo, x);
+        hi = std::max(hi, x);
+    }
+    step = Q_StepFactor * static_cast<double>(tol);
+    if ((hi - lo) / step >= static_cast<double>(std::numeric_limits<std::int32_t>::max() - 1)) {
+        return false;
+    }
+
+    const double bound = Q_CheckFactor * static_cast<double>(tol);
+    codes.resize(n);
+    std::uint32_t qprev = 0;
+    for (Long i = 0; i < n; ++i) {
+        const double x = data[i];
+        const auto q = static_cast<std::uint32_t>(std::floor((x - lo) / step + 0.5));
+        const double r = lo + static_cast<double>(q) * step;
+        if (!(std::abs(static_cast<double>(static_cast<Real>(r)) - x) <= bound)) {
+            return false;
+        }
+        // ---- zigzag-encoded difference to the previous value
+        const auto d = static_cast<std::int32_t>(q - qprev);
+        codes[i] = (static_cast<std::uint32_t>(d) << 1) ^ static_cast<std::uint32_t>(d >> 31);
+        qprev = q;
+    }
+    return true;
+}
+
+// ---- LZ of nbytes, appended to out
+void appendLZ (const char* bytes, Long nbytes, Vector<char>& out)
+{
+    const Long pos = out.size();
+    out.resize(pos + LZBound(nbytes));
+    const Long clen = LZCompress(bytes, nbytes, out.data() + pos);
+    out.resize(pos + clen);
+}
+
+void decodeLZ (const char* in, Long nin, char* bytes, Long nbytes)
+{
+    if (!LZDecompress(in, nin, bytes, nbytes)) {
+        amrex::Abort("Compression::DecompressBlock:  corrupt compressed data");
+    }
+}
+
+void putDouble (double x, Vector<char>& out)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(double));
+    char b[8];
+    PutInt64(static_cast<std::int64_t>(bits), b);
+    out.insert(out.end(), b, b + 8);
+}
+
+double getDouble (const char* p)
+{
+    const auto bits = static_cast<std::uint64_t>(GetInt64(p));
+    double x;
+    std::memcpy(&x, &bits, sizeof(double));
+    return x;
+}
+
+}
+
+Long
+LZBound (Long n) noexcept
+{
+    return n + n/255 + 16;
+}
+
+Long
+LZCompress (const char* a_in, Long n, char* a_out) noexcept
+{
+    const auto in = reinterpret_cast<const unsigned char*>(a_in);
+    const auto out = reinterpret_cast<unsigned char*>(a_out);
+    unsigned char* op = out;
+    Long anchor = 0;
+
+    if (n > LZ_MFLimit) {
+        // ---- the table holds base + position, so entries from earlier
+        // ---- calls give negative positions and need not be cleared
+        Scratch& s = scratch();
+        if (s.table.empty() || s.base > std::numeric_limits<Long>::max() - n) {
+            s.table.assign(1 << LZ_HashLog, -1);
+            s.base = 0;
+        }
+        Long* table = s.table.data();
+        const Long base = s.base;
+        s.base += n;
+        const Long mflimit = n - LZ_MFLimit;
+        const Long matchlimit = n - LZ_LastLits;
+        Long ip = 0;
+        int misses = 0;
+        while (ip < mflimit) {
+            const std::uint32_t seq = read32(in + ip);
+            const std::uint32_t h = lzHash(seq);
+            const Long ref = table[h] - base;
+            table[h] = base + ip;
+            if (ref < 0 || ip - ref > LZ_MaxOffset || read32(in + ref) != seq) {
+                // ---- skip faster through data that do not compress
+                ip += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+
+            // ---- extend the match backwards and forwards
+            Long start = ip, mref = ref;
+            while (start > anchor && mref > 0 && in[start-1] == in[mref-1]) {
+                --start;
+                --mref;
+            }
+            Long len = ip - start + LZ_MinMatch;
+            while (start + len < matchlimit && in[mref+len] == in[start+len]) {
+                ++len;
+            }
+
+            unsigned char* token = op++;
+            op = writeLiterals(op, token, in + anchor, start - anchor);
+            const Long offset = start - mref;
+            *op++ = static_cast<unsigned char>(offset & 0xff);
+            *op++ = static_cast<unsigned char>(offset >> 8);
+            const Long mlen = len - LZ_MinMatch;
+            if (mlen >= 15) {
+                *token |= 15;
+                op = writeLength(op, mlen - 15);
+            } else {
+                *token |= static_cast<unsigned char>(mlen);
+            }
+
+            ip = start + len;
+            anchor = ip;
+            if (ip - 2 >= 0 && ip - 2 < mflimit) {
+                table[lzHash(read32(in + ip - 2))] = base + ip - 2;
+            }
+        }
+    }
+
+    unsigned char* token = op++;
+    op = writeLiterals(op, token, in + anchor, n - anchor);
+    return op - out;
+}
+
+bool
+LZDecompress (const char* a_in, Long nin, char* a_out, Long n) noexcept
+{
+    const auto in = reinterpret_cast<const unsigned char*>(a_in);
+    const auto out = reinterpret_cast<unsigned char*>(a_out);
+    Long ip = 0, op = 0;
+
+    while (ip < nin) {
+        const unsigned token = in[ip++];
+        Long nlits = token >> 4;
+        if (nlits == 15) {
+            unsigned b;
+            do {
+                if (ip >= nin) return false;
+                b = in[ip++];
+                nlits += b;
+            } while (b == 255);
+        }
+        if (nlits > nin - ip || nlits > n - op) return false;
+        std::memcpy(out + op, in + ip, nlits);
+        ip += nlits;
+        op += nlits;
+        if (ip == nin) break;  // ---- the last sequence has no match
+
+        if (nin - ip < 2) return false;
+        const Long offset = in[ip] | (Long(in[ip+1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return false;
+        Long mlen = token & 15;
+        if (mlen == 15) {
+            unsigned b;
+            do {
+                if (ip >= nin) return false;
+                b = in[ip++];
+                mlen += b;
+            } while (b == 255);
+        }
+        mlen += LZ_MinMatch;
+        if (mlen > n - op) return false;
+        // ---- the source and destination may overlap
+        const unsigned char* src = out + op - offset;
+        unsigned char* dst = out + op;
+        for (Long i = 0; i < mlen; ++i) {
+            dst[i] = src[i];
+        }
+        op += mlen;
+    }
+
+    return op == n;
+}
+
+void
+PutInt64 (std::int64_t v, char* p) noexcept
+{
+    const auto u = static_cast<std::uint64_t>(v);
+    for (int b = 0; b < 8; ++b) {
+        p[b] = static_cast<char>((u >> (8*b)) & 0xff);
+    }
+}
+
+std::int64_t
+GetInt64 (const char* p) noexcept
+{
+    std::uint64_t u = 0;
+    for (int b = 0; b < 8; ++b) {
+        u |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[b])) << (8*b);
+    }
+    return static_cast<std::int64_t>(u);
+}
+
+void
+Shuffle (const char* in, Long nelems, int elemsize, char* out) noexcept
+{
+    for (int b = 0; b < elemsize; ++b) {
+        char* o = out + b*nelems;
+        for (Long i = 0; i < nelems; ++i) {
+            o[i] = in[i*elemsize+b];
+        }
+    }
+}
+
+void
+Unshuffle (const char* in, Long nelems, int elemsize, char* out) noexcept
+{
+    for (int b = 0; b < elemsize; ++b) {
+        const char* p = in + b*nelems;
+        for (Long i = 0; i < nelems; ++i) {
+            out[i*elemsize+b] = p[i];
+        }
+    }
+}
+
+void
+CompressBlock (const Real* data, Long n, const RealDescriptor& rd, Real tol, Vector<char>& out)
+{
+    Scratch& s = scratch();
+    double lo, step;
+    if (quantize(data, n, tol, lo, step, s.codes)) {
+        out.push_back(static_cast<char>(Quantized_LZ));
+        putDouble(lo, out);
+        putDouble(step, out);
+        // ---- the codes shuffled into byte planes, least significant first
+        s.bytes.resize(4*n);
+        for (int b = 0; b < 4; ++b) {
+            char* plane = s.bytes.data() + b*n;
+            for (Long i = 0; i < n; ++i) {
+                plane[i] = static_cast<char>((s.codes[i] >> (8*b)) & 0xff);
+            }
+        }
+        appendLZ(s.bytes.data(), 4*n, out);
+        return;
+    }
+
+    const int elemsize = rd.numBytes();
+    const Long nbytes = n * elemsize;
+    Vector<char> converted;
+    const char* bytes = reinterpret_cast<const char*>(data);
+    if (rd != FPC::NativeRealDescriptor()) {
+        converted.resize(nbytes);
+        RealDescriptor::convertFromNativeFormat(converted.data(), n, data, rd);
+        bytes = converted.data();
+    }
+
+    const Long pos = out.size();
+    out.push_back(static_cast<char>(Shuffle_LZ));
+    s.bytes.resize(nbytes);
+    Shuffle(bytes, n, elemsize, s.bytes.data());
+    appendLZ(s.bytes.data(), nbytes, out);
+    if (static_cast<Long>(out.size()) - pos > 1 + nbytes) {
+        // ---- incompressible
+        out.resize(pos);
+        out.push_back(static_cast<char>(Raw));
+        out.insert(out.end(), bytes, bytes + nbytes);
+    }
+}
+
+void
+DecompressBlock (const char* in, Long nin, Real* data, Long n, const RealDescriptor& rd)
+{
+    if (nin < 1) {
+        amrex::Abort("Compression::DecompressBlock:  empty block");
+    }
+    const auto method = static_cast<unsigned char>(in[0]);
+    ++in;
+    --nin;
+
+    Scratch& s = scratch();
+
+    if (method == Quantized_LZ) {
+        if (nin < 16) {
+            amrex::Abort("Compression::DecompressBlock:  corrupt compressed data");
+        }
+        const double lo = getDouble(in);
+        const double step = getDouble(in + 8);
+        in  += 16;
+        nin -= 16;
+        s.bytes.resize(4*n);
+        decodeLZ(in, nin, s.bytes.data(), 4*n);
+        const auto planes = reinterpret_cast<const unsigned char*>(s.bytes.data());
+        std::uint32_t q = 0;
+        for (Long i = 0; i < n; ++i) {
+            const std::uint32_t z =  static_cast<std::uint32_t>(planes[i])
+                                  | (static_cast<std::uint32_t>(planes[n+i])   <<  8)
+                                  | (static_cast<std::uint32_t>(planes[2*n+i]) << 16)
+                                  | (static_cast<std::uint32_t>(planes[3*n+i]) << 24);
+            q += (z >> 1) ^ (0U - (z & 1U));
+            data[i] = static_cast<Real>(lo + static_cast<double>(q) * step);
+        }
+        return;
+    }
+
+    const int elemsize = rd.numBytes();
+    const Long nbytes = n * elemsize;
+    const bool native = (rd == FPC::NativeRealDescriptor());
+    Vector<char> converted;
+    char* bytes = reinterpret_cast<char*>(data);
+    if (!native) {
+        converted.resize(nbytes);
+        bytes = converted.data();
+    }
+
+    if (method == Raw) {
+        if (nin != nbytes) {
+            amrex::Abort("Compression::DecompressBlock:  corrupt raw block");
+        }
+        std::memcpy(bytes, in, nbytes);
+    } else if (method == Shuffle_LZ) {
+        s.bytes.resize(nbytes);
+        decodeLZ(in, nin, s.bytes.data(), nbytes);
+        Unshuffle(s.bytes.data(), n, elemsize, bytes);
+    } else {
+        amrex::Abort("Compression::DecompressBlock:  unknown compression method");
+    }
+
+    if (!native) {
+        RealDescriptor::convertToNativeFormat(data, n, bytes, rd);
+    }
+}
+
+}
+}
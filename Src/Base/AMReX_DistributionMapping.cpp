@@ -8,6 +8,7 @@
 #include <AMReX_Geometry.H>
 #include <AMReX_VisMF.H>
 #include <AMReX_Utility.H>
+#include <AMReX_Machine.H>
 
 #include <iostream>
 #include <fstream>
@@ -24,6 +25,10 @@
 
 namespace {
 int flag_verbose_mapper;
+int partition_ngrow;
+double partition_tolerance;
+int partition_passes;
+int node_aware;
 }
 
 namespace amrex {
@@ -73,6 +78,9 @@ DistributionMapping::strategy (DistributionMapping::Strategy how)
     case RRSFC:
         m_BuildMap = &DistributionMapping::RRSFCProcessorMap;
         break;
+    case PARTITION:
+        m_BuildMap = &DistributionMapping::PartitionProcessorMap;
+        break;
     default:
         amrex::Error("Bad DistributionMapping::Strategy");
     }
@@ -90,6 +98,22 @@ DistributionMapping::SFC_Threshold ()
     return sfc_threshold;
 }
 
+void
+DistributionMapping::SFC_NodeAware (bool flag)
+{
+    node_aware = flag;
+    if (node_aware) {
+        // Gather the topology now, while all processes are here.
+        machine::rank_node_ids();
+    }
+}
+
+bool
+DistributionMapping::SFC_NodeAware ()
+{
+    return node_aware;
+}
+
 bool
 DistributionMapping::operator== (const DistributionMapping& rhs) const noexcept
 {
@@ -114,6 +138,10 @@ DistributionMapping::Initialize ()
     max_efficiency   = 0.9;
     node_size        = 0;
     flag_verbose_mapper = 0;
+    partition_ngrow     = 1;
+    partition_tolerance = 0.05;
+    partition_passes    = 8;
+    node_aware          = 0;
 
     ParmParse pp("DistributionMapping");
 
@@ -123,6 +151,10 @@ DistributionMapping::Initialize ()
     pp.query("sfc_threshold",       sfc_threshold);
     pp.query("node_size",           node_size);
     pp.query("verbose_mapper",      flag_verbose_mapper);
+    pp.query("partition_ngrow",     partition_ngrow);
+    pp.query("partition_tolerance", partition_tolerance);
+    pp.query("partition_passes",    partition_passes);
+    pp.query("node_aware",          node_aware);
 
     std::string theStrategy;
 
@@ -144,6 +176,10 @@ DistributionMapping::Initialize ()
         {
             strategy(RRSFC);
         }
+        else if (theStrategy == "PARTITION")
+        {
+            strategy(PARTITION);
+        }
         else
         {
             std::string msg("Unknown strategy: ");
@@ -876,6 +912,118 @@ DistributionMapping::KnapSackProcessorMap (const BoxArray& boxes,
     }
 }
 
+namespace {
+
+    // Graph of the boxes in a BoxArray.  For each pair of boxes within ngrow
+    // cells of each other there are two entries, (j,w_ij) in graph[i] and
+    // (i,w_ji) in graph[j], where w_ij is the number of ghost cells of box i
+    // that are valid cells of box j.  w_ij and w_ji differ only if one of the
+    // boxes is thinner than ngrow.
+    using BoxGraph = std::vector<std::vector<std::pair<int,Long> > >;
+
+    BoxGraph
+    BuildBoxGraph (const BoxArray& boxes, int ngrow)
+    {
+        BL_PROFILE("DistributionMapping::BuildBoxGraph()");
+
+        const int N = boxes.size();
+        BoxGraph graph(N);
+        std::vector< std::pair<int,Box> > isects;
+        for (int i = 0; i < N; ++i)
+        {
+            boxes.intersections(amrex::grow(boxes[i],ngrow), isects);
+            for (const auto& is : isects)
+            {
+                const int j = is.first;
+                if (j != i) {
+                    const Long w = is.second.numPts();
+                    graph[i].push_back(std::make_pair(j,w));
+                }
+            }
+        }
+        return graph;
+    }
+
+    // Returns the total number of ghost cells filled from other parts, and
+    // optionally the total number of ghost cells filled from any box.
+    Long
+    EdgeCut (const BoxGraph& graph, const Vector<int>& part, Long* total = nullptr)
+    {
+        Long cut = 0, tot = 0;
+        for (int i = 0, N = graph.size(); i < N; ++i)
+        {
+            for (const auto& e : graph[i])
+            {
+                if (part[e.first] != part[i]) cut += e.second;
+                tot += e.second;
+            }
+        }
+        if (total) *total = tot;
+        return cut;
+    }
+
+    // Greedy boundary refinement: move boxes to the neighboring part they are
+    // most connected to, as long as that reduces the edge cut (or keeps it
+    // and improves the balance) and the destination stays below the limit.
+    int
+    RefinePartition (const BoxGraph& graph, const std::vector<Long>& wgts,
+                     const std::vector<int>& order, Long limit, int npasses,
+                     Vector<int>& part, Vector<Long>& pw, Vector<int>& pn)
+    {
+        BL_PROFILE("DistributionMapping::RefinePartition()");
+
+        Vector<Long> conn(pw.size(), 0);
+        Vector<int> touched;
+        int ntotmoves = 0;
+
+        for (int pass = 0; pass < npasses; ++pass)
+        {
+            int nmoves = 0;
+            for (int i : order)
+            {
+                const int src = part[i];
+                if (pn[src] <= 1) continue;  // Do not leave a process without boxes.
+
+                touched.clear();
+                for (const auto& e : graph[i]) {
+                    const int q = part[e.first];
+                    if (conn[q] == 0) touched.push_back(q);
+                    conn[q] += e.second;
+                }
+
+                const Long w = wgts[i];
+                int best = -1;
+                Long best_gain = 0;
+                for (int q : touched)
+                {
+                    if (q == src || pw[q] + w > limit) continue;
+                    const Long gain = conn[q] - conn[src];
+                    if (gain < 0 || (gain == 0 && pw[q] + w >= pw[src])) continue;
+                    if (best < 0 || gain > best_gain ||
+                        (gain == best_gain && pw[q] < pw[best]))
+                    {
+                        best = q;
+                        best_gain = gain;
+                    }
+                }
+
+                for (int q : touched) conn[q] = 0;
+                conn[src] = 0;
+
+                if (best >= 0) {
+                    part[i] = best;
+                    pw[src] -= w;   --pn[src];
+                    pw[best] += w;  ++pn[best];
+                    ++nmoves;
+                }
+            }
+            ntotmoves += nmoves;
+            if (nmoves == 0) break;
+        }
+        return ntotmoves;
+    }
+}
+
 namespace
 {
     struct SFCToken
@@ -1012,6 +1160,196 @@ Distribute (const std::vector<SFCToken>&     tokens,
 #endif
 }
 
+namespace {
+
+    // Split tokens[kbeg,kend) into consecutive chunks, one per group, with
+    // volumes proportional to the capacities of the groups.  kstart[g] is
+    // the first token of group g.
+    void
+    DistributeProportional (const std::vector<SFCToken>& tokens, int kbeg, int kend,
+                            const std::vector<int>& cap, std::vector<int>& kstart)
+    {
+        const int ngroups = cap.size();
+        Real totvol = 0;
+        for (int k = kbeg; k < kend; ++k) {
+            totvol += tokens[k].m_vol;
+        }
+        const int totcap = std::accumulate(cap.begin(), cap.end(), 0);
+
+        kstart.resize(ngroups+1);
+        kstart[0] = kbeg;
+        Real cumvol = 0;
+        int  cumcap = 0;
+        int  K = kbeg;
+        for (int g = 0; g < ngroups-1; ++g)
+        {
+            cumcap += cap[g];
+            const Real target = totvol*cumcap/totcap;
+            while (K < kend && cumvol + Real(0.5)*tokens[K].m_vol <= target) {
+                cumvol += tokens[K].m_vol;
+                ++K;
+            }
+            kstart[g+1] = K;
+        }
+        kstart[ngroups] = kend;
+    }
+
+    // keys are (node, NUMA domain, rank) sorted lexicographically.  The
+    // tokens are first split among nodes, then among the NUMA domains of
+    // each node and finally among the ranks of each NUMA domain, so that
+    // boxes close on the space filling curve stay on the same node.
+    void
+    DistributeHierarchical (const std::vector<SFCToken>& tokens, int kbeg, int kend,
+                            const std::vector<std::array<int,3> >& keys, int rbeg, int rend,
+                            int level, std::vector< std::vector<int> >& v)
+    {
+        std::vector<int> rstart(1, rbeg);
+        for (int r = rbeg+1; r < rend; ++r) {
+            if (level == 2 || keys[r][level] != keys[r-1][level]) {
+                rstart.push_back(r);
+            }
+        }
+        rstart.push_back(rend);
+
+        const int ngroups = rstart.size()-1;
+        std::vector<int> cap(ngroups);
+        for (int g = 0; g < ngroups; ++g) {
+            cap[g] = rstart[g+1] - rstart[g];
+        }
+
+        std::vector<int> kstart;
+        DistributeProportional(tokens, kbeg, kend, cap, kstart);
+
+        for (int g = 0; g < ngroups; ++g)
+        {
+            if (level == 2) {
+                std::vector<int>& vi = v[keys[rstart[g]][2]];
+                for (int k = kstart[g]; k < kstart[g+1]; ++k) {
+                    vi.push_back(tokens[k].m_box);
+                }
+            } else {
+                DistributeHierarchical(tokens, kstart[g], kstart[g+1],
+                                       keys, rstart[g], rstart[g+1], level+1, v);
+            }
+        }
+    }
+
+    // SFC distribution that keeps neighboring boxes on the same node.
+    void
+    SFCHierarchicalDoIt (const BoxArray&              boxes,
+                         const std::vector<Long>&     wgts,
+                         const std::vector<SFCToken>& tokens,
+                         const Vector<int>*           least_used,
+                         Vector<int>&                 pmap,
+                         Real*                        eff)
+    {
+        BL_PROFILE("DistributionMapping::SFCHierarchicalDoIt()");
+
+        const int nprocs = ParallelContext::NProcsSub();
+        const int N = tokens.size();
+
+        const Vector<int>& node_ids = machine::rank_node_ids();
+        const Vector<int>& numa_ids = machine::rank_numa_ids();
+
+        std::vector<std::array<int,3> > keys(nprocs);
+        for (int i = 0; i < nprocs; ++i) {
+            const int grank = ParallelContext::local_to_global_rank(i);
+            keys[i] = {{node_ids[grank], numa_ids[grank], i}};
+        }
+        std::sort(keys.begin(), keys.end());
+
+        std::vector< std::vector<int> > vec(nprocs);
+        DistributeHierarchical(tokens, 0, N, keys, 0, nprocs, 0, vec);
+
+        if (least_used)
+        {
+            // As in the flat SFC distribution, give the heaviest buckets to
+            // the least used processes, but only among the processes of the
+            // same NUMA domain, to keep the placement on nodes.
+            Vector<int> usage_order(nprocs);
+            for (int i = 0; i < nprocs; ++i) {
+                usage_order[(*least_used)[i]] = i;
+            }
+            std::vector< std::vector<int> > sorted(nprocs);
+            for (int g0 = 0, g1 = 0; g0 < nprocs; g0 = g1)
+            {
+                g1 = g0+1;
+                while (g1 < nprocs && keys[g1][0] == keys[g0][0] && keys[g1][1] == keys[g0][1]) {
+                    ++g1;
+                }
+                std::vector<std::pair<Long,int> > buckets;
+                std::vector<int> ranks;
+                for (int k = g0; k < g1; ++k) {
+                    const int i = keys[k][2];
+                    Long w = 0;
+                    for (int ibox : vec[i]) {
+                        w += wgts[ibox];
+                    }
+                    buckets.push_back(std::make_pair(w,i));
+                    ranks.push_back(i);
+                }
+                std::stable_sort(buckets.begin(), buckets.end(),
+                                 [] (const std::pair<Long,int>& a, const std::pair<Long,int>& b)
+                                 { return a.first > b.first; });
+                std::sort(ranks.begin(), ranks.end(),
+                          [&] (int a, int b) { return usage_order[a] < usage_order[b]; });
+                for (int k = 0; k < g1-g0; ++k) {
+                    sorted[ranks[k]] = std::move(vec[buckets[k].second]);
+                }
+            }
+            vec.swap(sorted);
+        }
+
+        Vector<Long> rank_wgt(nprocs, 0);
+        for (int i = 0; i < nprocs; ++i)
+        {
+            const int grank = ParallelContext::local_to_global_rank(i);
+            for (int ibox : vec[i]) {
+                pmap[ibox] = grank;
+                rank_wgt[i] += wgts[ibox];
+            }
+        }
+
+        if (eff || verbose)
+        {
+            Real sum_wgt = 0, max_wgt = 0;
+            for (int i = 0; i < nprocs; ++i)
+            {
+                const Long W = rank_wgt[i];
+                if (W > max_wgt) max_wgt = W;
+                sum_wgt += W;
+            }
+            Real efficiency = (sum_wgt/(nprocs*max_wgt));
+            if (eff) *eff = efficiency;
+
+            if (verbose)
+            {
+                // Compare with the flat SFC distribution with bucket i on rank i.
+                std::vector< std::vector<int> > flat(nprocs);
+                Distribute(tokens, nprocs, sum_wgt/nprocs, flat);
+
+                Vector<int> node_part(N), flat_node_part(N);
+                for (int i = 0; i < N; ++i) {
+                    node_part[i] = node_ids[pmap[i]];
+                }
+                for (int i = 0; i < nprocs; ++i) {
+                    const int grank = ParallelContext::local_to_global_rank(i);
+                    for (int ibox : flat[i]) {
+                        flat_node_part[ibox] = node_ids[grank];
+                    }
+                }
+
+                const BoxGraph graph = BuildBoxGraph(boxes, 1);
+                const Long cut = EdgeCut(graph, node_part);
+                const Long flat_cut = EdgeCut(graph, flat_node_part);
+                amrex::Print() << "SFC efficiency: " << efficiency
+                               << ", inter-node ghost cells: " << cut
+                               << " (" << flat_cut << " without node awareness)\n";
+            }
+        }
+    }
+}
+
 void
 DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
                                           const std::vector<Long>& wgts,
@@ -1079,6 +1417,16 @@ DistributionMapping::SFCProcessorMapDoIt (const BoxArray&          boxes,
     // Put'm in Morton space filling curve order.
     //
     std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+
+    if (node_aware && nteams == nprocs)
+    {
+        Vector<int> ord;
+        if (sort) {
+            LeastUsedCPUs(nprocs,ord);
+        }
+        SFCHierarchicalDoIt(boxes, wgts, tokens, sort ? &ord : nullptr, m_ref->m_pmap, eff);
+        return;
+    }
     //
     // Split'm up as equitably as possible per team.
     //
@@ -1366,6 +1714,213 @@ DistributionMapping::RRSFCProcessorMap (const BoxArray&          boxes,
     RRSFCDoIt(boxes,nprocs);
 }
 
+void
+DistributionMapping::PartitionDoIt (const BoxArray&          boxes,
+                                    const std::vector<Long>& wgts,
+                                    int                   /*   nprocs */,
+                                    bool                     sort,
+                                    Real*                    eff)
+{
+    if (flag_verbose_mapper) {
+        Print() << "DM: PartitionDoIt called..." << std::endl;
+    }
+
+    BL_PROFILE("DistributionMapping::PartitionDoIt()");
+
+#if defined (BL_USE_TEAM)
+    amrex::Abort("Team support is not implemented yet in PARTITION");
+#endif
+
+    const int nprocs = ParallelContext::NProcsSub();
+    const int N = boxes.size();
+
+    //
+    // Start from the SFC partition.
+    //
+    std::vector<SFCToken> tokens;
+    tokens.reserve(N);
+    int maxijk = 0;
+    for (int i = 0; i < N; ++i)
+    {
+	const Box& bx = boxes[i];
+        tokens.push_back(SFCToken(i,bx.smallEnd(),wgts[i]));
+
+        const SFCToken& token = tokens.back();
+
+        AMREX_D_TERM(maxijk = std::max(maxijk, token.m_idx[0]);,
+                     maxijk = std::max(maxijk, token.m_idx[1]);,
+                     maxijk = std::max(maxijk, token.m_idx[2]););
+    }
+    int m = 0;
+    for ( ; (1 << m) <= maxijk; ++m) {
+        ;  // do nothing
+    }
+    SFCToken::MaxPower = m;
+    std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+
+    Real totvol = 0;
+    for (const SFCToken& tok : tokens) {
+        totvol += tok.m_vol;
+    }
+    const Real volperproc = totvol / nprocs;
+
+    std::vector< std::vector<int> > vec(nprocs);
+    Distribute(tokens,nprocs,volperproc,vec);
+
+    std::vector<int> order;
+    order.reserve(N);
+    for (const SFCToken& tok : tokens) {
+        order.push_back(tok.m_box);
+    }
+    tokens.clear();
+
+    Vector<int> part(N);
+    Vector<Long> pw(nprocs, 0);
+    Vector<int> pn(nprocs, 0);
+    for (int p = 0; p < nprocs; ++p) {
+        for (int i : vec[p]) {
+            part[i] = p;
+            pw[p] += wgts[i];
+            ++pn[p];
+        }
+    }
+
+    //
+    // Refine it on the graph of neighboring boxes.
+    //
+    const BoxGraph graph = BuildBoxGraph(boxes, partition_ngrow);
+
+    const Long sfc_max = *std::max_element(pw.begin(), pw.end());
+    const Long limit = std::max(sfc_max,
+                                static_cast<Long>((1.0+partition_tolerance)*volperproc));
+
+    Long total_edges = 0;
+    const Long sfc_cut = (verbose) ? EdgeCut(graph, part, &total_edges) : 0;
+
+    const int nmoves = RefinePartition(graph, wgts, order, limit, partition_passes,
+                                       part, pw, pn);
+
+    for (auto& v : vec) v.clear();
+    for (int i : order) {
+        vec[part[i]].push_back(i);
+    }
+
+    std::vector<LIpair> LIpairV;
+    LIpairV.reserve(nprocs);
+    for (int i = 0; i < nprocs; ++i) {
+        LIpairV.push_back(LIpair(pw[i],i));
+    }
+
+    if (sort) Sort(LIpairV, true);
+
+    Vector<int> ord;
+    if (sort) {
+        LeastUsedCPUs(nprocs,ord);
+    } else {
+        ord.resize(nprocs);
+        std::iota(ord.begin(), ord.end(), 0);
+    }
+
+    for (int i = 0; i < nprocs; ++i)
+    {
+        const int tid = ord[i];
+        const std::vector<int>& vi = vec[LIpairV[i].second];
+
+        if (flag_verbose_mapper) {
+            Print() << "Mapping bucket " << LIpairV[i].second << " to rank " << ord[i] << std::endl;
+        }
+
+        for (int j = 0, Nbx = vi.size(); j < Nbx; ++j) {
+            m_ref->m_pmap[vi[j]] = ParallelContext::local_to_global_rank(tid);
+        }
+    }
+
+    if (eff || verbose)
+    {
+        Real sum_wgt = 0, max_wgt = 0;
+        for (int i = 0; i < nprocs; ++i)
+        {
+            const Long W = pw[i];
+            if (W > max_wgt) max_wgt = W;
+            sum_wgt += W;
+        }
+        Real efficiency = (sum_wgt/(nprocs*max_wgt));
+        if (eff) *eff = efficiency;
+
+        if (verbose)
+        {
+            const Long cut = EdgeCut(graph, part);
+            amrex::Print() << "PARTITION efficiency: " << efficiency
+                           << ", imbalance: " << max_wgt*nprocs/sum_wgt
+                           << ", edge cut: " << cut << " of " << total_edges
+                           << " ghost cells (SFC: " << sfc_cut << ", "
+                           << nmoves << " boxes moved)\n";
+        }
+    }
+}
+
+void
+DistributionMapping::PartitionProcessorMap (const BoxArray&          boxes,
+                                            const std::vector<Long>& wgts,
+                                            int                      nprocs,
+                                            Real*                    efficiency,
+                                            bool                     sort)
+{
+    BL_ASSERT(boxes.size() > 0);
+    BL_ASSERT(boxes.size() == static_cast<int>(wgts.size()));
+
+    m_ref->clear();
+    m_ref->m_pmap.resize(wgts.size());
+
+    if (static_cast<int>(wgts.size()) <= nprocs || nprocs < 2)
+    {
+        RoundRobinProcessorMap(wgts.size(),nprocs);
+
+        if (efficiency) *efficiency = 1;
+    }
+    else
+    {
+        PartitionDoIt(boxes,wgts,nprocs,sort,efficiency);
+    }
+}
+
+void
+DistributionMapping::PartitionProcessorMap (const BoxArray& boxes,
+                                            int             nprocs)
+{
+    std::vector<Long> wgts;
+
+    wgts.reserve(boxes.size());
+
+    for (int i = 0, N = boxes.size(); i < N; ++i)
+    {
+        wgts.push_back(boxes[i].volume());
+    }
+
+    PartitionProcessorMap(boxes,wgts,nprocs);
+}
+
+Long
+DistributionMapping::ComputeDistributionMappingEdgeCut (const DistributionMapping& dm,
+                                                        const BoxArray& ba, int ngrow)
+{
+    BL_ASSERT(dm.size() == ba.size());
+    return EdgeCut(BuildBoxGraph(ba, ngrow), dm.ProcessorMap());
+}
+
+Long
+DistributionMapping::ComputeDistributionMappingEdgeCut (const DistributionMapping& dm,
+                                                        const BoxArray& ba, int ngrow,
+                                                        const Vector<int>& rank_group)
+{
+    BL_ASSERT(dm.size() == ba.size());
+    Vector<int> part(dm.size());
+    for (int i = 0, N = dm.size(); i < N; ++i) {
+        part[i] = rank_group[dm[i]];
+    }
+    return EdgeCut(BuildBoxGraph(ba, ngrow), part);
+}
+
 DistributionMapping
 DistributionMapping::makeKnapSack (const Vector<Real>& rcost, int nmax)
 {
@@ -1657,6 +2212,58 @@ DistributionMapping::makeSFC (const Vector<Real>& rcost, const BoxArray& ba, Rea
     return r;
 }
 
+DistributionMapping
+DistributionMapping::makePartition (const MultiFab& weight, bool sort)
+{
+    BL_PROFILE("makePartition");
+    Vector<Long> cost = gather_weights(weight);
+    int nprocs = ParallelContext::NProcsSub();
+    DistributionMapping r;
+    r.PartitionProcessorMap(weight.boxArray(), cost, nprocs, nullptr, sort);
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makePartition (const MultiFab& weight, Real& eff, bool sort)
+{
+    BL_PROFILE("makePartition");
+    Vector<Long> cost = gather_weights(weight);
+    int nprocs = ParallelContext::NProcsSub();
+    DistributionMapping r;
+    r.PartitionProcessorMap(weight.boxArray(), cost, nprocs, &eff, sort);
+    return r;
+}
+
+DistributionMapping
+DistributionMapping::makePartition (const Vector<Real>& rcost, const BoxArray& ba, bool sort)
+{
+    Real eff;
+    return makePartition(rcost, ba, eff, sort);
+}
+
+DistributionMapping
+DistributionMapping::makePartition (const Vector<Real>& rcost, const BoxArray& ba, Real& eff, bool sort)
+{
+    BL_PROFILE("makePartition");
+
+    DistributionMapping r;
+
+    Vector<Long> cost(rcost.size());
+
+    Real wmax = *std::max_element(rcost.begin(), rcost.end());
+    Real scale = (wmax == 0) ? 1.e9 : 1.e9/wmax;
+
+    for (int i = 0; i < rcost.size(); ++i) {
+        cost[i] = Long(rcost[i]*scale) + 1L;
+    }
+
+    int nprocs = ParallelContext::NProcsSub();
+
+    r.PartitionProcessorMap(ba, cost, nprocs, &eff, sort);
+
+    return r;
+}
+
 DistributionMapping
 DistributionMapping::makeSFC (const LayoutData<Real>& rcost_local,
                               Real& currentEfficiency, Real& proposedEfficiency,
@@ -1723,6 +2330,150 @@ DistributionMapping::makeSFC (const LayoutData<Real>& rcost_local,
     return r;
 }
     
+DistributionMapping
+DistributionMapping::makeIncremental (const DistributionMapping& dm,
+                                      const Vector<Real>& rcost,
+                                      const Vector<Long>& box_bytes,
+                                      Real target_efficiency,
+                                      Real& currentEfficiency,
+                                      Real& proposedEfficiency,
+                                      Long* bytes_moved)
+{
+    BL_PROFILE("makeIncremental");
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int nboxes = dm.size();
+    BL_ASSERT(rcost.size() == nboxes && box_bytes.size() == nboxes);
+
+    Vector<int> pmap = dm.ProcessorMap();
+
+    Vector<Real> load(nprocs, 0.0);
+    Vector<Vector<int> > rank_boxes(nprocs);
+    Real total_cost = 0.0;
+    for (int i = 0; i < nboxes; ++i) {
+        load[pmap[i]] += rcost[i];
+        rank_boxes[pmap[i]].push_back(i);
+        total_cost += rcost[i];
+    }
+
+    auto efficiency = [&] () -> Real {
+        const Real maxload = *std::max_element(load.begin(), load.end());
+        return (maxload > 0.0) ? total_cost/(nprocs*maxload) : Real(1.0);
+    };
+
+    currentEfficiency = efficiency();
+
+    const Real avg = total_cost/nprocs;
+    const Real limit = (target_efficiency > 0.0) ? avg/target_efficiency : avg;
+
+    while (true)
+    {
+        const int p = static_cast<int>(std::max_element(load.begin(), load.end()) - load.begin());
+        const int q = static_cast<int>(std::min_element(load.begin(), load.end()) - load.begin());
+        if (load[p] <= limit || p == q) break;
+
+        // Moving box b from p to q helps if q stays below what p had.  Among
+        // those, take the box that removes the most of p's excess per byte.
+        const Real excess = load[p] - limit;
+        int best = -1;
+        Real best_score = 0.0;
+        for (int j = 0, N = rank_boxes[p].size(); j < N; ++j)
+        {
+            const int b = rank_boxes[p][j];
+            const Real c = rcost[b];
+            if (c <= 0.0 || load[q] + c >= load[p]) continue;
+            const Real score = std::min(c, excess) / static_cast<Real>(std::max(box_bytes[b], Long(1)));
+            if (best < 0 || score > best_score) {
+                best = j;
+                best_score = score;
+            }
+        }
+        if (best < 0) break;
+
+        const int b = rank_boxes[p][best];
+        rank_boxes[p][best] = rank_boxes[p].back();
+        rank_boxes[p].pop_back();
+        rank_boxes[q].push_back(b);
+        load[p] -= rcost[b];
+        load[q] += rcost[b];
+        pmap[b] = q;
+    }
+
+    // A box may have been moved more than once, or back to where it was,
+    // so count the boxes whose owner differs at the end.
+    const Vector<int>& pmap_old = dm.ProcessorMap();
+    Long moved = 0;
+    int nmoves = 0;
+    for (int i = 0; i < nboxes; ++i) {
+        if (pmap[i] != pmap_old[i]) {
+            moved += box_bytes[i];
+            ++nmoves;
+        }
+    }
+
+    proposedEfficiency = efficiency();
+    if (bytes_moved) *bytes_moved = moved;
+
+    if (verbose)
+    {
+        const Long total_bytes = std::accumulate(box_bytes.begin(), box_bytes.end(), Long(0));
+        amrex::Print() << "Incremental rebalance: efficiency " << currentEfficiency
+                       << " -> " << proposedEfficiency << " (target " << target_efficiency
+                       << "), moved " << nmoves << " of " << nboxes << " boxes, "
+                       << moved << " of " << total_bytes << " bytes\n";
+    }
+
+    return DistributionMapping(std::move(pmap));
+}
+
+DistributionMapping
+DistributionMapping::makeIncremental (const LayoutData<Real>& rcost_local,
+                                      Real target_efficiency,
+                                      Real& currentEfficiency,
+                                      Real& proposedEfficiency,
+                                      bool broadcastToAll, int root)
+{
+    BL_PROFILE("makeIncremental");
+
+    Vector<Real> rcost(rcost_local.size());
+    ParallelDescriptor::GatherLayoutDataToVector<Real>(rcost_local, rcost, root);
+    // rcost is now filled out on root
+
+    DistributionMapping r;
+    if (ParallelDescriptor::MyProc() == root)
+    {
+        const BoxArray& ba = rcost_local.boxArray();
+        Vector<Long> box_bytes(ba.size());
+        for (int i = 0; i < ba.size(); ++i) {
+            box_bytes[i] = ba[i].numPts();
+        }
+
+        r = makeIncremental(rcost_local.DistributionMap(), rcost, box_bytes,
+                            target_efficiency, currentEfficiency, proposedEfficiency);
+    }
+
+#ifdef BL_USE_MPI
+    if (broadcastToAll)
+    {
+        Vector<int> pmap(rcost_local.DistributionMap().size());
+        if (ParallelDescriptor::MyProc() == root)
+        {
+            pmap = r.ProcessorMap();
+        }
+
+        ParallelDescriptor::Bcast(&pmap[0], pmap.size(), root);
+        if (ParallelDescriptor::MyProc() != root)
+        {
+            r = DistributionMapping(pmap);
+        }
+    }
+#else
+    amrex::ignore_unused(broadcastToAll);
+#endif
+
+    return r;
+}
+
 std::vector<std::vector<int> >
 DistributionMapping::makeSFC (const BoxArray& ba, bool use_box_vol, const int nprocs)
 {
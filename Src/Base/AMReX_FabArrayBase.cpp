@@ -24,6 +24,8 @@ namespace amrex {
 // Set default values in Initialize()!!!
 //
 int     FabArrayBase::MaxComp;
+bool    FabArrayBase::use_persistent_comm = false;
+bool    FabArrayBase::distributed_fpinfo = false;
 
 #if defined(AMREX_USE_GPU)
 
@@ -78,6 +80,48 @@ namespace
 {
     Arena* the_fa_arena = nullptr;
     bool initialized = false;
+    MPI_Comm persistent_comm = MPI_COMM_NULL;
+    int persistent_tag = 0;
+
+    //
+    // Tags generated for a single local box while building communication
+    // metadata.  Boxes are processed independently so that the work can be
+    // spread over threads, and the results are merged in box order so that
+    // the metadata is identical to what a serial build produces.
+    //
+    struct BoxCommTags
+    {
+        FabArrayBase::CopyComTagsContainer loc;
+        std::vector<std::pair<int,FabArrayBase::CopyComTag> > rmt; // (other rank, tag)
+        bool safe_loc = true;
+        bool safe_rmt = true;
+    };
+
+    void
+    MergeBoxCommTags (Vector<BoxCommTags>& bt,
+                      FabArrayBase::CopyComTagsContainer* loc_tags,
+                      FabArrayBase::MapOfCopyComTagContainers& rmt_tags,
+                      bool& safe_loc, bool& safe_rmt)
+    {
+        for (auto& t : bt)
+        {
+            if (loc_tags) {
+                loc_tags->insert(loc_tags->end(), t.loc.begin(), t.loc.end());
+            }
+            for (auto const& r : t.rmt) {
+                rmt_tags[r.first].push_back(r.second);
+            }
+            safe_loc = safe_loc && t.safe_loc;
+            safe_rmt = safe_rmt && t.safe_rmt;
+        }
+        bt.clear();
+    }
+
+    // If every process is in my team, all copies are local and nothing is sent.
+    bool NothingToSend () noexcept
+    {
+        return ParallelDescriptor::TeamSize() == ParallelDescriptor::NProcs();
+    }
 }
 
 void
@@ -116,6 +160,19 @@ FabArrayBase::Initialize ()
         MaxComp = 1;
     }
 
+    pp.query("use_persistent_comm", FabArrayBase::use_persistent_comm);
+    pp.query("distributed_fpinfo",  FabArrayBase::distributed_fpinfo);
+
+#ifdef BL_USE_MPI
+    //
+    // Persistent requests get their own communicator so that their fixed
+    // tags can never match the sequence-numbered messages.
+    //
+    if (use_persistent_comm && ParallelDescriptor::NProcs() > 1) {
+        MPI_Comm_dup(ParallelDescriptor::Communicator(), &persistent_comm);
+    }
+#endif
+
 #ifdef AMREX_USE_GPU
     if (ParallelDescriptor::UseGpuAwareMpi()) {
         the_fa_arena = The_Device_Arena();
@@ -347,39 +404,49 @@ FabArrayBase::CPC::define (const BoxArray& ba_dst, const DistributionMapping& dm
 	const int nlocal_dst = imap_dst.size();
 	const IntVect& ng_dst = m_dstng;
 
-	std::vector< std::pair<int,Box> > isects;
-
 	const std::vector<IntVect>& pshifts = m_period.shiftIntVect();
 
-	auto& send_tags = *m_SndTags;
-	
-	for (int i = 0; i < nlocal_src; ++i)
+	const int nsnd = NothingToSend() ? 0 : nlocal_src;
+	Vector<BoxCommTags> snd_tags(nsnd);
+
+#ifdef _OPENMP
+#pragma omp parallel if (nsnd > 1)
+#endif
 	{
-	    const int   k_src = imap_src[i];
-	    const Box& bx_src = amrex::grow(ba_src[k_src], ng_src);
+	    std::vector< std::pair<int,Box> > isects;
 
-	    for (std::vector<IntVect>::const_iterator pit=pshifts.begin(); pit!=pshifts.end(); ++pit)
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+	    for (int i = 0; i < nsnd; ++i)
 	    {
-		ba_dst.intersections(bx_src+(*pit), isects, false, ng_dst);
-	    
-		for (int j = 0, M = isects.size(); j < M; ++j)
+		const int   k_src = imap_src[i];
+		const Box& bx_src = amrex::grow(ba_src[k_src], ng_src);
+		auto& tags = snd_tags[i].rmt;
+
+		for (std::vector<IntVect>::const_iterator pit=pshifts.begin(); pit!=pshifts.end(); ++pit)
 		{
-		    const int k_dst     = isects[j].first;
-		    const Box& bx       = isects[j].second;
-		    const int dst_owner = dm_dst[k_dst];
-		
-		    if (ParallelDescriptor::sameTeam(dst_owner)) {
-			continue; // local copy will be dealt with later
-		    } else if (MyProc == dm_src[k_src]) {
-			send_tags[dst_owner].push_back(CopyComTag(bx, bx-(*pit), k_dst, k_src));
+		    ba_dst.intersections(bx_src+(*pit), isects, false, ng_dst);
+
+		    for (int j = 0, M = isects.size(); j < M; ++j)
+		    {
+			const int k_dst     = isects[j].first;
+			const Box& bx       = isects[j].second;
+			const int dst_owner = dm_dst[k_dst];
+
+			if (ParallelDescriptor::sameTeam(dst_owner)) {
+			    continue; // local copy will be dealt with later
+			} else if (MyProc == dm_src[k_src]) {
+			    tags.emplace_back(dst_owner, CopyComTag(bx, bx-(*pit), k_dst, k_src));
+			}
 		    }
 		}
 	    }
 	}
 
-	auto& recv_tags = *m_RcvTags;
+	bool safe_loc = true, safe_rcv = true;
+	MergeBoxCommTags(snd_tags, nullptr, *m_SndTags, safe_loc, safe_rcv);
 
-	BaseFab<int> localtouch(The_Cpu_Arena()), remotetouch(The_Cpu_Arena());
 	bool check_local = false, check_remote = false;
 #if defined(_OPENMP)
 	if (omp_get_max_threads() > 1) {
@@ -395,65 +462,80 @@ FabArrayBase::CPC::define (const BoxArray& ba_dst, const DistributionMapping& dm
 	    check_local = true;
 	}
 
-        m_threadsafe_loc = not check_local;
-        m_threadsafe_rcv = not check_remote;
+	Vector<BoxCommTags> rcv_tags(nlocal_dst);
 
-	for (int i = 0; i < nlocal_dst; ++i)
+#ifdef _OPENMP
+#pragma omp parallel if (nlocal_dst > 1)
+#endif
 	{
-	    const int   k_dst = imap_dst[i];
-	    const Box& bx_dst = amrex::grow(ba_dst[k_dst], ng_dst);
-	    
-	    if (check_local) {
-		localtouch.resize(bx_dst);
-		localtouch.setVal<RunOn::Host>(0);
-	    }
-	    
-	    if (check_remote) {
-		remotetouch.resize(bx_dst);
-		remotetouch.setVal<RunOn::Host>(0);
-	    }
-	    
-	    for (std::vector<IntVect>::const_iterator pit=pshifts.begin(); pit!=pshifts.end(); ++pit)
+	    std::vector< std::pair<int,Box> > isects;
+	    BaseFab<int> localtouch(The_Cpu_Arena()), remotetouch(The_Cpu_Arena());
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+	    for (int i = 0; i < nlocal_dst; ++i)
 	    {
-		ba_src.intersections(bx_dst+(*pit), isects, false, ng_src);
-	    
-		for (int j = 0, M = isects.size(); j < M; ++j)
+		const int   k_dst = imap_dst[i];
+		const Box& bx_dst = amrex::grow(ba_dst[k_dst], ng_dst);
+		auto& bt = rcv_tags[i];
+
+		if (check_local) {
+		    localtouch.resize(bx_dst);
+		    localtouch.setVal<RunOn::Host>(0);
+		}
+
+		if (check_remote) {
+		    remotetouch.resize(bx_dst);
+		    remotetouch.setVal<RunOn::Host>(0);
+		}
+
+		for (std::vector<IntVect>::const_iterator pit=pshifts.begin(); pit!=pshifts.end(); ++pit)
 		{
-		    const int k_src     = isects[j].first;
-		    const Box& bx       = isects[j].second - *pit;
-		    const int src_owner = dm_src[k_src];
-		
-		    if (ParallelDescriptor::sameTeam(src_owner, MyProc)) { // local copy
-			const BoxList tilelist(bx, FabArrayBase::comm_tile_size);
-			for (BoxList::const_iterator
-				 it_tile  = tilelist.begin(),
-				 End_tile = tilelist.end();   it_tile != End_tile; ++it_tile)
-			{
-			    m_LocTags->push_back(CopyComTag(*it_tile, (*it_tile)+(*pit), k_dst, k_src));
-			}
-			if (check_local) {
-			    localtouch.plus<RunOn::Host>(1, bx);
-			}
-		    } else if (MyProc == dm_dst[k_dst]) {
-			recv_tags[src_owner].push_back(CopyComTag(bx, bx+(*pit), k_dst, k_src));
-			if (check_remote) {
-			    remotetouch.plus<RunOn::Host>(1, bx);
+		    ba_src.intersections(bx_dst+(*pit), isects, false, ng_src);
+
+		    for (int j = 0, M = isects.size(); j < M; ++j)
+		    {
+			const int k_src     = isects[j].first;
+			const Box& bx       = isects[j].second - *pit;
+			const int src_owner = dm_src[k_src];
+
+			if (ParallelDescriptor::sameTeam(src_owner, MyProc)) { // local copy
+			    const BoxList tilelist(bx, FabArrayBase::comm_tile_size);
+			    for (BoxList::const_iterator
+				     it_tile  = tilelist.begin(),
+				     End_tile = tilelist.end();   it_tile != End_tile; ++it_tile)
+			    {
+				bt.loc.push_back(CopyComTag(*it_tile, (*it_tile)+(*pit), k_dst, k_src));
+			    }
+			    if (check_local) {
+				localtouch.plus<RunOn::Host>(1, bx);
+			    }
+			} else if (MyProc == dm_dst[k_dst]) {
+			    bt.rmt.emplace_back(src_owner, CopyComTag(bx, bx+(*pit), k_dst, k_src));
+			    if (check_remote) {
+				remotetouch.plus<RunOn::Host>(1, bx);
+			    }
 			}
 		    }
 		}
-	    }
-	    
-	    if (check_local) {  
-		// safe if a cell is touched no more than once 
-		// keep checking thread safety if it is safe so far
-		check_local = m_threadsafe_loc = localtouch.max<RunOn::Host>() <= 1;
-	    }
-	    
-	    if (check_remote) {
-		check_remote = m_threadsafe_rcv = remotetouch.max<RunOn::Host>() <= 1;
+
+		// safe if a cell is touched no more than once
+		if (check_local) {
+		    bt.safe_loc = localtouch.max<RunOn::Host>() <= 1;
+		}
+
+		if (check_remote) {
+		    bt.safe_rmt = remotetouch.max<RunOn::Host>() <= 1;
+		}
 	    }
 	}
-	
+
+	MergeBoxCommTags(rcv_tags, m_LocTags.get(), *m_RcvTags, safe_loc, safe_rcv);
+
+	m_threadsafe_loc = safe_loc;
+	m_threadsafe_rcv = safe_rcv;
+
 	for (int ipass = 0; ipass < 2; ++ipass) // pass 0: send; pass 1: recv
 	{
 	    CopyComTag::MapOfCopyComTagContainers & Tags = (ipass == 0) ? *m_SndTags : *m_RcvTags;
@@ -602,7 +684,9 @@ FabArrayBase::getCPC (const IntVect& dstng, const FabArrayBase& src, const IntVe
     }
     
     // Have to build a new one
+    const double tbuild = amrex::second();
     CPC* new_cpc = new CPC(*this, dstng, src, srcng, period);
+    const double tbuilt = amrex::second() - tbuild;
 
 #ifdef AMREX_MEM_PROFILING
     m_CPC_stats.bytes += new_cpc->bytes();
@@ -610,7 +694,7 @@ FabArrayBase::getCPC (const IntVect& dstng, const FabArrayBase& src, const IntVe
 #endif    
 
     new_cpc->m_nuse = 1;
-    m_CPC_stats.recordBuild();
+    m_CPC_stats.recordBuild(tbuilt);
     m_CPC_stats.recordUse();
 
     m_TheCPCache.insert(er_it.second, CPCache::value_type(dstkey,new_cpc));
@@ -661,41 +745,56 @@ FabArrayBase::FB::define_fb(const FabArrayBase& fa)
     
     const int nlocal = imap.size();
     const IntVect& ng = m_ngrow;
-    std::vector< std::pair<int,Box> > isects;
     
     const std::vector<IntVect>& pshifts = m_period.shiftIntVect();
-    
-    auto& send_tags = *m_SndTags;
-    
-    for (int i = 0; i < nlocal; ++i)
+
+    //
+    // Each local box is handled independently, so the intersections are
+    // spread over threads.  Nothing is sent if all processes are in my team.
+    //
+    const int nsnd = NothingToSend() ? 0 : nlocal;
+    Vector<BoxCommTags> snd_tags(nsnd);
+
+#ifdef _OPENMP
+#pragma omp parallel if (nsnd > 1)
+#endif
     {
-	const int ksnd = imap[i];
-	const Box& vbx = ba[ksnd];
-	
-	for (auto pit=pshifts.cbegin(); pit!=pshifts.cend(); ++pit)
-	{
-	    ba.intersections(vbx+(*pit), isects, false, ng);
+        std::vector< std::pair<int,Box> > isects;
 
-	    for (int j = 0, M = isects.size(); j < M; ++j)
-	    {
-		const int krcv      = isects[j].first;
-		const Box& bx       = isects[j].second;
-		const int dst_owner = dm[krcv];
-		
-		if (ParallelDescriptor::sameTeam(dst_owner)) {
-		    continue;  // local copy will be dealt with later
-		} else if (MyProc == dm[ksnd]) {
-		    const BoxList& bl = amrex::boxDiff(bx, ba[krcv]);
-		    for (BoxList::const_iterator lit = bl.begin(); lit != bl.end(); ++lit)
-			send_tags[dst_owner].push_back(CopyComTag(*lit, (*lit)-(*pit), krcv, ksnd));
-		}
-	    }
-	}
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int i = 0; i < nsnd; ++i)
+        {
+            const int ksnd = imap[i];
+            const Box& vbx = ba[ksnd];
+            auto& tags = snd_tags[i].rmt;
+
+            for (auto pit=pshifts.cbegin(); pit!=pshifts.cend(); ++pit)
+            {
+                ba.intersections(vbx+(*pit), isects, false, ng);
+
+                for (int j = 0, M = isects.size(); j < M; ++j)
+                {
+                    const int krcv      = isects[j].first;
+                    const Box& bx       = isects[j].second;
+                    const int dst_owner = dm[krcv];
+
+                    if (ParallelDescriptor::sameTeam(dst_owner)) {
+                        continue;  // local copy will be dealt with later
+                    } else if (MyProc == dm[ksnd]) {
+                        const BoxList& bl = amrex::boxDiff(bx, ba[krcv]);
+                        for (BoxList::const_iterator lit = bl.begin(); lit != bl.end(); ++lit)
+                            tags.emplace_back(dst_owner, CopyComTag(*lit, (*lit)-(*pit), krcv, ksnd));
+                    }
+                }
+            }
+        }
     }
 
-    auto& recv_tags = *m_RcvTags;
+    bool safe_loc = true, safe_rcv = true;
+    MergeBoxCommTags(snd_tags, nullptr, *m_SndTags, safe_loc, safe_rcv);
 
-    BaseFab<int> localtouch(The_Cpu_Arena()), remotetouch(The_Cpu_Arena());
     bool check_local = false, check_remote = false;
 #if defined(_OPENMP)
     if (omp_get_max_threads() > 1) {
@@ -711,72 +810,87 @@ FabArrayBase::FB::define_fb(const FabArrayBase& fa)
 	check_local = true;
     }
 
-    m_threadsafe_loc = not check_local;
-    m_threadsafe_rcv = not check_remote;
+    Vector<BoxCommTags> rcv_tags(nlocal);
 
-    for (int i = 0; i < nlocal; ++i)
+#ifdef _OPENMP
+#pragma omp parallel if (nlocal > 1)
+#endif
     {
-	const int   krcv = imap[i];
-	const Box& vbx   = ba[krcv];
-	const Box& bxrcv = amrex::grow(vbx, ng);
-	
-	if (check_local) {
-	    localtouch.resize(bxrcv);
-	    localtouch.setVal<RunOn::Host>(0);
-	}
-	
-	if (check_remote) {
-	    remotetouch.resize(bxrcv);
-	    remotetouch.setVal<RunOn::Host>(0);
-	}
-	
-	for (auto pit=pshifts.cbegin(); pit!=pshifts.cend(); ++pit)
-	{
-	    ba.intersections(bxrcv+(*pit), isects);
+        std::vector< std::pair<int,Box> > isects;
+        BaseFab<int> localtouch(The_Cpu_Arena()), remotetouch(The_Cpu_Arena());
 
-	    for (int j = 0, M = isects.size(); j < M; ++j)
-	    {
-		const int ksnd      = isects[j].first;
-		const Box& dst_bx   = isects[j].second - *pit;
-		const int src_owner = dm[ksnd];
-		
-		const BoxList& bl = amrex::boxDiff(dst_bx, vbx);
-		for (BoxList::const_iterator lit = bl.begin(); lit != bl.end(); ++lit)
-		{
-		    const Box& blbx = *lit;
-			
-		    if (ParallelDescriptor::sameTeam(src_owner)) { // local copy
-			const BoxList tilelist(blbx, FabArrayBase::comm_tile_size);
-			for (BoxList::const_iterator
-				 it_tile  = tilelist.begin(),
-				 End_tile = tilelist.end();   it_tile != End_tile; ++it_tile)
-			{
-			    m_LocTags->push_back(CopyComTag(*it_tile, (*it_tile)+(*pit), krcv, ksnd));
-			}
-			if (check_local) {
-			    localtouch.plus<RunOn::Host>(1, blbx);
-			}
-		    } else if (MyProc == dm[krcv]) {
-			recv_tags[src_owner].push_back(CopyComTag(blbx, blbx+(*pit), krcv, ksnd));
-			if (check_remote) {
-			    remotetouch.plus<RunOn::Host>(1, blbx);
-			}
-		    }
-		}
-	    }
-	}
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int i = 0; i < nlocal; ++i)
+        {
+            const int   krcv = imap[i];
+            const Box& vbx   = ba[krcv];
+            const Box& bxrcv = amrex::grow(vbx, ng);
+            auto& bt = rcv_tags[i];
+
+            if (check_local) {
+                localtouch.resize(bxrcv);
+                localtouch.setVal<RunOn::Host>(0);
+            }
 
-	if (check_local) {  
-	    // safe if a cell is touched no more than once 
-	    // keep checking thread safety if it is safe so far
-	    check_local = m_threadsafe_loc = localtouch.max<RunOn::Host>() <= 1;
-	}
+            if (check_remote) {
+                remotetouch.resize(bxrcv);
+                remotetouch.setVal<RunOn::Host>(0);
+            }
 
-	if (check_remote) {
-	    check_remote = m_threadsafe_rcv = remotetouch.max<RunOn::Host>() <= 1;
-	}
+            for (auto pit=pshifts.cbegin(); pit!=pshifts.cend(); ++pit)
+            {
+                ba.intersections(bxrcv+(*pit), isects);
+
+                for (int j = 0, M = isects.size(); j < M; ++j)
+                {
+                    const int ksnd      = isects[j].first;
+                    const Box& dst_bx   = isects[j].second - *pit;
+                    const int src_owner = dm[ksnd];
+
+                    const BoxList& bl = amrex::boxDiff(dst_bx, vbx);
+                    for (BoxList::const_iterator lit = bl.begin(); lit != bl.end(); ++lit)
+                    {
+                        const Box& blbx = *lit;
+
+                        if (ParallelDescriptor::sameTeam(src_owner)) { // local copy
+                            const BoxList tilelist(blbx, FabArrayBase::comm_tile_size);
+                            for (BoxList::const_iterator
+                                     it_tile  = tilelist.begin(),
+                                     End_tile = tilelist.end();   it_tile != End_tile; ++it_tile)
+                            {
+                                bt.loc.push_back(CopyComTag(*it_tile, (*it_tile)+(*pit), krcv, ksnd));
+                            }
+                            if (check_local) {
+                                localtouch.plus<RunOn::Host>(1, blbx);
+                            }
+                        } else if (MyProc == dm[krcv]) {
+                            bt.rmt.emplace_back(src_owner, CopyComTag(blbx, blbx+(*pit), krcv, ksnd));
+                            if (check_remote) {
+                                remotetouch.plus<RunOn::Host>(1, blbx);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // safe if a cell is touched no more than once
+            if (check_local) {
+                bt.safe_loc = localtouch.max<RunOn::Host>() <= 1;
+            }
+
+            if (check_remote) {
+                bt.safe_rmt = remotetouch.max<RunOn::Host>() <= 1;
+            }
+        }
     }
 
+    MergeBoxCommTags(rcv_tags, m_LocTags.get(), *m_RcvTags, safe_loc, safe_rcv);
+
+    m_threadsafe_loc = safe_loc;
+    m_threadsafe_rcv = safe_rcv;
+
     for (int ipass = 0; ipass < 2; ++ipass) // pass 0: send; pass 1: recv
     {
 	CopyComTag::MapOfCopyComTagContainers & Tags = (ipass == 0) ? *m_SndTags : *m_RcvTags;
@@ -861,51 +975,63 @@ FabArrayBase::FB::define_epo (const FabArrayBase& fa)
     const int nlocal = imap.size();
     const IntVect& ng = m_ngrow;
     const IndexType& typ = ba.ixType();
-    std::vector< std::pair<int,Box> > isects;
     
     const std::vector<IntVect>& pshifts = m_period.shiftIntVect();
-    
-    auto& send_tags = *m_SndTags;
 
     Box pdomain = m_period.Domain();
     pdomain.convert(typ);
-    
-    for (int i = 0; i < nlocal; ++i)
+
+    const int nsnd = NothingToSend() ? 0 : nlocal;
+    Vector<BoxCommTags> snd_tags(nsnd);
+
+#ifdef _OPENMP
+#pragma omp parallel if (nsnd > 1)
+#endif
     {
-	const int ksnd = imap[i];
-	Box bxsnd = amrex::grow(ba[ksnd],ng);
-	bxsnd &= pdomain; // source must be inside the periodic domain.
+        std::vector< std::pair<int,Box> > isects;
 
-	if (!bxsnd.ok()) continue;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int i = 0; i < nsnd; ++i)
+        {
+            const int ksnd = imap[i];
+            Box bxsnd = amrex::grow(ba[ksnd],ng);
+            bxsnd &= pdomain; // source must be inside the periodic domain.
 
-	for (auto pit=pshifts.cbegin(); pit!=pshifts.cend(); ++pit)
-	{
-	    if (*pit != IntVect::TheZeroVector())
-	    {
-		ba.intersections(bxsnd+(*pit), isects, false, ng);
-		
-		for (int j = 0, M = isects.size(); j < M; ++j)
-		{
-		    const int krcv      = isects[j].first;
-		    const Box& bx       = isects[j].second;
-		    const int dst_owner = dm[krcv];
-		    
-		    if (ParallelDescriptor::sameTeam(dst_owner)) {
-			continue;  // local copy will be dealt with later
-		    } else if (MyProc == dm[ksnd]) {
-			const BoxList& bl = amrex::boxDiff(bx, pdomain);
-			for (BoxList::const_iterator lit = bl.begin(); lit != bl.end(); ++lit) {
-			    send_tags[dst_owner].push_back(CopyComTag(*lit, (*lit)-(*pit), krcv, ksnd));
-			}
-		    }
-		}
-	    }
-	}
+            if (!bxsnd.ok()) continue;
+
+            auto& tags = snd_tags[i].rmt;
+
+            for (auto pit=pshifts.cbegin(); pit!=pshifts.cend(); ++pit)
+            {
+                if (*pit != IntVect::TheZeroVector())
+                {
+                    ba.intersections(bxsnd+(*pit), isects, false, ng);
+
+                    for (int j = 0, M = isects.size(); j < M; ++j)
+                    {
+                        const int krcv      = isects[j].first;
+                        const Box& bx       = isects[j].second;
+                        const int dst_owner = dm[krcv];
+
+                        if (ParallelDescriptor::sameTeam(dst_owner)) {
+                            continue;  // local copy will be dealt with later
+                        } else if (MyProc == dm[ksnd]) {
+                            const BoxList& bl = amrex::boxDiff(bx, pdomain);
+                            for (BoxList::const_iterator lit = bl.begin(); lit != bl.end(); ++lit) {
+                                tags.emplace_back(dst_owner, CopyComTag(*lit, (*lit)-(*pit), krcv, ksnd));
+                            }
+                        }
+                    }
+                }
+            }
+        }
     }
 
-    auto& recv_tags = *m_RcvTags;
+    bool safe_loc = true, safe_rcv = true;
+    MergeBoxCommTags(snd_tags, nullptr, *m_SndTags, safe_loc, safe_rcv);
 
-    BaseFab<int> localtouch(The_Cpu_Arena()), remotetouch(The_Cpu_Arena());
     bool check_local = false, check_remote = false;
 #if defined(_OPENMP)
     if (omp_get_max_threads() > 1) {
@@ -921,82 +1047,98 @@ FabArrayBase::FB::define_epo (const FabArrayBase& fa)
 	check_local = true;
     }
 
-    m_threadsafe_loc = not check_local;
-    m_threadsafe_rcv = not check_remote;
+    Vector<BoxCommTags> rcv_tags(nlocal);
 
-    for (int i = 0; i < nlocal; ++i)
+#ifdef _OPENMP
+#pragma omp parallel if (nlocal > 1)
+#endif
     {
-	const int   krcv = imap[i];
-	const Box& vbx   = ba[krcv];
-	const Box& bxrcv = amrex::grow(vbx, ng);
-	
-	if (pdomain.contains(bxrcv)) continue;
+        std::vector< std::pair<int,Box> > isects;
+        BaseFab<int> localtouch(The_Cpu_Arena()), remotetouch(The_Cpu_Arena());
 
-	if (check_local) {
-	    localtouch.resize(bxrcv);
-	    localtouch.setVal<RunOn::Host>(0);
-	}
-	
-	if (check_remote) {
-	    remotetouch.resize(bxrcv);
-	    remotetouch.setVal<RunOn::Host>(0);
-	}
-	
-	for (std::vector<IntVect>::const_iterator pit=pshifts.begin(); pit!=pshifts.end(); ++pit)
-	{
-	    if (*pit != IntVect::TheZeroVector())
-	    {
-		ba.intersections(bxrcv+(*pit), isects, false, ng);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int i = 0; i < nlocal; ++i)
+        {
+            const int   krcv = imap[i];
+            const Box& vbx   = ba[krcv];
+            const Box& bxrcv = amrex::grow(vbx, ng);
 
-		for (int j = 0, M = isects.size(); j < M; ++j)
-		{
-		    const int ksnd      = isects[j].first;
-		    const Box& dst_bx   = isects[j].second - *pit;
-		    const int src_owner = dm[ksnd];
-		    
-		    const BoxList& bl = amrex::boxDiff(dst_bx, pdomain);
+            if (pdomain.contains(bxrcv)) continue;
 
-		    for (BoxList::const_iterator lit = bl.begin(); lit != bl.end(); ++lit)
-		    {
-			Box sbx = (*lit) + (*pit);
-			sbx &= pdomain; // source must be inside the periodic domain.
-			
-			if (sbx.ok()) {
-			    Box dbx = sbx - (*pit);
-			    if (ParallelDescriptor::sameTeam(src_owner)) { // local copy
-				const BoxList tilelist(dbx, FabArrayBase::comm_tile_size);
-				for (BoxList::const_iterator
-					 it_tile  = tilelist.begin(),
-					 End_tile = tilelist.end();   it_tile != End_tile; ++it_tile)
-				{
-				    m_LocTags->push_back(CopyComTag(*it_tile, (*it_tile)+(*pit), krcv, ksnd));
-				}
-				if (check_local) {
-				    localtouch.plus<RunOn::Host>(1, dbx);
-				}
-			    } else if (MyProc == dm[krcv]) {
-				recv_tags[src_owner].push_back(CopyComTag(dbx, sbx, krcv, ksnd));
-				if (check_remote) {
-				    remotetouch.plus<RunOn::Host>(1, dbx);
-				}
-			    }
-			}
-		    }
-		}
-	    }
-	}
+            auto& bt = rcv_tags[i];
 
-	if (check_local) {  
-	    // safe if a cell is touched no more than once 
-	    // keep checking thread safety if it is safe so far
-	    check_local = m_threadsafe_loc = localtouch.max<RunOn::Host>() <= 1;
-	}
+            if (check_local) {
+                localtouch.resize(bxrcv);
+                localtouch.setVal<RunOn::Host>(0);
+            }
 
-	if (check_remote) {
-	    check_remote = m_threadsafe_rcv = remotetouch.max<RunOn::Host>() <= 1;
-	}
+            if (check_remote) {
+                remotetouch.resize(bxrcv);
+                remotetouch.setVal<RunOn::Host>(0);
+            }
+
+            for (std::vector<IntVect>::const_iterator pit=pshifts.begin(); pit!=pshifts.end(); ++pit)
+            {
+                if (*pit != IntVect::TheZeroVector())
+                {
+                    ba.intersections(bxrcv+(*pit), isects, false, ng);
+
+                    for (int j = 0, M = isects.size(); j < M; ++j)
+                    {
+                        const int ksnd      = isects[j].first;
+                        const Box& dst_bx   = isects[j].second - *pit;
+                        const int src_owner = dm[ksnd];
+
+                        const BoxList& bl = amrex::boxDiff(dst_bx, pdomain);
+
+                        for (BoxList::const_iterator lit = bl.begin(); lit != bl.end(); ++lit)
+                        {
+                            Box sbx = (*lit) + (*pit);
+                            sbx &= pdomain; // source must be inside the periodic domain.
+
+                            if (sbx.ok()) {
+                                Box dbx = sbx - (*pit);
+                                if (ParallelDescriptor::sameTeam(src_owner)) { // local copy
+                                    const BoxList tilelist(dbx, FabArrayBase::comm_tile_size);
+                                    for (BoxList::const_iterator
+                                             it_tile  = tilelist.begin(),
+                                             End_tile = tilelist.end();   it_tile != End_tile; ++it_tile)
+                                    {
+                                        bt.loc.push_back(CopyComTag(*it_tile, (*it_tile)+(*pit), krcv, ksnd));
+                                    }
+                                    if (check_local) {
+                                        localtouch.plus<RunOn::Host>(1, dbx);
+                                    }
+                                } else if (MyProc == dm[krcv]) {
+                                    bt.rmt.emplace_back(src_owner, CopyComTag(dbx, sbx, krcv, ksnd));
+                                    if (check_remote) {
+                                        remotetouch.plus<RunOn::Host>(1, dbx);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            // safe if a cell is touched no more than once
+            if (check_local) {
+                bt.safe_loc = localtouch.max<RunOn::Host>() <= 1;
+            }
+
+            if (check_remote) {
+                bt.safe_rmt = remotetouch.max<RunOn::Host>() <= 1;
+            }
+        }
     }
 
+    MergeBoxCommTags(rcv_tags, m_LocTags.get(), *m_RcvTags, safe_loc, safe_rcv);
+
+    m_threadsafe_loc = safe_loc;
+    m_threadsafe_rcv = safe_rcv;
+
     for (int ipass = 0; ipass < 2; ++ipass) // pass 0: send; pass 1: recv
     {
 	CopyComTag::MapOfCopyComTagContainers & Tags = (ipass == 0) ? *m_SndTags : *m_RcvTags;
@@ -1012,6 +1154,154 @@ FabArrayBase::FB::define_epo (const FabArrayBase& fa)
 FabArrayBase::FB::~FB ()
 {}
 
+std::shared_ptr<FabArrayBase::FB::PersistentComm>
+FabArrayBase::FB::getPersistentComm (int ncomp, std::size_t value_size,
+                                     std::size_t value_align) const
+{
+#ifdef BL_USE_MPI
+    if (persistent_comm == MPI_COMM_NULL ||
+        ParallelContext::CommunicatorSub() != ParallelDescriptor::Communicator()) {
+        return nullptr;
+    }
+
+    for (auto const& p : m_persistent) {
+        if (p->m_ncomp == ncomp && p->m_value_size == value_size) {
+            return p;
+        }
+    }
+
+    //
+    // All processes build this at the same point, so a counter used for
+    // nothing else gives every PersistentComm a tag that matches across
+    // processes, and that differs from the tags of the other ones that
+    // may be in flight.
+    //
+    const int tag = persistent_tag;
+    persistent_tag = (persistent_tag < ParallelDescriptor::MaxTag()) ? persistent_tag+1 : 0;
+    m_persistent.emplace_back(std::make_shared<PersistentComm>(*this, ncomp, value_size,
+                                                               value_align, persistent_comm, tag));
+    return m_persistent.back();
+#else
+    amrex::ignore_unused(ncomp, value_size, value_align);
+    return nullptr;
+#endif
+}
+
+FabArrayBase::FB::PersistentComm::PersistentComm (const FB& fb, int ncomp, std::size_t value_size,
+                                                  std::size_t value_align, MPI_Comm comm, int tag)
+    : m_ncomp(ncomp),
+      m_value_size(value_size),
+      m_threadsafe_rcv(fb.m_threadsafe_rcv),
+      m_SndTags(fb.m_SndTags),
+      m_RcvTags(fb.m_RcvTags)
+{
+#ifdef BL_USE_MPI
+    BL_PROFILE("FB::PersistentComm::PersistentComm()");
+
+    auto setup = [&] (MapOfCopyComTagContainers const& tags, bool is_send,
+                      Vector<char*>& data, Vector<std::size_t>& size,
+                      Vector<const CopyComTagsContainer*>& cctcs,
+                      Vector<MPI_Request>& reqs) -> char*
+    {
+        Vector<std::size_t> offset;
+        Vector<int> rank;
+        std::size_t total_volume = 0;
+        for (auto const& kv : tags)
+        {
+            std::size_t nbytes = 0;
+            for (auto const& cct : kv.second)
+            {
+                const Box& bx = is_send ? cct.sbox : cct.dbox;
+                nbytes += bx.numPts() * ncomp * value_size;
+            }
+            if (nbytes == 0) continue;
+
+            std::size_t acd = ParallelDescriptor::alignof_comm_data(nbytes);
+            nbytes = amrex::aligned_size(acd, nbytes); // so that bytes are aligned
+
+            // Also need to align the offset properly
+            total_volume = amrex::aligned_size(std::max(value_align, acd), total_volume);
+
+            offset.push_back(total_volume);
+            total_volume += nbytes;
+
+            size.push_back(nbytes);
+            rank.push_back(kv.first);
+            cctcs.push_back(&kv.second);
+        }
+
+        char* the_data = nullptr;
+        if (total_volume > 0) {
+            the_data = static_cast<char*>(The_FA_Arena()->alloc(total_volume));
+        }
+
+        for (int i = 0, N = size.size(); i < N; ++i)
+        {
+            data.push_back(the_data + offset[i]);
+
+            MPI_Datatype dtype;
+            int count;
+            const int comm_data_type = ParallelDescriptor::select_comm_data_type(size[i]);
+            if (comm_data_type == 1) {
+                dtype = ParallelDescriptor::Mpi_typemap<char>::type();
+                count = size[i];
+            } else if (comm_data_type == 2) {
+                dtype = ParallelDescriptor::Mpi_typemap<unsigned long long>::type();
+                count = size[i] / sizeof(unsigned long long);
+            } else if (comm_data_type == 3) {
+                dtype = ParallelDescriptor::Mpi_typemap<ParallelDescriptor::lull_t>::type();
+                count = size[i] / sizeof(ParallelDescriptor::lull_t);
+            } else {
+                amrex::Abort("TODO: message size is too big");
+            }
+
+            MPI_Request req;
+            if (is_send) {
+                BL_MPI_REQUIRE( MPI_Send_init(data[i], count, dtype, rank[i], tag, comm, &req) );
+            } else {
+                BL_MPI_REQUIRE( MPI_Recv_init(data[i], count, dtype, rank[i], tag, comm, &req) );
+            }
+            reqs.push_back(req);
+        }
+
+        return the_data;
+    };
+
+    m_the_send_data = setup(*m_SndTags, true, m_send_data, m_send_size, m_send_cctc, m_send_reqs);
+    m_the_recv_data = setup(*m_RcvTags, false, m_recv_data, m_recv_size, m_recv_cctc, m_recv_reqs);
+    m_stats.resize(std::max(m_send_reqs.size(), m_recv_reqs.size()));
+#else
+    amrex::ignore_unused(fb, value_align, comm, tag);
+#endif
+}
+
+FabArrayBase::FB::PersistentComm::~PersistentComm ()
+{
+#ifdef BL_USE_MPI
+    //
+    // Active requests must complete before they can be freed, and before
+    // their buffers go away.  This happens if a FabArray is destroyed
+    // between FillBoundary_nowait and FillBoundary_finish.
+    //
+    if (m_active) {
+        if (!m_recv_reqs.empty()) {
+            ParallelDescriptor::Waitall(m_recv_reqs, m_stats);
+        }
+        if (!m_send_reqs.empty()) {
+            ParallelDescriptor::Waitall(m_send_reqs, m_stats);
+        }
+    }
+    for (auto& req : m_send_reqs) {
+        MPI_Request_free(&req);
+    }
+    for (auto& req : m_recv_reqs) {
+        MPI_Request_free(&req);
+    }
+#endif
+    if (m_the_send_data) The_FA_Arena()->free(m_the_send_data);
+    if (m_the_recv_data) The_FA_Arena()->free(m_the_recv_data);
+}
+
 void
 FabArrayBase::flushFB (bool no_assertion) const
 {
@@ -1067,7 +1357,9 @@ FabArrayBase::getFB (const IntVect& nghost, const Periodicity& period,
     }
 
     // Have to build a new one
+    const double tbuild = amrex::second();
     FB* new_fb = new FB(*this, nghost, cross, period, enforce_periodicity_only);
+    const double tbuilt = amrex::second() - tbuild;
 
 #ifdef BL_PROFILE
     m_FBC_stats.bytes += new_fb->bytes();
@@ -1075,7 +1367,7 @@ FabArrayBase::getFB (const IntVect& nghost, const Periodicity& period,
 #endif
 
     new_fb->m_nuse = 1;
-    m_FBC_stats.recordBuild();
+    m_FBC_stats.recordBuild(tbuilt);
     m_FBC_stats.recordUse();
 
     m_TheFBCache.insert(er_it.second, FBCache::value_type(m_bdkey,new_fb));
@@ -1112,19 +1404,38 @@ FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
     
     const int myproc = ParallelDescriptor::MyProc();
 
-    BoxList bl(boxtype);
-    Vector<int> iprocs;
+    //
+    // Without distributed_fpinfo every process examines every destination
+    // box so that it can build the whole coarse patch BoxArray on its own.
+    // With it, a process only examines its own boxes and the coarse patches
+    // are all-gathered afterwards.
+    //
+    const bool distributed = distributed_fpinfo && ParallelDescriptor::NProcs() > 1;
+    const Vector<int>& dstidx = dstfa.IndexArray();
+    const int nboxes = distributed ? dstidx.size() : dstba.size();
+
+    Vector<BoxList> leftover(nboxes);
 
-    for (int i = 0, N = dstba.size(); i < N; ++i)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (nboxes > 1)
+#endif
+    for (int ii = 0; ii < nboxes; ++ii)
     {
+        const int i = distributed ? dstidx[ii] : ii;
         Box bx = dstba[i];
         bx.grow(m_dstng);
         bx &= m_dstdomain;
+        srcba.complementIn(leftover[ii], bx);
+    }
 
-        BoxList leftover = srcba.complementIn(bx);
+    BoxList bl(boxtype);
+    Vector<int> iprocs;
 
+    for (int ii = 0; ii < nboxes; ++ii)
+    {
+        const int i = distributed ? dstidx[ii] : ii;
         bool ismybox = (dstdm[i] == myproc);
-        for (BoxList::const_iterator bli = leftover.begin(); bli != leftover.end(); ++bli)
+        for (BoxList::const_iterator bli = leftover[ii].begin(); bli != leftover[ii].end(); ++bli)
         {
             bl.push_back(m_coarsener->doit(*bli));
             if (ismybox) {
@@ -1135,6 +1446,25 @@ FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
         }
     }
 
+    if (distributed)
+    {
+        // Patches are ordered by owner, and by box index within an owner, so
+        // local indices into the patch MultiFab still match dst_boxes.
+        const int nprocs = ParallelDescriptor::NProcs();
+        const int nmine = iprocs.size();
+        Vector<int> counts(nprocs);
+        ParallelAllGather::AllGather(nmine, counts.data(), ParallelDescriptor::Communicator());
+
+        Vector<Box> patches(bl.begin(), bl.end());
+        amrex::AllGatherBoxes(patches);
+
+        bl = BoxList(std::move(patches));
+        iprocs.clear();
+        for (int ip = 0; ip < nprocs; ++ip) {
+            iprocs.insert(iprocs.end(), counts[ip], ip);
+        }
+    }
+
     if (!iprocs.empty()) {
         ba_crse_patch.define(bl);
         dm_crse_patch.define(std::move(iprocs));
@@ -1201,7 +1531,9 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
     }
 
     // Have to build a new one
+    const double tbuild = amrex::second();
     FPinfo* new_fpc = new FPinfo(srcfa, dstfa, dstdomain, dstng, coarsener, cdomain, index_space);
+    const double tbuilt = amrex::second() - tbuild;
 
 #ifdef AMREX_MEM_PROFILING
     m_FPinfo_stats.bytes += new_fpc->bytes();
@@ -1209,7 +1541,7 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
 #endif
     
     new_fpc->m_nuse = 1;
-    m_FPinfo_stats.recordBuild();
+    m_FPinfo_stats.recordBuild(tbuilt);
     m_FPinfo_stats.recordUse();
 
     m_TheFillPatchCache.insert(er_it.second, FPinfoCache::value_type(dstkey,new_fpc));
@@ -1403,6 +1735,13 @@ FabArrayBase::Finalize ()
     FabArrayBase::flushCPCache();
     FabArrayBase::flushTileArrayCache();
 
+#ifdef BL_USE_MPI
+    if (persistent_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&persistent_comm);
+        persistent_comm = MPI_COMM_NULL;
+    }
+#endif
+
     if (ParallelDescriptor::IOProcessor() && amrex::system::verbose > 1) {
 	m_FA_stats.print();
 	m_TAC_stats.print();
@@ -702,4 +702,119 @@ MFGhostIter::Initialize ()
     tile_array      = &(lta.tileArray);
 }
 
+MFOverlapIter::MFOverlapIter (const FabArrayBase& fabarray, const IntVect& ngrow, Phase phase,
+                              const IntVect& tilesize)
+    :
+    MFIter(fabarray, (unsigned char)(SkipInit|Tiling)),
+    m_ngrow(ngrow)
+{
+    Initialize(ngrow, phase, tilesize);
+}
+
+MFOverlapIter::MFOverlapIter (const FabArrayBase& fabarray, int ngrow, Phase phase,
+                              const IntVect& tilesize)
+    :
+    MFIter(fabarray, (unsigned char)(SkipInit|Tiling)),
+    m_ngrow(ngrow)
+{
+    Initialize(m_ngrow, phase, tilesize);
+}
+
+Box
+MFOverlapIter::interiorbox () const noexcept
+{
+    Box bx = amrex::grow(validbox(), -m_ngrow);
+    // A nodal validbox has one more point than its cells, so the interior
+    // nodes start one node further from the boundary.
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        if (typ.nodeCentered(d)) bx.growHi(d,-1);
+    }
+    return bx;
+}
+
+void
+MFOverlapIter::Initialize (const IntVect& ngrow, Phase phase, const IntVect& tilesize)
+{
+    BL_ASSERT(ngrow.allGE(IntVect::TheZeroVector()));
+
+    int rit = 0;
+    int nworkers = 1;
+#ifdef BL_USE_TEAM
+    if (ParallelDescriptor::TeamSize() > 1) {
+	rit = ParallelDescriptor::MyRankInTeam();
+	nworkers = ParallelDescriptor::TeamSize();
+    }
+#endif
+
+    int tid = OpenMP::get_thread_num();
+    int nthreads = OpenMP::get_num_threads();
+
+    int npes = nworkers*nthreads;
+    int pid = rit*nthreads+tid;
+
+    BoxList alltiles;
+    Vector<int> allindex;
+    Vector<int> alllocalindex;
+
+    // Tiles are cell-centered, as in the regular MFIter tile arrays, so that
+    // tilebox() & co. give nodal tiles that partition the valid box.
+    for (int i=0; i < fabArray.IndexArray().size(); ++i) {
+	int K = fabArray.IndexArray()[i];
+	const Box& vbx = amrex::enclosedCells(fabArray.box(K));
+	const Box& ibx = amrex::grow(vbx, -ngrow);
+
+	BoxList regions;
+	if (phase == InteriorTiles) {
+	    if (ibx.ok()) regions.push_back(ibx);
+	} else {
+	    if (ibx.ok()) {
+		regions = amrex::boxDiff(vbx, ibx);
+	    } else {
+		regions.push_back(vbx);
+	    }
+	}
+
+	for (BoxList::const_iterator bli = regions.begin(); bli != regions.end(); ++bli) {
+	    BoxList tiles(*bli, tilesize);
+	    int nt = tiles.size();
+	    for (int it=0; it<nt; ++it) {
+		allindex.push_back(K);
+		alllocalindex.push_back(i);
+	    }
+	    alltiles.catenate(tiles);
+	}
+    }
+
+    int n_tot_tiles = alltiles.size();
+    int navg = n_tot_tiles / npes;
+    int nleft = n_tot_tiles - navg*npes;
+    int ntiles = navg;
+    if (pid < nleft) ntiles++;
+
+    // how many tiles should we skip?
+    int nskip = pid*navg + std::min(pid,nleft);
+    BoxList::const_iterator bli = alltiles.begin();
+    for (int i=0; i<nskip; ++i) ++bli;
+
+    lta.indexMap.reserve(ntiles);
+    lta.localIndexMap.reserve(ntiles);
+    lta.tileArray.reserve(ntiles);
+
+    for (int i=0; i<ntiles; ++i) {
+	lta.indexMap.push_back(allindex[i+nskip]);
+	lta.localIndexMap.push_back(alllocalindex[i+nskip]);
+	lta.tileArray.push_back(*bli++);
+    }
+
+    currentIndex = beginIndex = 0;
+    endIndex = lta.indexMap.size();
+
+    lta.nuse = 0;
+    index_map       = &(lta.indexMap);
+    local_index_map = &(lta.localIndexMap);
+    tile_array      = &(lta.tileArray);
+
+    typ = fabArray.boxArray().ixType();
+}
+
 }
@@ -212,6 +212,17 @@ class Machine
         node_ids = get_node_ids();
     }
 
+    // the topology is only needed by the node-aware strategies, so it is
+    // not gathered until they ask for it
+    const Vector<int>& rank_node_ids () {
+        if (!topo_done) get_topology();
+        return topo_node_ids;
+    }
+    const Vector<int>& rank_numa_ids () {
+        if (!topo_done) get_topology();
+        return topo_numa_ids;
+    }
+
     // find a compact neighborhood of size rank_n in the current ParallelContext subgroup
     Vector<int> find_best_nbh (int nbh_rank_n, bool flag_local_ranks)
     {
@@ -321,6 +332,10 @@ class Machine
     bool flag_nersc_df;
     // int my_node_id;
     Vector<int> node_ids;
+    std::string topology_file;
+    Vector<int> topo_node_ids;
+    Vector<int> topo_numa_ids;
+    bool topo_done = false;
 
     NeighborhoodCache nbh_cache;
 
@@ -329,6 +344,7 @@ class Machine
         ParmParse pp("machine");
         pp.query("verbose", flag_verbose);
         pp.query("very_verbose", flag_very_verbose);
+        pp.query("topology_file", topology_file);
     }
 
     std::string get_env_str (std::string env_key)
@@ -433,6 +449,79 @@ class Machine
         return ids;
     }
 
+    // get the node and NUMA domain of all ranks in this job, indexed by job rank,
+    // either from the user supplied topology file or from MPI
+    // this is collective over ALL ranks in the job
+    void get_topology ()
+    {
+        BL_PROFILE("Machine::get_topology()");
+
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ParallelContext::NProcsSub() == ParallelDescriptor::NProcs(),
+            "machine::rank_node_ids: the first call must be made by all ranks, not in a subgroup");
+
+        topo_done = true;
+        const int nprocs = ParallelDescriptor::NProcs();
+        topo_node_ids.assign(nprocs, 0);
+        topo_numa_ids.assign(nprocs, 0);
+
+        if (!topology_file.empty())
+        {
+            // Each line is "rank node [numa]".  Lines starting with # are ignored.
+            Vector<char> fileCharPtr;
+            ParallelDescriptor::ReadAndBcastFile(topology_file, fileCharPtr, true,
+                                                 ParallelContext::CommunicatorAll());
+            std::istringstream is(std::string(fileCharPtr.dataPtr()), std::istringstream::in);
+            std::vector<bool> found(nprocs, false);
+            std::string line;
+            while (std::getline(is, line))
+            {
+                if (line.empty() || line[0] == '#') continue;
+                std::istringstream ls(line);
+                int rank, node, numa = 0;
+                if (!(ls >> rank >> node)) continue;
+                ls >> numa;
+                if (rank >= 0 && rank < nprocs) {
+                    topo_node_ids[rank] = node;
+                    topo_numa_ids[rank] = numa;
+                    found[rank] = true;
+                }
+            }
+            for (int i = 0; i < nprocs; ++i) {
+                if (!found[i]) {
+                    amrex::Abort("machine.topology_file " + topology_file + " has no entry for rank "
+                                 + std::to_string(i));
+                }
+            }
+        }
+        else
+        {
+#ifdef BL_USE_MPI
+            // Ranks sharing memory are on the same node.  Use the lowest rank
+            // on the node as its ID.
+            MPI_Comm node_comm;
+            MPI_Comm_split_type(ParallelContext::CommunicatorAll(), MPI_COMM_TYPE_SHARED,
+                                ParallelDescriptor::MyProc(), MPI_INFO_NULL, &node_comm);
+            int node_id = ParallelDescriptor::MyProc();
+            MPI_Bcast(&node_id, 1, MPI_INT, 0, node_comm);
+            MPI_Comm_free(&node_comm);
+            ParallelAllGather::AllGather(node_id, topo_node_ids.data(),
+                                         ParallelContext::CommunicatorAll());
+#endif
+        }
+
+        if (flag_verbose) {
+            std::map<std::pair<int,int>, Vector<int>> domain_ranks;
+            for (int i = 0; i < nprocs; ++i) {
+                domain_ranks[std::make_pair(topo_node_ids[i],topo_numa_ids[i])].push_back(i);
+            }
+            Print() << "Node: NUMA domain: Ranks:" << std::endl;
+            for (const auto & p : domain_ranks) {
+                Print() << "  " << p.first.first << ": " << p.first.second
+                        << ": " << to_str(p.second) << std::endl;
+            }
+        }
+    }
+
     // do a local search starting at current node
     std::pair<Vector<int>, double>
     baseline_score(const Vector<int> & sg_node_ids, int nbh_rank_n)
@@ -595,4 +684,14 @@ Vector<int> find_best_nbh (int rank_n, bool flag_local_ranks) {
     return the_machine->find_best_nbh(rank_n, flag_local_ranks);
 }
 
+const Vector<int>& rank_node_ids () {
+    AMREX_ASSERT(the_machine);
+    return the_machine->rank_node_ids();
+}
+
+const Vector<int>& rank_numa_ids () {
+    AMREX_ASSERT(the_machine);
+    return the_machine->rank_numa_ids();
+}
+
 }}
@@ -115,6 +115,35 @@ MultiFab::Dot (const iMultiFab& mask,
     return sm;
 }
 
+ReduceHandle<Real>
+MultiFab::Dot_nowait (const MultiFab& x, int xcomp,
+                      const MultiFab& y, int ycomp,
+                      int numcomp, int nghost)
+{
+    Vector<Real> sm{MultiFab::Dot(x, xcomp, y, ycomp, numcomp, nghost, true)};
+    return ReduceHandle<Real>(detail::ReduceOp::sum, std::move(sm), Vector<Real*>(),
+                              ParallelContext::CommunicatorSub());
+}
+
+ReduceHandle<Real>
+MultiFab::Dot_nowait (const MultiFab& x, int xcomp, int numcomp, int nghost)
+{
+    Vector<Real> sm{MultiFab::Dot(x, xcomp, numcomp, nghost, true)};
+    return ReduceHandle<Real>(detail::ReduceOp::sum, std::move(sm), Vector<Real*>(),
+                              ParallelContext::CommunicatorSub());
+}
+
+ReduceHandle<Real>
+MultiFab::Dot_nowait (const iMultiFab& mask,
+                      const MultiFab& x, int xcomp,
+                      const MultiFab& y, int ycomp,
+                      int numcomp, int nghost)
+{
+    Vector<Real> sm{MultiFab::Dot(mask, x, xcomp, y, ycomp, numcomp, nghost, true)};
+    return ReduceHandle<Real>(detail::ReduceOp::sum, std::move(sm), Vector<Real*>(),
+                              ParallelContext::CommunicatorSub());
+}
+
 void
 MultiFab::Add (MultiFab& dst, const MultiFab& src,
                int srccomp, int dstcomp, int numcomp, int nghost)
@@ -450,6 +479,221 @@ MultiFab::AddProduct (MultiFab& dst,
     }
 }
 
+constexpr int MultiFab::max_fused_ops;
+
+namespace detail {
+
+struct FusedLinCombArrays
+{
+    GpuArray<Array4<Real      >,MultiFab::max_fused_ops> d;
+    GpuArray<Array4<Real const>,MultiFab::max_fused_ops> x;
+    GpuArray<Array4<Real const>,MultiFab::max_fused_ops> y;
+    GpuArray<Real,MultiFab::max_fused_ops> a;
+    GpuArray<Real,MultiFab::max_fused_ops> b;
+    int nops;
+};
+
+enum FusedReduction { fused_none = 0, fused_dot, fused_norm0 };
+
+// The updates are done row by row so that a row of every operand stays
+// in cache between the updates and the reduction.
+template <int RED>
+Real fused_lincomb_box (Box const& bx, int numcomp, FusedLinCombArrays const& fa,
+                        Array4<Real const> const& rx, Array4<Real const> const& ry)
+{
+    Real t = 0.0;
+    const auto lo = amrex::lbound(bx);
+    const auto hi = amrex::ubound(bx);
+    const int len = hi.x - lo.x + 1;
+    for (int n = 0; n < numcomp; ++n) {
+    for (int k = lo.z; k <= hi.z; ++k) {
+    for (int j = lo.y; j <= hi.y; ++j) {
+        for (int m = 0; m < fa.nops; ++m) {
+            // x or y may be the same as d, but only at the same index.
+            Real*       dp = fa.d[m].ptr(lo.x,j,k,n);
+            Real const* xp = fa.x[m].ptr(lo.x,j,k,n);
+            Real const* yp = fa.y[m].ptr(lo.x,j,k,n);
+            const Real a = fa.a[m];
+            const Real b = fa.b[m];
+            AMREX_PRAGMA_SIMD
+            for (int i = 0; i < len; ++i) {
+                dp[i] = a*xp[i] + b*yp[i];
+            }
+        }
+        if (RED == fused_dot) {
+            Real const* xp = rx.ptr(lo.x,j,k,n);
+            Real const* yp = ry.ptr(lo.x,j,k,n);
+            for (int i = 0; i < len; ++i) {
+                t += xp[i] * yp[i];
+            }
+        } else if (RED == fused_norm0) {
+            Real const* xp = rx.ptr(lo.x,j,k,n);
+            for (int i = 0; i < len; ++i) {
+                t = amrex::max(t, amrex::Math::abs(xp[i]));
+            }
+        }
+    }}}
+    return t;
+}
+
+template <int RED>
+Real fused_lincomb (const Vector<MultiFab::LinCombOp>& ops,
+                    const MultiFab* rxmf, int rxcomp,
+                    const MultiFab* rymf, int rycomp,
+                    int numcomp, int nghost)
+{
+    const int nops = ops.size();
+    if (nops > MultiFab::max_fused_ops) {
+        amrex::Abort("MultiFab::FusedLinComb: too many operations");
+    }
+
+    const MultiFab* ref = (rxmf) ? rxmf : ((nops > 0) ? ops[0].dst : nullptr);
+    if (ref == nullptr) return 0.0;
+
+    for (auto const& op : ops) {
+        BL_ASSERT(op.dst->boxArray() == ref->boxArray() && op.x->boxArray() == ref->boxArray()
+                  && op.y->boxArray() == ref->boxArray());
+        BL_ASSERT(op.dst->DistributionMap() == ref->DistributionMap()
+                  && op.x->DistributionMap() == ref->DistributionMap()
+                  && op.y->DistributionMap() == ref->DistributionMap());
+        BL_ASSERT(op.dst->nGrow() >= nghost && op.x->nGrow() >= nghost && op.y->nGrow() >= nghost);
+        amrex::ignore_unused(op);
+    }
+    BL_ASSERT(rxmf == nullptr || rxmf->nGrow() >= nghost);
+    BL_ASSERT(rymf == nullptr || (rymf->boxArray() == ref->boxArray() && rymf->nGrow() >= nghost));
+
+    Real sm = 0.0;
+
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion())
+    {
+        ReduceOps<ReduceOpSum,ReduceOpMax> reduce_op;
+        ReduceData<Real,Real> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+
+        for (MFIter mfi(*ref); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.growntilebox(nghost);
+            FusedLinCombArrays fa;
+            fa.nops = nops;
+            for (int m = 0; m < nops; ++m) {
+                fa.d[m] = Array4<Real      >(ops[m].dst->array(mfi), ops[m].dstcomp);
+                fa.x[m] = Array4<Real const>(ops[m].x->const_array(mfi), ops[m].xcomp);
+                fa.y[m] = Array4<Real const>(ops[m].y->const_array(mfi), ops[m].ycomp);
+                fa.a[m] = ops[m].a;
+                fa.b[m] = ops[m].b;
+            }
+            Array4<Real const> rx, ry;
+            if (rxmf) rx = Array4<Real const>(rxmf->const_array(mfi), rxcomp);
+            if (rymf) ry = Array4<Real const>(rymf->const_array(mfi), rycomp);
+            reduce_op.eval(bx, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+            {
+                Real s = 0.0;
+                Real mx = 0.0;
+                for (int n = 0; n < numcomp; ++n) {
+                    for (int m = 0; m < fa.nops; ++m) {
+                        fa.d[m](i,j,k,n) = fa.a[m]*fa.x[m](i,j,k,n) + fa.b[m]*fa.y[m](i,j,k,n);
+                    }
+                    if (RED == fused_dot) {
+                        s += rx(i,j,k,n) * ry(i,j,k,n);
+                    } else if (RED == fused_norm0) {
+                        mx = amrex::max(mx, amrex::Math::abs(rx(i,j,k,n)));
+                    }
+                }
+                return {s, mx};
+            });
+        }
+
+        ReduceTuple hv = reduce_data.value();
+        sm = (RED == fused_norm0) ? amrex::get<1>(hv) : amrex::get<0>(hv);
+    }
+    else
+#endif
+    {
+        Real mx = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel if (!system::regtest_reduction) reduction(+:sm) reduction(max:mx)
+#endif
+        for (MFIter mfi(*ref,true); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.growntilebox(nghost);
+            if (bx.ok()) {
+                FusedLinCombArrays fa;
+                fa.nops = nops;
+                for (int m = 0; m < nops; ++m) {
+                    fa.d[m] = Array4<Real      >(ops[m].dst->array(mfi), ops[m].dstcomp);
+                    fa.x[m] = Array4<Real const>(ops[m].x->const_array(mfi), ops[m].xcomp);
+                    fa.y[m] = Array4<Real const>(ops[m].y->const_array(mfi), ops[m].ycomp);
+                    fa.a[m] = ops[m].a;
+                    fa.b[m] = ops[m].b;
+                }
+                Array4<Real const> rx, ry;
+                if (rxmf) rx = Array4<Real const>(rxmf->const_array(mfi), rxcomp);
+                if (rymf) ry = Array4<Real const>(rymf->const_array(mfi), rycomp);
+                Real t = fused_lincomb_box<RED>(bx, numcomp, fa, rx, ry);
+                if (RED == fused_norm0) {
+                    mx = amrex::max(mx, t);
+                } else {
+                    sm += t;
+                }
+            }
+        }
+        if (RED == fused_norm0) sm = mx;
+    }
+
+    return sm;
+}
+
+}
+
+void
+MultiFab::FusedLinComb (const Vector<LinCombOp>& ops, int numcomp, int nghost)
+{
+    BL_PROFILE("MultiFab::FusedLinComb()");
+    detail::fused_lincomb<detail::fused_none>(ops, nullptr, 0, nullptr, 0, numcomp, nghost);
+}
+
+Real
+MultiFab::FusedLinCombDot (const Vector<LinCombOp>& ops,
+                           const MultiFab& x, int xcomp,
+                           const MultiFab& y, int ycomp,
+                           int numcomp, int nghost, bool local)
+{
+    BL_PROFILE("MultiFab::FusedLinCombDot()");
+
+    Real sm = detail::fused_lincomb<detail::fused_dot>(ops, &x, xcomp, &y, ycomp, numcomp, nghost);
+
+    if (!local) ParallelAllReduce::Sum(sm, ParallelContext::CommunicatorSub());
+
+    return sm;
+}
+
+ReduceHandle<Real>
+MultiFab::FusedLinCombDot_nowait (const Vector<LinCombOp>& ops,
+                                  const MultiFab& x, int xcomp,
+                                  const MultiFab& y, int ycomp,
+                                  int numcomp, int nghost)
+{
+    Vector<Real> sm{MultiFab::FusedLinCombDot(ops, x, xcomp, y, ycomp, numcomp, nghost, true)};
+    return ReduceHandle<Real>(detail::ReduceOp::sum, std::move(sm), Vector<Real*>(),
+                              ParallelContext::CommunicatorSub());
+}
+
+Real
+MultiFab::FusedLinCombNorm0 (const Vector<LinCombOp>& ops,
+                             const MultiFab& x, int xcomp,
+                             int numcomp, int nghost, bool local)
+{
+    BL_PROFILE("MultiFab::FusedLinCombNorm0()");
+
+    Real mx = detail::fused_lincomb<detail::fused_norm0>(ops, &x, xcomp, nullptr, 0, numcomp, nghost);
+
+    if (!local) ParallelAllReduce::Max(mx, ParallelContext::CommunicatorSub());
+
+    return mx;
+}
+
 void
 MultiFab::plus (Real val, int  nghost)
 {
@@ -1016,6 +1260,64 @@ MultiFab::norm2 (const Vector<int>& comps) const
     return nm2;
 }
 
+ReduceHandle<Real>
+MultiFab::norm0_nowait (int comp, int nghost, bool ignore_covered) const
+{
+    Vector<Real> nm0{this->norm0(comp, nghost, true, ignore_covered)};
+    return ReduceHandle<Real>(detail::ReduceOp::max, std::move(nm0), Vector<Real*>(),
+                              ParallelContext::CommunicatorSub());
+}
+
+ReduceHandle<Real>
+MultiFab::norm0_nowait (const Vector<int>& comps, int nghost, bool ignore_covered) const
+{
+    Vector<Real> nm0 = this->norm0(comps, nghost, true, ignore_covered);
+    return ReduceHandle<Real>(detail::ReduceOp::max, std::move(nm0), Vector<Real*>(),
+                              ParallelContext::CommunicatorSub());
+}
+
+ReduceHandle<Real>
+MultiFab::norm1_nowait (int comp, int ngrow) const
+{
+    Vector<Real> nm1{this->norm1(comp, ngrow, true)};
+    return ReduceHandle<Real>(detail::ReduceOp::sum, std::move(nm1), Vector<Real*>(),
+                              ParallelContext::CommunicatorSub());
+}
+
+ReduceHandle<Real>
+MultiFab::norm1_nowait (const Vector<int>& comps, int ngrow) const
+{
+    Vector<Real> nm1 = this->norm1(comps, ngrow, true);
+    return ReduceHandle<Real>(detail::ReduceOp::sum, std::move(nm1), Vector<Real*>(),
+                              ParallelContext::CommunicatorSub());
+}
+
+ReduceHandle<Real>
+MultiFab::norm2_nowait (int comp) const
+{
+    BL_ASSERT(ixType().cellCentered());
+
+    auto h = MultiFab::Dot_nowait(*this, comp, 1, 0);
+    h.setPostOp([] (Real x) { return std::sqrt(x); });
+    return h;
+}
+
+ReduceHandle<Real>
+MultiFab::norm2_nowait (const Vector<int>& comps) const
+{
+    BL_ASSERT(ixType().cellCentered());
+
+    Vector<Real> nm2;
+    nm2.reserve(comps.size());
+    for (int comp : comps) {
+        nm2.push_back(MultiFab::Dot(*this, comp, 1, 0, true));
+    }
+    ReduceHandle<Real> h(detail::ReduceOp::sum, std::move(nm2), Vector<Real*>(),
+                         ParallelContext::CommunicatorSub());
+    h.setPostOp([] (Real x) { return std::sqrt(x); });
+    return h;
+}
+
 Real
 MultiFab::norm1 (int comp, const Periodicity& period, bool ignore_covered ) const
 {
@@ -1,4 +1,9 @@
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <utility>
 #include <AMReX_PlotFileDataImpl.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_VisMF.H>
@@ -73,6 +78,8 @@ PlotFileDataImpl::PlotFileDataImpl (std::string const& plotfile_name)
     m_ba.resize(m_nlevels);
     m_dmap.resize(m_nlevels);
     m_ngrow.resize(m_nlevels);
+    m_grid_min.resize(m_nlevels);
+    m_grid_max.resize(m_nlevels);
     for (int ilev = 0; ilev < m_nlevels; ++ilev) {
         int levtmp, ngrids, levsteptmp;
         Real gtime;
@@ -127,19 +134,262 @@ MultiFab
 PlotFileDataImpl::get (int level, std::string const& varname) noexcept
 {
     MultiFab mf(m_ba[level], m_dmap[level], 1, m_ngrow[level]);
+    int icomp = varIndex(varname);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        int gid = mfi.index();
+        FArrayBox& dstfab = mf[mfi];
+        std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
+        dstfab.copy<RunOn::Host>(*srcfab);
+    }
+    return mf;
+}
+
+void
+PlotFileDataImpl::fill (FArrayBox& fab, int level, std::string const& varname, int destcomp)
+{
+    fill(fab, level, varIndex(varname), destcomp, 1);
+}
+
+void
+PlotFileDataImpl::fill (FArrayBox& fab, int level, int icomp, int destcomp, int numcomp)
+{
+    BL_PROFILE("PlotFileDataImpl::fill()");
+    // Only the valid cells, so that the ghost cells of a box do not
+    // overwrite the valid cells of its neighbors
+    for (auto const& is : m_ba[level].intersections(fab.box())) {
+        m_vismf[level]->readFABRegion(fab, is.second, is.first, icomp, destcomp, numcomp);
+    }
+}
+
+FArrayBox
+PlotFileDataImpl::get (int level, std::string const& varname, Box const& box)
+{
+    FArrayBox fab(box, 1);
+    fill(fab, level, varIndex(varname), 0, 1);
+    return fab;
+}
+
+Real
+PlotFileDataImpl::min (int level, std::string const& varname)
+{
+    int icomp = varIndex(varname);
+    Real r = m_vismf[level]->min(icomp);
+    if (r == std::numeric_limits<Real>::max()) {  // not in the header
+        r = get(level, varname).min(0);
+    }
+    return r;
+}
+
+Real
+PlotFileDataImpl::max (int level, std::string const& varname)
+{
+    int icomp = varIndex(varname);
+    Real r = m_vismf[level]->max(icomp);
+    if (r == std::numeric_limits<Real>::lowest()) {  // not in the header
+        r = get(level, varname).max(0);
+    }
+    return r;
+}
+
+int
+PlotFileDataImpl::varIndex (std::string const& varname) const
+{
     auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
     if (r == std::end(m_var_names)) {
-        amrex::Abort("PlotFileDataImpl::get: varname not found "+varname);
-    } else {
-        int icomp = std::distance(std::begin(m_var_names), r);
-        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-            int gid = mfi.index();
-            FArrayBox& dstfab = mf[mfi];
-            std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
-            dstfab.copy<RunOn::Host>(*srcfab);
+        amrex::Abort("PlotFileDataImpl: varname not found "+varname);
+    }
+    return std::distance(std::begin(m_var_names), r);
+}
+
+Vector<int>
+PlotFileDataImpl::gridsInRange (int level, std::string const& varname, Real lo, Real hi,
+                                Box const& region)
+{
+    int icomp = varIndex(varname);
+    buildIndex(level);
+    const BoxArray& ba = m_ba[level];
+    const Vector<Real>& gmin = m_grid_min[level];
+    const Vector<Real>& gmax = m_grid_max[level];
+    Vector<int> grids;
+    for (int igrid = 0, N = ba.size(); igrid < N; ++igrid) {
+        if (region.ok() and not region.intersects(ba[igrid])) {
+            continue;
+        }
+        if (gmax[igrid*m_ncomp+icomp] < lo or gmin[igrid*m_ncomp+icomp] > hi) {
+            continue;
         }
+        grids.push_back(igrid);
+    }
+    return grids;
+}
+
+PlotFileCells
+PlotFileDataImpl::findCells (int level, std::string const& varname, Real lo, Real hi,
+                             Box const& region)
+{
+    BL_PROFILE("PlotFileDataImpl::findCells()");
+    int icomp = varIndex(varname);
+    const int myproc = ParallelDescriptor::MyProc();
+    PlotFileCells r;
+    FArrayBox fab;
+    for (int igrid : gridsInRange(level, varname, lo, hi, region)) {
+        if (m_dmap[level][igrid] != myproc) {
+            continue;
+        }
+        Box bx = m_ba[level][igrid];
+        if (region.ok()) {
+            bx &= region;
+        }
+        fab.resize(bx, 1);
+        m_vismf[level]->readFABRegion(fab, bx, igrid, icomp, 0, 1);
+        ++r.ngrids_read;
+        const auto& a = fab.const_array();
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+        {
+            const Real v = a(i,j,k);
+            if (v >= lo and v <= hi) {
+                r.cells.push_back(IntVect(AMREX_D_DECL(i,j,k)));
+                r.values.push_back(v);
+            }
+        });
+    }
+    return r;
+}
+
+void
+PlotFileDataImpl::buildIndex (int level)
+{
+    if (m_ncomp == 0 or not m_grid_min[level].empty()) {
+        return;
+    }
+
+    BL_PROFILE("PlotFileDataImpl::buildIndex()");
+
+    const VisMF& vismf = *m_vismf[level];
+    const int ngrids = m_ba[level].size();
+    Vector<Real>& gmin = m_grid_min[level];
+    Vector<Real>& gmax = m_grid_max[level];
+    gmin.resize(ngrids*m_ncomp, std::numeric_limits<Real>::max());
+    gmax.resize(ngrids*m_ncomp, std::numeric_limits<Real>::lowest());
+
+    if (vismf.min(0,0) != std::numeric_limits<Real>::max())
+    {
+        // The header has the min and max of the data before they were
+        // written.  Widen them to cover the rounding to the precision on
+        // disk and the error of lossy compression.
+        constexpr Real eps = std::numeric_limits<float>::epsilon();
+        for (int icomp = 0; icomp < m_ncomp; ++icomp) {
+            const Real tol = vismf.tolerance(icomp);
+            for (int igrid = 0; igrid < ngrids; ++igrid) {
+                const Real mn = vismf.min(igrid,icomp);
+                const Real mx = vismf.max(igrid,icomp);
+                gmin[igrid*m_ncomp+icomp] = mn - tol - eps*std::abs(mn);
+                gmax[igrid*m_ncomp+icomp] = mx + tol + eps*std::abs(mx);
+            }
+        }
+    }
+    else if (not (m_cache_index and readIndex(level)))
+    {
+        // Read the data once, each process its own grids.
+        const int myproc = ParallelDescriptor::MyProc();
+        FArrayBox fab;
+        for (int igrid = 0; igrid < ngrids; ++igrid) {
+            if (m_dmap[level][igrid] != myproc) {
+                continue;
+            }
+            fab.resize(m_ba[level][igrid], m_ncomp);
+            vismf.readFABRegion(fab, fab.box(), igrid, 0, 0, m_ncomp);
+            for (int icomp = 0; icomp < m_ncomp; ++icomp) {
+                gmin[igrid*m_ncomp+icomp] = fab.min<RunOn::Host>(icomp);
+                gmax[igrid*m_ncomp+icomp] = fab.max<RunOn::Host>(icomp);
+            }
+        }
+        ParallelDescriptor::ReduceRealMin(gmin.data(), gmin.size());
+        ParallelDescriptor::ReduceRealMax(gmax.data(), gmax.size());
+        if (m_cache_index) {
+            writeIndex(level);
+        }
+    }
+}
+
+// The sidecar file of a level has a line with the box and the min and
+// max of each component for each grid, so that it can be checked
+// against the BoxArray.
+namespace {
+    const std::string index_version("PlotFileMinMax_v1");
+}
+
+bool
+PlotFileDataImpl::readIndex (int level)
+{
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(m_mf_name[level]+"_MinMax", fileCharPtr, false);
+    if (fileCharPtr.empty()) {
+        return false;
+    }
+    std::istringstream is(std::string(fileCharPtr.dataPtr()), std::istringstream::in);
+
+    std::string version;
+    int ngrids = -1, ncomp = -1;
+    is >> version >> ngrids >> ncomp;
+    if (version != index_version or ngrids != m_ba[level].size() or ncomp != m_ncomp) {
+        return false;
+    }
+    // Only use the values once the whole file has been checked.
+    Vector<Real> gmin(ngrids*m_ncomp), gmax(ngrids*m_ncomp);
+    for (int igrid = 0; igrid < ngrids; ++igrid) {
+        Box bx;
+        is >> bx;
+        if (not is.good() or bx != m_ba[level][igrid]) {
+            return false;
+        }
+        for (int icomp = 0; icomp < m_ncomp; ++icomp) {
+            is >> gmin[igrid*m_ncomp+icomp] >> gmax[igrid*m_ncomp+icomp];
+        }
+    }
+    if (is.fail()) {
+        return false;
+    }
+    m_grid_min[level] = std::move(gmin);
+    m_grid_max[level] = std::move(gmax);
+    return true;
+}
+
+void
+PlotFileDataImpl::writeIndex (int level) const
+{
+    if (not ParallelDescriptor::IOProcessor()) {
+        return;
+    }
+    // Write to a temporary file first, so that readers never see a
+    // partial file.
+    const std::string name = m_mf_name[level]+"_MinMax";
+    const std::string tmpname = name+".tmp";
+    {
+        std::ofstream os(tmpname);
+        if (not os.good()) {
+            amrex::Warning("PlotFileDataImpl: cannot write "+name);
+            return;
+        }
+        os.precision(std::numeric_limits<Real>::max_digits10);
+        const int ngrids = m_ba[level].size();
+        os << index_version << "\n" << ngrids << " " << m_ncomp << "\n";
+        for (int igrid = 0; igrid < ngrids; ++igrid) {
+            os << m_ba[level][igrid];
+            for (int icomp = 0; icomp < m_ncomp; ++icomp) {
+                os << " " << m_grid_min[level][igrid*m_ncomp+icomp]
+                   << " " << m_grid_max[level][igrid*m_ncomp+icomp];
+            }
+            os << "\n";
+        }
+        if (not os.good()) {
+            amrex::Warning("PlotFileDataImpl: cannot write "+name);
+            return;
+        }
+    }
+    if (std::rename(tmpname.c_str(), name.c_str()) != 0) {
+        amrex::Warning("PlotFileDataImpl: cannot write "+name);
     }
-    return mf;
 }
 
 }
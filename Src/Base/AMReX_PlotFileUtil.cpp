@@ -215,6 +215,9 @@ WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
         } else {
             f();
         }
+    } else if (AsyncOut::UseAsyncOut()) {
+        // The writer threads take the jobs in turn, so all processes submit one.
+        AsyncOut::Submit([] () {});
     }
 
     for (int level = 0; level <= finest_level; ++level)
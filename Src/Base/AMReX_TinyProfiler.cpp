@@ -5,7 +5,9 @@
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <numeric>
 #include <set>
+#include <thread>
 
 #include <AMReX_TinyProfiler.H>
 #include <AMReX_ParallelDescriptor.H>
@@ -28,11 +30,16 @@ namespace amrex {
 std::vector<std::string>          TinyProfiler::regionstack;
 std::deque<std::tuple<double,double,std::string*> > TinyProfiler::ttstack;
 std::map<std::string,std::map<std::string, TinyProfiler::Stats> > TinyProfiler::statsmap;
+std::map<std::string,Long> TinyProfiler::counters;
+std::map<std::string,std::pair<Long,double> > TinyProfiler::bgtimes;
 double TinyProfiler::t_init = std::numeric_limits<double>::max();
 
 namespace {
     std::set<std::string> improperly_nested_timers;
     static constexpr char mainregion[] = "main";
+    // As with OpenMP, only one thread is timed, the one that initialized
+    // the profiler, and not, e.g., the threads of readers and writers.
+    std::thread::id main_thread;
 }
 
 TinyProfiler::TinyProfiler (std::string funcname) noexcept
@@ -70,7 +77,7 @@ TinyProfiler::start () noexcept
 #ifdef _OPENMP
 #pragma omp master
 #endif
-    if (stats.empty() && !regionstack.empty())
+    if (std::this_thread::get_id() == main_thread && stats.empty() && !regionstack.empty())
     {
         double t;
 	if (!uCUPTI) {
@@ -248,6 +255,7 @@ TinyProfiler::Initialize () noexcept
 {
     regionstack.push_back(mainregion);
     t_init = amrex::second();
+    main_thread = std::this_thread::get_id();
 }
 
 void
@@ -336,6 +344,9 @@ TinyProfiler::Finalize (bool bFlushing) noexcept
             amrex::Print() << "END REGION " << kv.first << "\n";
         }
     }
+
+    PrintBackgroundTimes();
+    PrintCounters();
 }
 
 void
@@ -535,9 +546,179 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
     }
 }
 
+void
+TinyProfiler::PrintBackgroundTimes ()
+{
+    // make sure the set of names is the same on all processes
+    auto lbgtimes = bgtimes;
+    {
+        Vector<std::string> localStrings, syncedStrings;
+        bool alreadySynced;
+
+        for (auto const& kv : lbgtimes) {
+            localStrings.push_back(kv.first);
+        }
+
+        amrex::SyncStrings(localStrings, syncedStrings, alreadySynced);
+
+        if (! alreadySynced) {
+            for (auto const& s : syncedStrings) {
+                lbgtimes.insert(std::make_pair(s, std::make_pair(0L, 0.0)));
+            }
+        }
+    }
+
+    if (lbgtimes.empty()) return;
+
+    int nprocs = ParallelDescriptor::NProcs();
+    int ioproc = ParallelDescriptor::IOProcessorNumber();
+
+    std::vector<std::tuple<std::string,Long,double,double,double> > alltimes;
+    int maxnamelen = std::string("Background").size();
+    Long maxncalls = 0;
+
+    for (auto const& kv : lbgtimes)
+    {
+        Long n = kv.second.first;
+        double dt = kv.second.second;
+        std::vector<Long> ns(nprocs);
+        std::vector<double> dts(nprocs);
+        if (nprocs == 1) {
+            ns[0] = n;
+            dts[0] = dt;
+        } else {
+            ParallelDescriptor::Gather(&n, 1, &ns[0], 1, ioproc);
+            ParallelDescriptor::Gather(&dt, 1, &dts[0], 1, ioproc);
+        }
+
+        if (ParallelDescriptor::IOProcessor()) {
+            Long navg = std::accumulate(ns.begin(), ns.end(), 0L) / nprocs;
+            double dtmin = *std::min_element(dts.begin(), dts.end());
+            double dtmax = *std::max_element(dts.begin(), dts.end());
+            double dtavg = std::accumulate(dts.begin(), dts.end(), 0.0) / nprocs;
+            alltimes.emplace_back(kv.first, navg, dtmin, dtavg, dtmax);
+            maxnamelen = std::max(maxnamelen, int(kv.first.size()));
+            maxncalls = std::max(maxncalls, navg);
+        }
+    }
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        amrex::OutStream() << std::setfill(' ') << std::setprecision(4);
+        int wt = 9;
+        int wnc = std::to_string(maxncalls).size();
+        wnc = std::max(wnc, int(std::string("NCalls").size()));
+
+        const std::string hline(maxnamelen+wnc+2+(wt+2)*3,'-');
+        amrex::OutStream() << "\n" << hline << "\n";
+        amrex::OutStream() << std::left
+                           << std::setw(maxnamelen) << "Background"
+                           << std::right
+                           << std::setw(wnc+2) << "NCalls"
+                           << std::setw(wt+2) << "Min"
+                           << std::setw(wt+2) << "Avg"
+                           << std::setw(wt+2) << "Max"
+                           << "\n" << hline << "\n";
+        for (auto const& t : alltimes)
+        {
+            amrex::OutStream() << std::left
+                               << std::setw(maxnamelen) << std::get<0>(t)
+                               << std::right
+                               << std::setw(wnc+2) << std::get<1>(t)
+                               << std::setw(wt+2) << std::get<2>(t)
+                               << std::setw(wt+2) << std::get<3>(t)
+                               << std::setw(wt+2) << std::get<4>(t)
+                               << "\n";
+        }
+        amrex::OutStream() << hline << "\n";
+        amrex::OutStream() << std::endl;
+    }
+}
+
+void
+TinyProfiler::PrintCounters ()
+{
+    // make sure the set of counters is the same on all processes
+    auto lcounters = counters;
+    {
+        Vector<std::string> localStrings, syncedStrings;
+        bool alreadySynced;
+
+        for (auto const& kv : lcounters) {
+            localStrings.push_back(kv.first);
+        }
+
+        amrex::SyncStrings(localStrings, syncedStrings, alreadySynced);
+
+        if (! alreadySynced) {
+            for (auto const& s : syncedStrings) {
+                lcounters.insert(std::make_pair(s, 0L));
+            }
+        }
+    }
+
+    if (lcounters.empty()) return;
+
+    int nprocs = ParallelDescriptor::NProcs();
+    int ioproc = ParallelDescriptor::IOProcessorNumber();
+
+    std::vector<std::tuple<std::string,Long,Long,Long> > allcounters;
+    int maxnamelen = std::string("Counter").size();
+    Long maxn = 0;
+
+    for (auto const& kv : lcounters)
+    {
+        Long n = kv.second;
+        std::vector<Long> ns(nprocs);
+        if (nprocs == 1) {
+            ns[0] = n;
+        } else {
+            ParallelDescriptor::Gather(&n, 1, &ns[0], 1, ioproc);
+        }
+
+        if (ParallelDescriptor::IOProcessor()) {
+            Long nmin = *std::min_element(ns.begin(), ns.end());
+            Long nmax = *std::max_element(ns.begin(), ns.end());
+            Long navg = std::accumulate(ns.begin(), ns.end(), 0L) / nprocs;
+            allcounters.emplace_back(kv.first, nmin, navg, nmax);
+            maxnamelen = std::max(maxnamelen, int(kv.first.size()));
+            maxn = std::max(maxn, nmax);
+        }
+    }
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        int wn = std::to_string(maxn).size();
+        wn = std::max(wn, int(std::string("Max").size()));
+
+        const std::string hline(maxnamelen+(wn+2)*3,'-');
+        amrex::OutStream() << "\n" << hline << "\n";
+        amrex::OutStream() << std::left
+                           << std::setw(maxnamelen) << "Counter"
+                           << std::right
+                           << std::setw(wn+2) << "Min"
+                           << std::setw(wn+2) << "Avg"
+                           << std::setw(wn+2) << "Max"
+                           << "\n" << hline << "\n";
+        for (auto const& c : allcounters)
+        {
+            amrex::OutStream() << std::left
+                               << std::setw(maxnamelen) << std::get<0>(c)
+                               << std::right
+                               << std::setw(wn+2) << std::get<1>(c)
+                               << std::setw(wn+2) << std::get<2>(c)
+                               << std::setw(wn+2) << std::get<3>(c)
+                               << "\n";
+        }
+        amrex::OutStream() << hline << "\n";
+        amrex::OutStream() << std::endl;
+    }
+}
+
 void
 TinyProfiler::StartRegion (std::string regname) noexcept
 {
+    if (std::this_thread::get_id() != main_thread) return;
     if (std::find(regionstack.begin(), regionstack.end(), regname) == regionstack.end()) {
         regionstack.emplace_back(std::move(regname));
     }
@@ -546,11 +727,28 @@ TinyProfiler::StartRegion (std::string regname) noexcept
 void
 TinyProfiler::StopRegion (const std::string& regname) noexcept
 {
+    if (std::this_thread::get_id() != main_thread) return;
     if (regname == regionstack.back()) {
         regionstack.pop_back();
     }
 }
 
+void
+TinyProfiler::AddTime (const std::string& fname, Long ncalls, double dt) noexcept
+{
+    if (std::this_thread::get_id() != main_thread or regionstack.empty()) return;
+    auto& t = bgtimes[fname];
+    t.first += ncalls;
+    t.second += dt;
+}
+
+void
+TinyProfiler::AddCounter (const std::string& name, Long n) noexcept
+{
+    if (std::this_thread::get_id() != main_thread or regionstack.empty()) return;
+    counters[name] += n;
+}
+
 TinyProfileRegion::TinyProfileRegion (std::string a_regname) noexcept
     : regname(std::move(a_regname)),
       tprof(std::string("REG::")+regname, false, false)
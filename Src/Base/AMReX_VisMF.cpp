@@ -6,10 +6,15 @@
 #include <cerrno>
 #include <atomic>
 #include <cstdio>
+#include <cstring>
+#include <algorithm>
 #include <limits>
 #include <array>
 #include <memory>
 #include <numeric>
+#include <functional>
+#include <thread>
+#include <mutex>
 
 #include <AMReX_ccse-mpi.H>
 #include <AMReX_Utility.H>
@@ -19,6 +24,14 @@
 #include <AMReX_FPC.H>
 #include <AMReX_FabArrayUtility.H>
 #include <AMReX_AsyncOut.H>
+#include <AMReX_Compression.H>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace amrex {
 
@@ -39,6 +52,9 @@ bool VisMF::usePersistentIFStreams(false);
 bool VisMF::useSynchronousReads(false);
 bool VisMF::useDynamicSetSelection(true);
 bool VisMF::allowSparseWrites(true);
+Real VisMF::compressionTolerance(0.0);
+Long VisMF::compressionBlockSize(32768);
+int  VisMF::compressionThreads(0);
 
 Long VisMF::ioBufferSize(VisMF::IO_Buffer_Size);
 
@@ -51,6 +67,39 @@ int VisMF::nMFFileInStreams(4);
 namespace
 {
     bool initialized = false;
+
+    //
+    // readFABRegion falls back on the persistent streams, which are shared.
+    //
+    std::mutex fallbackReadMutex;
+
+    //
+    // Run f(0) ... f(ntasks-1) on up to nthreads threads.
+    //
+    void RunOnThreads (int ntasks, int nthreads, const std::function<void(int)> &f)
+    {
+        nthreads = std::min(nthreads, ntasks);
+        if(nthreads <= 1) {
+            for(int i(0); i < ntasks; ++i) {
+                f(i);
+            }
+            return;
+        }
+        std::atomic<int> next(0);
+        auto worker = [&] () {
+            for(int i(next++); i < ntasks; i = next++) {
+                f(i);
+            }
+        };
+        Vector<std::thread> threads;
+        for(int t(1); t < nthreads; ++t) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for(auto &t : threads) {
+            t.join();
+        }
+    }
 }
 
 void
@@ -87,6 +136,13 @@ VisMF::Initialize ()
     pp.query("usedynamicsetselection", useDynamicSetSelection);
     pp.query("iobuffersize", ioBufferSize);
     pp.query("allowsparsewrites", allowSparseWrites);
+    pp.query("compressiontolerance", compressionTolerance);
+    pp.query("compressionblocksize", compressionBlockSize);
+    BL_ASSERT(compressionTolerance >= 0.0 && compressionBlockSize > 0);
+
+    // ---- by default, the cores of a node are shared among its processes,
+    // ---- see CompressionThreads
+    pp.query("compressionthreads", compressionThreads);
 
     initialized = true;
 }
@@ -97,6 +153,32 @@ VisMF::Finalize ()
     initialized = false;
 }
 
+int
+VisMF::CompressionThreads (bool collective)
+{
+    if(compressionThreads <= 0) {
+      // ---- share the cores of a node among its processes.  Finding the
+      // ---- number of processes on the node is collective, so it is not
+      // ---- done until the first collective Write or Read of compressed data.
+      int nProcsOnNode(1);
+      if(ParallelDescriptor::NProcs() > 1) {
+        if( ! collective) {
+          return 1;
+        }
+#ifdef BL_USE_MPI
+        MPI_Comm nodeComm;
+        MPI_Comm_split_type(ParallelDescriptor::Communicator(), MPI_COMM_TYPE_SHARED, 0,
+                            MPI_INFO_NULL, &nodeComm);
+        MPI_Comm_size(nodeComm, &nProcsOnNode);
+        MPI_Comm_free(&nodeComm);
+#endif
+      }
+      int nCores(std::thread::hardware_concurrency());
+      compressionThreads = std::max(1, nCores / nProcsOnNode);
+    }
+    return compressionThreads;
+}
+
 void
 VisMF::SetNOutFiles (int noutfiles, MPI_Comm comm)
 {
@@ -284,8 +366,9 @@ operator<< (std::ostream        &os,
 
     os << hd.m_fod      << '\n';
 
-    if(hd.m_vers == VisMF::Header::Version_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1)
+    if(hd.m_vers == VisMF::Header::Version_v1           ||
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       os << hd.m_min      << '\n';
       os << hd.m_max      << '\n';
@@ -304,9 +387,10 @@ operator<< (std::ostream        &os,
       os << '\n';
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+    if(hd.m_vers == VisMF::Header::NoFabHeader_v1         ||
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1   ||
+       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
         os << FPC::NativeRealDescriptor() << '\n';
@@ -317,6 +401,15 @@ operator<< (std::ostream        &os,
       }
     }
 
+    if(hd.m_vers == VisMF::Header::Compressed_v1) {
+      BL_ASSERT(hd.m_tolerance.size() == hd.m_ncomp);
+      os << hd.m_blocksize << '\n';
+      for(int i(0); i < hd.m_tolerance.size(); ++i) {
+        os << hd.m_tolerance[i] << ',';
+      }
+      os << '\n';
+    }
+
     os.flags(oflags);
     os.precision(oldPrec);
 
@@ -368,13 +461,24 @@ operator>> (std::istream  &is,
     is >> hd.m_fod;
     BL_ASSERT(hd.m_ba.size() == hd.m_fod.size());
 
-    if(hd.m_vers == VisMF::Header::Version_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1)
+    if(hd.m_vers == VisMF::Header::Version_v1           ||
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       is >> hd.m_min;
       is >> hd.m_max;
       BL_ASSERT(hd.m_ba.size() == hd.m_min.size());
       BL_ASSERT(hd.m_ba.size() == hd.m_max.size());
+
+      // ---- the FabArray min and max follow from those of the fabs
+      hd.m_famin.resize(hd.m_ncomp,  std::numeric_limits<Real>::max());
+      hd.m_famax.resize(hd.m_ncomp, -std::numeric_limits<Real>::max());
+      for(int i(0); i < hd.m_min.size(); ++i) {
+        for(int comp(0); comp < hd.m_min[i].size(); ++comp) {
+          hd.m_famin[comp] = std::min(hd.m_famin[comp], hd.m_min[i][comp]);
+          hd.m_famax[comp] = std::max(hd.m_famax[comp], hd.m_max[i][comp]);
+        }
+      }
     }
 
     if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
@@ -394,12 +498,24 @@ operator>> (std::istream  &is,
 	}
       }
     }
-    if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+    if(hd.m_vers == VisMF::Header::NoFabHeader_v1         ||
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1   ||
+       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       is >> hd.m_writtenRD;
     }
+    if(hd.m_vers == VisMF::Header::Compressed_v1) {
+      char ch;
+      is >> hd.m_blocksize;
+      hd.m_tolerance.resize(hd.m_ncomp);
+      for(int i(0); i < hd.m_tolerance.size(); ++i) {
+        is >> hd.m_tolerance[i] >> ch;
+	if( ch != ',' ) {
+	  amrex::Error("Expected a ',' when reading hd.m_tolerance");
+	}
+      }
+    }
 
 
     if( ! is.good()) {
@@ -514,6 +630,18 @@ VisMF::max (int nc) const
     return m_hdr.m_famax[nc];
 }
 
+Real
+VisMF::tolerance (int nc) const
+{
+    BL_ASSERT(0 <= nc && nc < m_hdr.m_ncomp);
+
+    if(m_hdr.m_tolerance.size() == 0) {  // ---- not a compressed version
+        return 0.0;
+    }
+
+    return m_hdr.m_tolerance[nc];
+}
+
 const FArrayBox&
 VisMF::GetFab (int fabIndex,
                int ncomp) const
@@ -1019,12 +1147,49 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 
     bool oldHeader(currentVersion == VisMF::Header::Version_v1);
 
+    // ---- compress before waiting for our turn to write
+    bool compressed(currentVersion == VisMF::Header::Compressed_v1);
+    Vector< Vector<char> > compressedFabs;
+    if(compressed) {
+      hdr.m_blocksize = compressionBlockSize;
+      hdr.m_tolerance.resize(mf.nComp(), 0.0);
+      if(compressionTolerance > 0.0) {
+        Vector<Real> famin(mf.nComp(),  std::numeric_limits<Real>::max());
+        Vector<Real> famax(mf.nComp(), -std::numeric_limits<Real>::max());
+        for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+          for(int j(0); j < mf.nComp(); ++j) {
+            famin[j] = std::min(famin[j], mf[mfi].min<RunOn::Host>(mfi.validbox(), j));
+            famax[j] = std::max(famax[j], mf[mfi].max<RunOn::Host>(mfi.validbox(), j));
+          }
+        }
+        ParallelAllReduce::Min(famin.dataPtr(), famin.size(), ParallelDescriptor::Communicator());
+        ParallelAllReduce::Max(famax.dataPtr(), famax.size(), ParallelDescriptor::Communicator());
+        for(int j(0); j < mf.nComp(); ++j) {
+          if(famax[j] > famin[j]) {
+            hdr.m_tolerance[j] = compressionTolerance * (famax[j] - famin[j]);
+          }
+        }
+      }
+      CompressionThreads(true);
+      VisMF::CompressFabs(mf, hdr, *whichRD, compressedFabs);
+    }
+
     if(useSparseFPP) {
         nfi.SetSparseFPP(procsWithDataVector);
     } else if(useDynamicSetSelection) {
         nfi.SetDynamic();
     }
     for( ; nfi.ReadyToWrite(); ++nfi) {
+        if(compressed) {
+            for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                const Vector<char> &cfab = compressedFabs[mfi.LocalIndex()];
+                nfi.Stream().write(cfab.dataPtr(), cfab.size());
+                bytesWritten += cfab.size();
+            }
+            nfi.Stream().flush();
+            continue;
+        }
+
         // ---- find the total number of bytes including fab headers if needed
         const FABio &fio = FArrayBox::getFABio();
         int whichRDBytes(whichRD->numBytes()), nFABs(0);
@@ -1116,14 +1281,25 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
         amrex::prefetchToDevice(mf);  // CalculateMinMax might do work on device
     }
 
-    if(currentVersion == VisMF::Header::Version_v1 ||
-       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1)
+    if(currentVersion == VisMF::Header::Version_v1           ||
+       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       currentVersion == VisMF::Header::Compressed_v1)
     {
         hdr.CalculateMinMax(mf, coordinatorProc);
     }
 
+    Vector<Long> fabBytes;
+    if(compressed) {
+        fabBytes.resize(mf.size(), 0);
+        for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            fabBytes[mfi.index()] = compressedFabs[mfi.LocalIndex()].size();
+        }
+        ParallelAllReduce::Sum(fabBytes.dataPtr(), fabBytes.size(),
+                               ParallelDescriptor::Communicator());
+    }
+
     VisMF::FindOffsets(mf, filePrefix, hdr, currentVersion, nfi,
-                       ParallelDescriptor::Communicator());
+                       ParallelDescriptor::Communicator(), fabBytes);
 
     bytesWritten += VisMF::WriteHeader(mf_name, hdr, coordinatorProc);
 
@@ -1172,7 +1348,8 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 		    const std::string &filePrefix,
                     VisMF::Header &hdr,
 		    VisMF::Header::Version /*whichVersion*/,
-		    NFilesIter &nfi, MPI_Comm comm)
+		    NFilesIter &nfi, MPI_Comm comm,
+                    const Vector<Long> &fabBytes)
 {
 //    BL_PROFILE("VisMF::FindOffsets");
 
@@ -1321,8 +1498,12 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 	      for(int i(0); i < index.size(); ++i) {
                  hdr.m_fod[index[i]].m_name = whichFileName;
                  hdr.m_fod[index[i]].m_head = currentOffset[whichFileNumber];
-                 currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
-	                                           + fabHeaderBytes[index[i]];
+                 if(fabBytes.empty()) {
+                   currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
+	                                             + fabHeaderBytes[index[i]];
+                 } else {
+                   currentOffset[whichFileNumber] += fabBytes[index[i]];
+                 }
               }
             }
 	  }
@@ -1333,6 +1514,122 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 }
 
 
+void
+VisMF::CompressFabs (const FabArray<FArrayBox> &mf, const VisMF::Header &hdr,
+                     const RealDescriptor &rd, Vector< Vector<char> > &cfabs)
+{
+    BL_PROFILE("VisMF::CompressFabs");
+
+    struct Block {
+        int  localIndex;
+        int  comp;
+        Long first;
+        Long n;
+    };
+
+    const int nComp(mf.nComp());
+    const Long blockSize(hdr.m_blocksize);
+    const int nLocal(mf.local_size());
+
+    Vector<Block> blocks;
+    Vector<int> firstBlock(nLocal + 1, 0);
+    for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const Long npts(mfi.fabbox().numPts());
+        firstBlock[mfi.LocalIndex()] = blocks.size();
+        for(int comp(0); comp < nComp; ++comp) {
+            for(Long first(0); first < npts; first += blockSize) {
+                blocks.push_back({mfi.LocalIndex(), comp, first, std::min(blockSize, npts - first)});
+            }
+        }
+    }
+    firstBlock[nLocal] = blocks.size();
+
+    Vector< Vector<char> > blockData(blocks.size());
+    RunOnThreads(blocks.size(), CompressionThreads(false), [&] (int ib)
+    {
+        const Block &b = blocks[ib];
+        const FArrayBox &fab = mf[mf.IndexArray()[b.localIndex]];
+        Compression::CompressBlock(fab.dataPtr(b.comp) + b.first, b.n, rd,
+                                   hdr.m_tolerance[b.comp], blockData[ib]);
+    });
+
+    // ---- each fab is a table of the block sizes, as little-endian 64-bit
+    // ---- integers, followed by the blocks
+    cfabs.resize(nLocal);
+    for(int li(0); li < nLocal; ++li) {
+        const Long tableBytes((firstBlock[li+1] - firstBlock[li]) * 8);
+        Long totalBytes(0);
+        for(int ib(firstBlock[li]); ib < firstBlock[li+1]; ++ib) {
+            totalBytes += blockData[ib].size();
+        }
+        Vector<char> &cfab = cfabs[li];
+        cfab.resize(tableBytes + totalBytes);
+        for(int ib(firstBlock[li]); ib < firstBlock[li+1]; ++ib) {
+            Compression::PutInt64(blockData[ib].size(), cfab.dataPtr() + (ib - firstBlock[li]) * 8);
+        }
+        Long pos(tableBytes);
+        for(int ib(firstBlock[li]); ib < firstBlock[li+1]; ++ib) {
+            std::memcpy(cfab.dataPtr() + pos, blockData[ib].dataPtr(), blockData[ib].size());
+            pos += blockData[ib].size();
+            Vector<char>().swap(blockData[ib]);
+        }
+    }
+}
+
+
+void
+VisMF::readCompressedFAB (FArrayBox &fab, std::istream &is,
+                          const VisMF::Header &hdr, int whichComp)
+{
+    const Long npts(fab.box().numPts());
+    const Long blockSize(hdr.m_blocksize);
+    const Long nBlocksPerComp((npts + blockSize - 1) / blockSize);
+
+    Vector<Long> blockBytes(hdr.m_ncomp * nBlocksPerComp);
+    {
+        Vector<char> table(blockBytes.size() * 8);
+        is.read(table.dataPtr(), table.size());
+        for(int ib(0); ib < blockBytes.size(); ++ib) {
+            blockBytes[ib] = Compression::GetInt64(table.dataPtr() + ib * 8);
+        }
+    }
+
+    const int compLo(whichComp < 0 ? 0 : whichComp);
+    const int nComp(whichComp < 0 ? hdr.m_ncomp : 1);
+    BL_ASSERT(fab.nComp() >= nComp);
+    const int firstBlock(compLo * nBlocksPerComp);
+    const int nBlocks(nComp * nBlocksPerComp);
+
+    Vector<Long> blockOffset(nBlocks + 1, 0);
+    for(int ib(0); ib < nBlocks; ++ib) {
+        blockOffset[ib+1] = blockOffset[ib] + blockBytes[firstBlock + ib];
+    }
+    Long skipBytes(0);
+    for(int ib(0); ib < firstBlock; ++ib) {
+        skipBytes += blockBytes[ib];
+    }
+    if(skipBytes > 0) {
+        is.seekg(skipBytes, std::ios::cur);
+    }
+
+    Vector<char> data(blockOffset[nBlocks]);
+    is.read(data.dataPtr(), data.size());
+    if( ! is.good()) {
+        amrex::Error("VisMF::readCompressedFAB:  read failed");
+    }
+
+    RunOnThreads(nBlocks, CompressionThreads(false), [&] (int ib)
+    {
+        const int comp(ib / nBlocksPerComp);
+        const Long first((ib % nBlocksPerComp) * blockSize);
+        Compression::DecompressBlock(data.dataPtr() + blockOffset[ib],
+                                     blockOffset[ib+1] - blockOffset[ib],
+                                     fab.dataPtr(comp) + first,
+                                     std::min(blockSize, npts - first), hdr.m_writtenRD);
+    });
+}
+
+
 void
 VisMF::RemoveFiles(const std::string &mf_name, bool a_verbose)
 {
@@ -1392,11 +1689,239 @@ VisMF::VisMF (const std::string &fafab_name)
 }
 
 
+//
+// A data file mapped into memory.  The pages are read from the file
+// system only when they are touched.  If the file cannot be mapped, the
+// bytes are read with an ifstream instead.
+//
+struct VisMF::MappedFile
+{
+    explicit MappedFile (const std::string &fileName);
+    ~MappedFile ();
+    MappedFile (const MappedFile&) = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+
+    //! Copy nbytes starting at offset into dst.
+    void read (Long offset, Long nbytes, char *dst);
+    //! The text from offset up to the next newline.
+    std::string readLine (Long offset);
+
+    std::string   m_name;
+    const char   *m_data;
+    Long          m_size;
+    std::ifstream m_ifs;
+    std::mutex    m_ifsMutex;
+};
+
+VisMF::MappedFile::MappedFile (const std::string &fileName)
+    :
+    m_name(fileName),
+    m_data(nullptr),
+    m_size(0)
+{
+#ifndef _WIN32
+    int fd(::open(fileName.c_str(), O_RDONLY));
+    if(fd >= 0) {
+        struct stat st;
+        if(::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *p(::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0));
+            if(p != MAP_FAILED) {
+                m_data = static_cast<const char *>(p);
+                m_size = st.st_size;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+    if(m_data == nullptr) {
+        m_ifs.open(fileName.c_str(), std::ios::in | std::ios::binary);
+        if( ! m_ifs.good()) {
+            amrex::FileOpenFailed(fileName);
+        }
+    }
+}
+
+VisMF::MappedFile::~MappedFile ()
+{
+#ifndef _WIN32
+    if(m_data != nullptr) {
+        ::munmap(const_cast<char *>(m_data), m_size);
+    }
+#endif
+}
+
+void
+VisMF::MappedFile::read (Long offset, Long nbytes, char *dst)
+{
+    if(m_data != nullptr) {
+        if(offset < 0 || offset + nbytes > m_size) {
+            amrex::Error("VisMF::MappedFile::read:  past the end of " + m_name);
+        }
+        std::memcpy(dst, m_data + offset, nbytes);
+    } else {
+        std::lock_guard<std::mutex> lock(m_ifsMutex);
+        m_ifs.seekg(offset, std::ios::beg);
+        m_ifs.read(dst, nbytes);
+        if( ! m_ifs.good()) {
+            amrex::Error("VisMF::MappedFile::read:  read failed for " + m_name);
+        }
+    }
+}
+
+std::string
+VisMF::MappedFile::readLine (Long offset)
+{
+    std::string line;
+    if(m_data != nullptr) {
+        const char *p(m_data + offset), *end(m_data + m_size);
+        const char *nl(std::find(p, end, '\n'));
+        line.assign(p, nl);
+    } else {
+        std::lock_guard<std::mutex> lock(m_ifsMutex);
+        m_ifs.seekg(offset, std::ios::beg);
+        std::getline(m_ifs, line);
+    }
+    return line;
+}
+
+
 VisMF::~VisMF ()
 {
 }
 
 
+VisMF::MappedFile&
+VisMF::mappedFile (int fabIndex) const
+{
+    std::string FullName(VisMF::DirName(m_fafabname));
+    FullName += m_hdr.m_fod[fabIndex].m_name;
+
+    std::lock_guard<std::mutex> lock(m_mappedFilesMutex);
+    auto it = m_mappedFiles.find(FullName);
+    if(it == m_mappedFiles.end()) {
+        it = m_mappedFiles.emplace(FullName, std::unique_ptr<MappedFile>(new MappedFile(FullName))).first;
+    }
+    return *(it->second);
+}
+
+
+void
+VisMF::readFABRegion (FArrayBox &dest, const Box &bx, int fabIndex,
+                      int srccomp, int destcomp, int numcomp) const
+{
+    BL_PROFILE("VisMF::readFABRegion()");
+    BL_ASSERT(0 <= fabIndex && fabIndex < m_hdr.m_ba.size());
+    BL_ASSERT(srccomp >= 0 && srccomp + numcomp <= m_hdr.m_ncomp);
+    BL_ASSERT(destcomp >= 0 && destcomp + numcomp <= dest.nComp());
+
+    Box fab_box(m_hdr.m_ba[fabIndex]);
+    if(m_hdr.m_ngrow.max() > 0) {
+        fab_box.grow(m_hdr.m_ngrow);
+    }
+    const Box region(bx & fab_box & dest.box());
+    if( ! region.ok()) {
+        return;
+    }
+
+    MappedFile &mfile = mappedFile(fabIndex);
+    Long head(m_hdr.m_fod[fabIndex].m_head);
+    const Long npts(fab_box.numPts());
+
+    RealDescriptor rd;
+    bool canMap(true);
+    if(m_hdr.m_vers == Header::Version_v1) {
+        // ---- skip the fab header, "FAB " RealDescriptor box ncomp '\n'
+        std::string line(mfile.readLine(head));
+        std::istringstream is(line);
+        std::string fab;
+        Box diskBox;
+        int nvar(-1);
+        is >> fab;
+        if(fab == "FAB") {
+            is >> rd >> diskBox >> nvar;
+        }
+        if(fab != "FAB" || ! is || diskBox != fab_box) {
+            canMap = false;    // ---- an old or ascii fab format
+        }
+        head += line.size() + 1;
+    } else if(NoFabHeader(m_hdr)) {
+        rd = m_hdr.m_writtenRD;
+    } else {
+        canMap = false;
+    }
+
+    if( ! canMap) {
+        std::lock_guard<std::mutex> lock(fallbackReadMutex);
+        for(int n(0); n < numcomp; ++n) {
+            std::unique_ptr<FArrayBox> fab(VisMF::readFAB(fabIndex, m_fafabname, m_hdr, srccomp + n));
+            dest.copy<RunOn::Host>(*fab, region, 0, region, destcomp + n, 1);
+        }
+        return;
+    }
+
+    // ---- the region is read one row (in the first direction) at a time
+    Box rows(region);
+    rows.setBig(0, region.smallEnd(0));
+    const Long rowLength(region.length(0));
+
+    if(m_hdr.m_vers == Header::Compressed_v1) {
+        const Long blockSize(m_hdr.m_blocksize);
+        const Long nBlocksPerComp((npts + blockSize - 1) / blockSize);
+        Vector<Long> blockBytes(m_hdr.m_ncomp * nBlocksPerComp);
+        Vector<char> table(blockBytes.size() * 8);
+        mfile.read(head, table.size(), table.dataPtr());
+        for(int ib(0); ib < blockBytes.size(); ++ib) {
+            blockBytes[ib] = Compression::GetInt64(table.dataPtr() + ib * 8);
+        }
+        Vector<Long> blockOffset(blockBytes.size(), head + table.size());
+        for(int ib(1); ib < blockBytes.size(); ++ib) {
+            blockOffset[ib] = blockOffset[ib-1] + blockBytes[ib-1];
+        }
+
+        // ---- decompress only the blocks containing the region
+        const Long firstBlock(fab_box.index(region.smallEnd()) / blockSize);
+        const Long lastBlock(fab_box.index(region.bigEnd()) / blockSize);
+        Vector<Real> values((lastBlock - firstBlock + 1) * blockSize);
+        Vector<char> cdata;
+        for(int n(0); n < numcomp; ++n) {
+            for(Long b(firstBlock); b <= lastBlock; ++b) {
+                const Long ib((srccomp + n) * nBlocksPerComp + b);
+                cdata.resize(blockBytes[ib]);
+                mfile.read(blockOffset[ib], blockBytes[ib], cdata.dataPtr());
+                Compression::DecompressBlock(cdata.dataPtr(), cdata.size(),
+                                             values.dataPtr() + (b - firstBlock) * blockSize,
+                                             std::min(blockSize, npts - b * blockSize),
+                                             m_hdr.m_writtenRD);
+            }
+            Real *dptr(dest.dataPtr(destcomp + n));
+            for(IntVect iv(rows.smallEnd()); iv <= rows.bigEnd(); rows.next(iv)) {
+                std::memcpy(dptr + dest.box().index(iv),
+                            values.dataPtr() + fab_box.index(iv) - firstBlock * blockSize,
+                            rowLength * sizeof(Real));
+            }
+        }
+    } else {
+        const int rdBytes(rd.numBytes());
+        const bool isNative(rd == FPC::NativeRealDescriptor());
+        Vector<char> rowData(isNative ? 0 : rowLength * rdBytes);
+        for(int n(0); n < numcomp; ++n) {
+            const Long compHead(head + (srccomp + n) * npts * rdBytes);
+            Real *dptr(dest.dataPtr(destcomp + n));
+            for(IntVect iv(rows.smallEnd()); iv <= rows.bigEnd(); rows.next(iv)) {
+                const Long offset(compHead + fab_box.index(iv) * rdBytes);
+                Real *d(dptr + dest.box().index(iv));
+                if(isNative) {
+                    mfile.read(offset, rowLength * rdBytes, (char *) d);
+                } else {
+                    mfile.read(offset, rowLength * rdBytes, rowData.dataPtr());
+                    RealDescriptor::convertToNativeFormat(d, rowLength, rowData.dataPtr(), rd);
+                }
+            }
+        }
+    }
+}
+
+
 FArrayBox*
 VisMF::readFAB (int                  idx,
                 const std::string   &mf_name,
@@ -1417,7 +1942,9 @@ VisMF::readFAB (int                  idx,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(hdr.m_vers == Header::Version_v1) {
+    if(hdr.m_vers == Header::Compressed_v1) {
+      VisMF::readCompressedFAB(*fab, *infs, hdr, whichComp);
+    } else if(hdr.m_vers == Header::Version_v1) {
       if(whichComp == -1) {    // ---- read all components
         fab->readFrom(*infs);
       } else {
@@ -1467,7 +1994,9 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(NoFabHeader(hdr)) {
+    if(hdr.m_vers == Header::Compressed_v1) {
+      VisMF::readCompressedFAB(fab, *infs, hdr);
+    } else if(NoFabHeader(hdr)) {
       if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
         infs->read((char *) fab.dataPtr(), fab.nBytes());
       } else {
@@ -1542,14 +2071,20 @@ VisMF::Read (FabArray<FArrayBox> &mf,
 	BL_ASSERT(amrex::match(hdr.m_ba,mf.boxArray()));
     }
 
+    if(hdr.m_vers == VisMF::Header::Compressed_v1) {
+      CompressionThreads(true);
+    }
+
 #ifdef BL_USE_MPI
 
   // ---- This limits the number of concurrent readers per file.
   int nOpensPerFile(nMFFileInStreams);
   int nProcs(ParallelDescriptor::NProcs());
   bool noFabHeader(NoFabHeader(hdr));
+  // ---- compressed fabs do not have a fixed size
+  bool fixedFabSizes(hdr.m_vers != VisMF::Header::Compressed_v1);
 
-  if(noFabHeader && useSynchronousReads) {
+  if(noFabHeader && fixedFabSizes && useSynchronousReads) {
 
     // ---- This code is only for reading in file order
     bool doConvert(hdr.m_writtenRD != FPC::NativeRealDescriptor());
@@ -1753,7 +2288,7 @@ VisMF::Read (FabArray<FArrayBox> &mf,
       faCopyTime = amrex::second() - faCopyTime;
     }
 
-  } else {    // ---- (noFabHeader && useSynchronousReads) == false
+  } else {    // ---- (noFabHeader && fixedFabSizes && useSynchronousReads) == false
 
     int nReqs(0), ioProcNum(coordinatorProc);
     int nBoxes(hdr.m_ba.size());
@@ -2094,9 +2629,10 @@ VisMF::clear ()
 
 
 bool VisMF::NoFabHeader(const VisMF::Header &hdr) {
-  if(hdr.m_vers == VisMF::Header::NoFabHeader_v1       ||
-    hdr.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-    hdr.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+  if(hdr.m_vers == VisMF::Header::NoFabHeader_v1         ||
+    hdr.m_vers == VisMF::Header::NoFabHeaderMinMax_v1   ||
+    hdr.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+    hdr.m_vers == VisMF::Header::Compressed_v1)
   {
     return true;
   }
@@ -2180,7 +2716,8 @@ void VisMF::CloseAllStreams() {
 void
 VisMF::AsyncWrite (const FabArray<FArrayBox>& mf, const std::string& mf_name, bool valid_cells_only)
 {
-    if (AsyncOut::UseAsyncOut()) {
+    // ---- the asynchronous writer does not compress
+    if (AsyncOut::UseAsyncOut() && currentVersion != Header::Compressed_v1) {
         AsyncWriteDoit(mf, mf_name, false, valid_cells_only);
     } else {
         if (valid_cells_only and mf.nGrowVect() != 0) {
@@ -2196,7 +2733,8 @@ VisMF::AsyncWrite (const FabArray<FArrayBox>& mf, const std::string& mf_name, bo
 void
 VisMF::AsyncWrite (FabArray<FArrayBox>&& mf, const std::string& mf_name, bool valid_cells_only)
 {
-    if (AsyncOut::UseAsyncOut()) {
+    // ---- the asynchronous writer does not compress
+    if (AsyncOut::UseAsyncOut() && currentVersion != Header::Compressed_v1) {
         AsyncWriteDoit(mf, mf_name, true, valid_cells_only);
     } else {
         if (valid_cells_only and mf.nGrowVect() != 0) {
@@ -2227,6 +2765,10 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
 
     RealDescriptor const& whichRD = FPC::NativeRealDescriptor();
 
+    if (currentVersion == Header::Compressed_v1) {
+        amrex::Abort("VisMF::AsyncWriteDoit:  the Compressed_v1 header version is not supported");
+    }
+    // ---- the FABs are written with their headers, as for Version_v1
     auto hdr = std::make_shared<VisMF::Header>(mf, VisMF::NFiles, VisMF::Header::Version_v1, false);
 
     constexpr int sizeof_int64_over_real = sizeof(int64_t) / sizeof(Real);
@@ -2311,6 +2853,13 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
     }
 #endif
 
+    Long nbytes_copied = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        Box bx = strip_ghost ? mfi.validbox() : mfi.fabbox();
+        nbytes_copied += bx.numPts() * ncomp * sizeof(Real);
+    }
+    AsyncOut::Reserve(nbytes_copied);
+
     auto myfabs = std::make_shared<Vector<FArrayBox> >();
     for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
         Box bx = strip_ghost ? mfi.validbox() : mfi.fabbox();
@@ -2439,7 +2988,7 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
         ofs.close();
 
         AsyncOut::Notify();  // Notify others I am done
-    });
+    }, nbytes_copied);
 }
 
 }
@@ -0,0 +1,159 @@
+
+#include <AMReX_SWFFTPoisson.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_ParallelReduce.H>
+
+#include <Distribution.H>
+#include <Dfft.H>
+
+#include <algorithm>
+#include <cmath>
+
+namespace amrex {
+
+SWFFTPoisson::SWFFTPoisson (const Geometry& a_geom)
+    : m_geom(a_geom)
+{
+    BL_PROFILE("SWFFTPoisson::SWFFTPoisson()");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_geom.isAllPeriodic(),
+                                     "SWFFTPoisson: the domain must be periodic in all directions");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_geom.IsCartesian(),
+                                     "SWFFTPoisson: only Cartesian coordinates are supported");
+
+    MPI_Comm comm = ParallelContext::CommunicatorSub();
+    const int nprocs = ParallelContext::NProcsSub();
+    const Box& domain = m_geom.Domain();
+
+    // SWFFT's arrays are in C order.  Its dimension 0 is our z-direction,
+    // so that the data of a block are laid out like those of a FArrayBox.
+    int n[3] = {domain.length(2), domain.length(1), domain.length(0)};
+    m_dist.reset(new hacc::Distribution(comm, n));
+    m_dfft.reset(new hacc::Dfft(*m_dist));
+
+    // The real-space block of each process
+    {
+        const int* local_ng = m_dfft->local_ng_rspace();
+        const int* self = m_dfft->self_rspace();
+        const IntVect lo = domain.smallEnd() + IntVect(self[2]*local_ng[2],
+                                                       self[1]*local_ng[1],
+                                                       self[0]*local_ng[0]);
+        const IntVect hi = lo + IntVect(local_ng[2]-1, local_ng[1]-1, local_ng[0]-1);
+        const int mylohi[6] = {lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]};
+        Vector<int> lohi(6*nprocs);
+        ParallelAllGather::AllGather(mylohi, 6, lohi.data(), comm);
+
+        BoxList bl;
+        Vector<int> pmap(nprocs);
+        for (int i = 0; i < nprocs; ++i) {
+            const int* p = &lohi[6*i];
+            bl.push_back(Box(IntVect(p[0],p[1],p[2]), IntVect(p[3],p[4],p[5])));
+            pmap[i] = ParallelContext::local_to_global_rank(i);
+        }
+        BoxArray ba(std::move(bl));
+        AMREX_ALWAYS_ASSERT(ba.numPts() == domain.numPts());
+        DistributionMapping dm(std::move(pmap));
+        m_phi.define(ba, dm, 1, 0, MFInfo().SetArena(The_Pinned_Arena()));
+    }
+
+    // The planning with FFTW_MEASURE overwrites the buffers.
+    const std::size_t nlocal = std::max(m_dfft->local_size(),
+                                        static_cast<std::size_t>(m_phi.boxArray()[0].numPts()));
+    m_a.resize(nlocal);
+    m_b.resize(nlocal);
+    m_dfft->makePlans(m_a.data(), m_b.data(), m_a.data(), m_b.data());
+
+    // Eigenvalues of (u_{i-1} - 2 u_i + u_{i+1})/h^2 for the modes in the
+    // local pencil of k-space
+    const int* local_ng = m_dfft->local_ng_kspace();
+    const int* self = m_dfft->self_kspace();
+    const Real* dx = m_geom.CellSize();
+    const Real tpi = 8.0*std::atan(1.0);
+    for (int d = 0; d < 3; ++d) {
+        const int idir = 2-d;
+        const int N = n[d];
+        const Real dxinv2 = 1.0/(dx[idir]*dx[idir]);
+        m_lambda[d].resize(local_ng[d]);
+        for (int i = 0; i < local_ng[d]; ++i) {
+            const int g = local_ng[d]*self[d] + i;
+            m_lambda[d][i] = 2.0*(std::cos(tpi*g/N) - 1.0) * dxinv2;
+        }
+    }
+}
+
+SWFFTPoisson::~SWFFTPoisson ()
+{
+    // The plans refer to the distribution, so the Dfft goes first.
+    m_dfft.reset();
+    m_dist.reset();
+}
+
+void
+SWFFTPoisson::solve (MultiFab& soln, const MultiFab& rhs)
+{
+    BL_PROFILE("SWFFTPoisson::solve()");
+
+    AMREX_ALWAYS_ASSERT(soln.nComp() == rhs.nComp());
+    AMREX_ALWAYS_ASSERT(rhs.boxArray().numPts() == m_geom.Domain().numPts());
+
+    for (int n = 0; n < rhs.nComp(); ++n)
+    {
+        m_phi.ParallelCopy(rhs, n, 0, 1);
+
+        // Every process has exactly one block.
+        for (MFIter mfi(m_phi); mfi.isValid(); ++mfi) {
+            const Real* p = m_phi[mfi].dataPtr();
+            const Long npts = mfi.validbox().numPts();
+            for (Long i = 0; i < npts; ++i) {
+                m_a[i] = std::complex<double>(p[i], 0.0);
+            }
+        }
+
+        solveFFT();
+
+        for (MFIter mfi(m_phi); mfi.isValid(); ++mfi) {
+            Real* p = m_phi[mfi].dataPtr();
+            const Long npts = mfi.validbox().numPts();
+            for (Long i = 0; i < npts; ++i) {
+                p[i] = m_a[i].real();
+            }
+        }
+
+        soln.ParallelCopy(m_phi, 0, n, 1);
+    }
+}
+
+void
+SWFFTPoisson::solveFFT ()
+{
+    BL_PROFILE("SWFFTPoisson::solveFFT()");
+
+    m_dfft->forward(m_a.data());
+
+    // Divide by the eigenvalues of the discrete Laplacian.  The backward
+    // transform is not normalized, hence the scaling.  The zero mode is
+    // removed.
+    const int* local_ng = m_dfft->local_ng_kspace();
+    const Real scale = 1.0/static_cast<Real>(m_dfft->global_size());
+    const Real* lam0 = m_lambda[0].data();
+    const Real* lam1 = m_lambda[1].data();
+    const Real* lam2 = m_lambda[2].data();
+    Long idx = 0;
+    for (int i = 0; i < local_ng[0]; ++i) {
+        for (int j = 0; j < local_ng[1]; ++j) {
+            for (int k = 0; k < local_ng[2]; ++k) {
+                const Real lam = lam0[i] + lam1[j] + lam2[k];
+                if (lam < 0.0) {
+                    m_a[idx] *= scale/lam;
+                } else {
+                    m_a[idx] = 0.0;
+                }
+                ++idx;
+            }
+        }
+    }
+
+    m_dfft->backward(m_a.data());
+}
+
+}
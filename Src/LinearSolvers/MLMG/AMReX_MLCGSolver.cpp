@@ -70,8 +70,14 @@ MLCGSolver::solve (MultiFab&       sol,
                    Real            eps_rel,
                    Real            eps_abs)
 {
+    nreductions = 0;
+
     if (solver_type == Type::BiCGStab) {
         return solve_bicgstab(sol,rhs,eps_rel,eps_abs);
+    } else if (solver_type == Type::PipeCG) {
+        return solve_pipecg(sol,rhs,eps_rel,eps_abs);
+    } else if (solver_type == Type::CABiCGStab) {
+        return solve_cabicgstab(sol,rhs,eps_rel,eps_abs);
     } else {
         return solve_cg(sol,rhs,eps_rel,eps_abs);
     }
@@ -149,14 +155,15 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
         if ( iter == 1 )
         {
             MultiFab::Copy(p,r,0,0,ncomp,nghost);
+            MultiFab::Copy(ph,p,0,0,ncomp,nghost);
         }
         else
         {
             const Real beta = (rho/rho_1)*(alpha/omega);
-            sxay(p, p, -omega, v, nghost);
-            sxay(p, r,   beta, p, nghost);
+            MultiFab::FusedLinComb({{p, -omega, v},
+                                    {p, 1.0, r, beta, p},
+                                    {ph, 1.0, p, 0.0, p}}, ncomp, nghost);
         }
-        MultiFab::Copy(ph,p,0,0,ncomp,nghost);
         Lp.apply(amrlev, mglev, v, ph, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
         Lp.normalize(amrlev, mglev, v);
 
@@ -169,13 +176,11 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 	{
             ret = 2; break;
 	}
-        sxay(sol, sol,  alpha, ph, nghost);
-        sxay(s,     r, -alpha,  v, nghost);
-
         //Subtract mean from s 
 //        if (Lp.isBottomSingular()) mlmg->makeSolvable(amrlev, mglev, s);
  
-        rnorm = norm_inf(s);
+        rnorm = lincomb_norm_inf({{sol, alpha, ph},
+                                  {s, 1.0, r, -alpha, v}}, s);
 
         if ( verbose > 2 && ParallelDescriptor::IOProcessor() )
         {
@@ -199,6 +204,7 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
         BL_PROFILE_VAR("MLCGSolver::ParallelAllReduce", blp_par);
         ParallelAllReduce::Sum(tvals,2,Lp.BottomCommunicator());
+        ++nreductions;
         BL_PROFILE_VAR_STOP(blp_par);
 
         if ( tvals[0] != 0.0_rt )
@@ -209,12 +215,10 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 	{
             ret = 3; break;
 	}
-        sxay(sol, sol,  omega, sh, nghost);
-        sxay(r,     s, -omega,  t, nghost);
-
 //        if (Lp.isBottomSingular()) mlmg->makeSolvable(amrlev, mglev, r);
 
-        rnorm = norm_inf(r);
+        rnorm = lincomb_norm_inf({{sol, omega, sh},
+                                  {r, 1.0, s, -omega, t}}, r);
 
         if ( verbose > 2 )
         {
@@ -238,7 +242,8 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
         amrex::Print() << "MLCGSolver_BiCGStab: Final: Iteration "
                        << std::setw(4) << iter
                        << " rel. err. "
-                       << rnorm/(rnorm0) << '\n';
+                       << rnorm/(rnorm0)
+                       << " global reductions " << nreductions << '\n';
     }
 
     if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
@@ -350,9 +355,8 @@ MLCGSolver::solve_cg (MultiFab&       sol,
                            << " rho " << rho
                            << " alpha " << alpha << '\n';
         }
-        sxay(sol, sol, alpha, p, nghost);
-        sxay(  r,   r,-alpha, q, nghost);
-        rnorm = norm_inf(r);
+        rnorm = lincomb_norm_inf({{sol, alpha, p},
+                                  {r, -alpha, q}}, r);
 
         if ( verbose > 2 )
         {
@@ -372,7 +376,8 @@ MLCGSolver::solve_cg (MultiFab&       sol,
         amrex::Print() << "MLCGSolver_cg: Final Iteration"
                        << std::setw(4) << iter
                        << " rel. err. "
-                       << rnorm/(rnorm0) << '\n';
+                       << rnorm/(rnorm0)
+                       << " global reductions " << nreductions << '\n';
     }
 
     if ( ret == 0 &&  rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
@@ -395,16 +400,494 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     return ret;
 }
 
+int
+MLCGSolver::solve_pipecg (MultiFab&       sol,
+                          const MultiFab& rhs,
+                          Real            eps_rel,
+                          Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipecg");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // r and w are the operands of Lp.apply.
+    MultiFab r(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    MultiFab w(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    r.setVal(0.0);
+    w.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab z    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    sol.setVal(0);
+
+    // Residual norms are 2-norms here because they come with (r,r), so
+    // that each iteration needs only one global reduction.
+    Real       rnorm    = std::sqrt(dotxy(r,r));
+    const Real rnorm0   = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeCG: Initial error (error0) :        " << rnorm0 << '\n';
+    }
+
+    int  ret = 0;
+    iter = 1;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 ) {
+            amrex::Print() << "MLCGSolver_PipeCG: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    Lp.apply(amrlev, mglev, w, r, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+    Real gamma_1 = 0, alpha = 0;
+
+    for (; iter <= maxiter; ++iter)
+    {
+        //
+        // The one reduction of this iteration, for (r,r) and (w,r), is
+        // started before q = A w and finished after it, so that its
+        // latency is hidden behind the operator application.
+        //
+        Real gd[2] = { dotxy(r,r,true), dotxy(w,r,true) };
+        ReduceHandle<Real> handle = ParallelAllReduce::Sum_nowait(gd, 2, Lp.BottomCommunicator());
+        ++nreductions;
+
+        Lp.apply(amrlev, mglev, q, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+        {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            handle.wait();
+        }
+
+        if (iter > 1)
+        {
+            // (r,r) is that of the residual after the previous iteration.
+            rnorm = std::sqrt(std::max(gd[0], Real(0.0)));
+
+            if ( verbose > 2 )
+            {
+                amrex::Print() << "MLCGSolver_PipeCG:   Iteration"
+                               << std::setw(4) << iter-1
+                               << " rel. err. "
+                               << rnorm/(rnorm0) << '\n';
+            }
+
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) { --iter; break; }
+        }
+
+        const Real gamma = gd[0];
+        const Real delta = gd[1];
+
+        if ( gamma == 0 )
+        {
+            ret = 1; break;
+        }
+
+        Real beta, denom;
+        if (iter == 1)
+        {
+            beta = 0;
+            denom = delta;
+        }
+        else
+        {
+            beta = gamma/gamma_1;
+            denom = delta - beta*gamma/alpha;
+        }
+
+        if ( denom == 0 )
+        {
+            ret = 1; break;
+        }
+        alpha = gamma/denom;
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipeCG:"
+                           << " iter " << iter
+                           << " gamma " << gamma
+                           << " alpha " << alpha << '\n';
+        }
+
+        if (iter == 1)
+        {
+            MultiFab::Copy(z,q,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+        }
+        else
+        {
+            MultiFab::FusedLinComb({{z, 1.0, q, beta, z},
+                                    {s, 1.0, w, beta, s},
+                                    {p, 1.0, r, beta, p}}, ncomp, nghost);
+        }
+        MultiFab::FusedLinComb({{sol, alpha, p},
+                                {r, -alpha, s},
+                                {w, -alpha, z}}, ncomp, nghost);
+
+        gamma_1 = gamma;
+    }
+
+    if (iter > maxiter)
+    {
+        // The norm of the last residual has not been computed yet.
+        rnorm = std::sqrt(dotxy(r,r));
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipeCG: Final Iteration"
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0)
+                       << " global reductions " << nreductions << '\n';
+    }
+
+    if ( ret == 0 &&  rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipeCG: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
+int
+MLCGSolver::solve_cabicgstab (MultiFab&       sol,
+                              const MultiFab& rhs,
+                              Real            eps_rel,
+                              Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::cabicgstab");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    //
+    // Each outer iteration builds the Krylov bases
+    //     Y = [p, Ap, ..., A^{2s} p, r, Ar, ..., A^{2s-1} r]
+    // with the normalized operator, computes the Gram matrix G = Y^T Y and
+    // g = Y^T rh in a single reduction, and then does s BiCGStab iterations
+    // on the coordinate vectors without any communication.  The monomial
+    // basis is used, so s should be small.
+    //
+    const int s  = std::max(sstep, 1);
+    const int np = 2*s+1;       // number of p basis vectors
+    const int nb = 4*s+1;       // total number of basis vectors
+
+    Vector<MultiFab> Y(nb);
+    for (auto& y : Y) {
+        y.define(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+        y.setVal(0.0);
+    }
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab rh   (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+    Lp.normalize(amrlev, mglev, r);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+    MultiFab::Copy(rh,   r,  0,0,ncomp,nghost);
+    MultiFab::Copy(p,    r,  0,0,ncomp,nghost);
+
+    sol.setVal(0);
+
+    // Residual norms are 2-norms here because they are available from G
+    // without communication.
+    Real rnorm = std::sqrt(dotxy(r,r));
+    const Real rnorm0 = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_CABiCGStab: Initial error (error0) =        " << rnorm0
+                       << ", s = " << s << '\n';
+    }
+
+    int ret = 0;
+    iter = 0;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 )
+        {
+            amrex::Print() << "MLCGSolver_CABiCGStab: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    Vector<Real> G(nb*nb), g(nb), gram(nb*(nb+1)/2+nb);
+    Vector<Real> xc(nb), rc(nb), pc(nb), qc(nb), Bp(nb), Bq(nb);
+
+    // Multiply a coordinate vector by the change of basis matrix, i.e.,
+    // A Y(:,i) = Y(:,i+1) except for the last vector of each basis.
+    auto Bmul = [&] (Vector<Real> const& v, Vector<Real>& bv)
+    {
+        std::fill(bv.begin(), bv.end(), 0.0);
+        for (int i = 0; i < np-1; ++i) bv[i+1] = v[i];
+        for (int i = np; i < nb-1; ++i) bv[i+1] = v[i];
+    };
+    auto dotG = [&] (Vector<Real> const& a, Vector<Real> const& b) -> Real
+    {
+        Real t = 0.0;
+        for (int i = 0; i < nb; ++i) {
+            Real gb = 0.0;
+            for (int j = 0; j < nb; ++j) gb += G[i*nb+j]*b[j];
+            t += a[i]*gb;
+        }
+        return t;
+    };
+    auto dotg = [&] (Vector<Real> const& a) -> Real
+    {
+        Real t = 0.0;
+        for (int i = 0; i < nb; ++i) t += g[i]*a[i];
+        return t;
+    };
+    auto applyOp = [&] (MultiFab& out, MultiFab& in)
+    {
+        Lp.apply(amrlev, mglev, out, in, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, out);
+    };
+    auto combine = [&] (MultiFab& dst, Vector<Real> const& c)
+    {
+        Vector<MultiFab::LinCombOp> ops;
+        for (int i = 0; i < nb; ++i) {
+            if (c[i] != 0.0) ops.emplace_back(dst, c[i], Y[i]);
+            if (ops.size() == MultiFab::max_fused_ops || (i == nb-1 && !ops.empty())) {
+                MultiFab::FusedLinComb(ops, ncomp, nghost);
+                ops.clear();
+            }
+        }
+    };
+
+    bool converged = false;
+
+    while (iter < maxiter && !converged && ret == 0)
+    {
+        // Matrix powers.  No global communication.
+        MultiFab::Copy(Y[0], p, 0, 0, ncomp, nghost);
+        for (int i = 1; i < np; ++i) {
+            applyOp(Y[i], Y[i-1]);
+        }
+        MultiFab::Copy(Y[np], r, 0, 0, ncomp, nghost);
+        for (int i = np+1; i < nb; ++i) {
+            applyOp(Y[i], Y[i-1]);
+        }
+
+        int k = 0;
+        for (int i = 0; i < nb; ++i) {
+            for (int j = i; j < nb; ++j) {
+                gram[k++] = dotxy(Y[i], Y[j], true);
+            }
+        }
+        for (int i = 0; i < nb; ++i) {
+            gram[k++] = dotxy(Y[i], rh, true);
+        }
+
+        BL_PROFILE_VAR("MLCGSolver::ParallelAllReduce", blp_par);
+        ParallelAllReduce::Sum(gram.data(), k, Lp.BottomCommunicator());
+        ++nreductions;
+        BL_PROFILE_VAR_STOP(blp_par);
+
+        k = 0;
+        for (int i = 0; i < nb; ++i) {
+            for (int j = i; j < nb; ++j) {
+                G[i*nb+j] = G[j*nb+i] = gram[k++];
+            }
+        }
+        for (int i = 0; i < nb; ++i) {
+            g[i] = gram[k++];
+        }
+
+        std::fill(xc.begin(), xc.end(), 0.0);
+        std::fill(pc.begin(), pc.end(), 0.0);
+        std::fill(rc.begin(), rc.end(), 0.0);
+        pc[0]  = 1.0;
+        rc[np] = 1.0;
+
+        for (int j = 0; j < s && iter < maxiter; ++j)
+        {
+            ++iter;
+
+            const Real rho = dotg(rc);
+            if ( rho == 0 )
+            {
+                ret = 1; break;
+            }
+
+            Bmul(pc, Bp);
+            const Real gBp = dotg(Bp);
+            if ( gBp == 0 )
+            {
+                ret = 2; break;
+            }
+            const Real alpha = rho/gBp;
+
+            for (int i = 0; i < nb; ++i) qc[i] = rc[i] - alpha*Bp[i];
+
+            rnorm = std::sqrt(std::max(dotG(qc,qc), Real(0.0)));
+
+            if ( verbose > 2 )
+            {
+                amrex::Print() << "MLCGSolver_CABiCGStab: Half Iter "
+                               << std::setw(11) << iter
+                               << " rel. err. "
+                               << rnorm/(rnorm0) << '\n';
+            }
+
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+            {
+                for (int i = 0; i < nb; ++i) xc[i] += alpha*pc[i];
+                rc = qc;
+                converged = true;
+                break;
+            }
+
+            Bmul(qc, Bq);
+            const Real BqBq = dotG(Bq,Bq);
+            if ( BqBq == 0 )
+            {
+                ret = 3; break;
+            }
+            const Real omega = dotG(qc,Bq)/BqBq;
+
+            for (int i = 0; i < nb; ++i) {
+                xc[i] += alpha*pc[i] + omega*qc[i];
+                rc[i]  = qc[i] - omega*Bq[i];
+            }
+
+            rnorm = std::sqrt(std::max(dotG(rc,rc), Real(0.0)));
+
+            if ( verbose > 2 )
+            {
+                amrex::Print() << "MLCGSolver_CABiCGStab: Iteration "
+                               << std::setw(11) << iter
+                               << " rel. err. "
+                               << rnorm/(rnorm0) << '\n';
+            }
+
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+            {
+                converged = true;
+                break;
+            }
+
+            if ( omega == 0 )
+            {
+                ret = 4; break;
+            }
+
+            const Real beta = (alpha/omega) * dotg(rc)/rho;
+            for (int i = 0; i < nb; ++i) {
+                pc[i] = rc[i] + beta*pc[i] - beta*omega*Bp[i];
+            }
+        }
+
+        // Go back to the full vectors.
+        combine(sol, xc);
+        if (ret == 0)
+        {
+            r.setVal(0.0);
+            combine(r, rc);
+            p.setVal(0.0);
+            combine(p, pc);
+        }
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_CABiCGStab: Final: Iteration "
+                       << std::setw(4) << iter
+                       << " rel. err. "
+                       << rnorm/(rnorm0)
+                       << " global reductions " << nreductions << '\n';
+    }
+
+    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_CABiCGStab:: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
 Real
 MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, bool local)
 {
     BL_PROFILE_VAR_NS("MLCGSolver::ParallelAllReduce", blp_par);
-    if (!local) { BL_PROFILE_VAR_START(blp_par); }
+    if (!local) { BL_PROFILE_VAR_START(blp_par); ++nreductions; }
     Real result = Lp.xdoty(amrlev, mglev, r, z, local);
     if (!local) { BL_PROFILE_VAR_STOP(blp_par); }
     return result;
 }
 
+Real
+MLCGSolver::lincomb_norm_inf (const Vector<MultiFab::LinCombOp>& ops, const MultiFab& res, bool local)
+{
+    if (nghost > 0) {
+        // norm_inf only looks at valid cells
+        MultiFab::FusedLinComb(ops, res.nComp(), nghost);
+        return norm_inf(res, local);
+    }
+
+    Real result = MultiFab::FusedLinCombNorm0(ops, res, 0, res.nComp(), 0, true);
+
+    if (!local) {
+        BL_PROFILE("MLCGSolver::ParallelAllReduce");
+        ParallelAllReduce::Max(result, Lp.BottomCommunicator());
+        ++nreductions;
+    }
+    return result;
+}
+
 Real
 MLCGSolver::norm_inf (const MultiFab& res, bool local)
 {
@@ -416,6 +899,7 @@ MLCGSolver::norm_inf (const MultiFab& res, bool local)
     if (!local) {
         BL_PROFILE("MLCGSolver::ParallelAllReduce");
         ParallelAllReduce::Max(result, Lp.BottomCommunicator());
+        ++nreductions;
     }
     return result;
 }
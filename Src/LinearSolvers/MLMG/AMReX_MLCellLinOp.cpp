@@ -24,8 +24,10 @@ MLCellLinOp::define (const Vector<Geometry>& a_geom,
                      const Vector<FabFactory<FArrayBox> const*>& a_factory)
 {
     MLLinOp::define(a_geom, a_grids, a_dmap, a_info, a_factory);
+    Real t0 = amrex::second();
     defineAuxData();
     defineBC();
+    m_define_time += amrex::second() - t0;
 }
 
 void
@@ -80,6 +82,42 @@ MLCellLinOp::defineAuxData ()
 #if (AMREX_SPACEDIM != 3)
     m_has_metric_term = !m_geom[0][0].IsCartesian() && info.has_metric_term;
 #endif
+
+    if (m_smoother == Smoother::chebyshev) {
+        defineChebyshevData();
+    }
+}
+
+void
+MLCellLinOp::defineChebyshevData ()
+{
+    const int ncomp = getNComp();
+    m_cheby_r.resize(m_num_amr_levels);
+    m_cheby_d.resize(m_num_amr_levels);
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        m_cheby_r[amrlev].resize(m_num_mg_levels[amrlev]);
+        m_cheby_d[amrlev].resize(m_num_mg_levels[amrlev]);
+        for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+        {
+            m_cheby_r[amrlev][mglev].define(m_grids[amrlev][mglev], m_dmap[amrlev][mglev],
+                                            ncomp, 0, MFInfo(), *Factory(amrlev,mglev));
+            m_cheby_d[amrlev][mglev].define(m_grids[amrlev][mglev], m_dmap[amrlev][mglev],
+                                            ncomp, 0, MFInfo(), *Factory(amrlev,mglev));
+        }
+    }
+}
+
+void
+MLCellLinOp::setSmoother (Smoother s)
+{
+    m_smoother = s;
+    if (m_smoother == Smoother::chebyshev) {
+        if (m_cheby_r.empty() && m_num_amr_levels > 0) defineChebyshevData();
+    } else {
+        m_cheby_r.clear();
+        m_cheby_d.clear();
+    }
 }
 
 void
@@ -351,6 +389,10 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
                      bool skip_fillboundary) const
 {
     BL_PROFILE("MLCellLinOp::smooth()");
+    if (m_smoother == Smoother::chebyshev) {
+        chebyshevSmooth(amrlev, mglev, sol, rhs, skip_fillboundary);
+        return;
+    }
     for (int redblack = 0; redblack < 2; ++redblack)
     {
         applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution,
@@ -363,6 +405,139 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
     }
 }
 
+// Chebyshev polynomial smoothing of the diagonally scaled operator
+// D^{-1}A, targeting the upper part [ratio*lambda_max, 1.1*lambda_max]
+// of its spectrum.  Only operator applications and pointwise updates
+// are used, so there is one ghost cell exchange per degree.
+void
+MLCellLinOp::chebyshevSmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                              bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::chebyshevSmooth()");
+
+    const int ncomp = getNComp();
+    const Real lambda = chebyshevMaxEigenvalue(amrlev, mglev);
+    // Both ends have the sign of lambda, so sigma = theta/delta > 1.
+    const Real hi = 1.1*lambda;
+    const Real lo = m_cheby_eig_ratio*lambda;
+    const Real theta = 0.5*(hi+lo);
+    const Real delta = 0.5*(hi-lo);
+    const Real sigma = theta/delta;
+    Real rho = 1.0/sigma;
+
+    MultiFab& r = m_cheby_r[amrlev][mglev];
+    MultiFab& d = m_cheby_d[amrlev][mglev];
+    AMREX_ASSERT(r.boxArray() == sol.boxArray() && r.DistributionMap() == sol.DistributionMap());
+
+    for (int k = 0; k < m_cheby_degree; ++k)
+    {
+        // r = D^{-1} (rhs - A sol)
+        applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution,
+                nullptr, skip_fillboundary);
+        skip_fillboundary = false;
+#ifdef AMREX_SOFT_PERF_COUNTERS
+        perf_counters.smooth(sol);
+#endif
+        Fapply(amrlev, mglev, r, sol);
+        MultiFab::Xpay(r, -1.0, rhs, 0, 0, ncomp, 0);
+        normalize(amrlev, mglev, r);
+
+        if (k == 0) {
+            // d = r/theta; sol += d
+            MultiFab::FusedLinComb({{d, 1.0/theta, r, 0.0, r},
+                                    {sol, 1.0, d}}, ncomp, 0);
+        } else {
+            // d = rho_k*rho_{k-1}*d + 2*rho_k/delta*r; sol += d
+            const Real rho_new = 1.0/(2.0*sigma - rho);
+            MultiFab::FusedLinComb({{d, rho_new*rho, d, 2.0*rho_new/delta, r},
+                                    {sol, 1.0, d}}, ncomp, 0);
+            rho = rho_new;
+        }
+    }
+}
+
+// Estimate the largest eigenvalue of D^{-1}A by power iteration with
+// homogeneous boundary conditions.  The result is cached until the
+// operator is updated.
+Real
+MLCellLinOp::chebyshevMaxEigenvalue (int amrlev, int mglev) const
+{
+    if (m_cheby_lambda.empty()) {
+        m_cheby_lambda.resize(m_num_amr_levels);
+        for (int alev = 0; alev < m_num_amr_levels; ++alev) {
+            m_cheby_lambda[alev].resize(m_num_mg_levels[alev], 0.0);
+        }
+    }
+    if (m_cheby_lambda[amrlev][mglev] != 0.0) return m_cheby_lambda[amrlev][mglev];
+
+    BL_PROFILE("MLCellLinOp::chebyshevMaxEigenvalue()");
+
+    const int ncomp = getNComp();
+    const BoxArray& ba = m_grids[amrlev][mglev];
+    const DistributionMapping& dm = m_dmap[amrlev][mglev];
+    MultiFab v(ba, dm, ncomp, 1, MFInfo(), *Factory(amrlev,mglev));
+    MultiFab w(ba, dm, ncomp, 0, MFInfo(), *Factory(amrlev,mglev));
+
+    // The start vector has signs alternating from cell to cell and
+    // deterministic pseudo-random magnitudes in [0.5,1.5) that do not
+    // depend on the domain decomposition.  On a grid the eigenvector of
+    // the largest eigenvalue of D^{-1}A is such a checkerboard times a
+    // positive vector, so the start vector cannot be orthogonal to it.
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(v,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<Real> const& vfab = v.array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            unsigned int h = 0;
+            for (unsigned int x : {static_cast<unsigned int>(i), static_cast<unsigned int>(j),
+                                   static_cast<unsigned int>(k), static_cast<unsigned int>(n)})
+            {
+                h = (h ^ x) * 0x9e3779b1u;
+                h ^= h >> 16;
+                h *= 0x85ebca6bu;
+                h ^= h >> 13;
+                h *= 0xc2b2ae35u;
+                h ^= h >> 16;
+            }
+            const Real r = static_cast<Real>(h >> 16)*(1.0/65536.0) + 0.5;
+            vfab(i,j,k,n) = ((i+j+k) % 2 == 0) ? r : -r;
+        });
+    }
+
+    const int niters = 10;
+    Real lambda = 0.0;
+    for (int iter = 0; iter < niters; ++iter)
+    {
+        applyBC(amrlev, mglev, v, BCMode::Homogeneous, StateMode::Solution);
+        Fapply(amrlev, mglev, w, v);
+        normalize(amrlev, mglev, w);
+        Real vw = MultiFab::Dot(v,0,w,0,ncomp,0,true);
+        Real vv = MultiFab::Dot(v,0,v,0,ncomp,0,true);
+        Real ww = MultiFab::Dot(w,0,w,0,ncomp,0,true);
+        Real sums[3] = {vw, vv, ww};
+        ParallelAllReduce::Sum(sums, 3, ParallelContext::CommunicatorSub());
+        if (sums[1] == 0.0 || sums[2] == 0.0) break;
+        lambda = sums[0]/sums[1];
+        MultiFab::LinComb(v, 1.0/std::sqrt(sums[2]), w, 0, 0.0, w, 0, 0, ncomp, 0);
+    }
+
+    if (lambda == 0.0) {
+        amrex::Abort("MLCellLinOp::chebyshevMaxEigenvalue: failed to estimate eigenvalue");
+    }
+
+    if (verbose >= 2) {
+        amrex::Print() << "MLCellLinOp: Chebyshev smoother lambda_max estimate on AMR level "
+                       << amrlev << " MG level " << mglev << ": " << lambda << "\n";
+    }
+
+    m_cheby_lambda[amrlev][mglev] = lambda;
+    return lambda;
+}
+
 void
 MLCellLinOp::updateSolBC (int amrlev, const MultiFab& crse_bcdata) const
 {
@@ -576,6 +751,216 @@ MLCellLinOp::applyBC (int amrlev, int mglev, MultiFab& in, BCMode bc_mode, State
     }
 }
 
+void
+MLCellLinOp::applyBCFloat (int amrlev, int mglev, fMultiFab& in, bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::applyBCFloat()");
+    AMREX_ALWAYS_ASSERT(isCrossStencil() && !isTensorOp());
+
+    const int ncomp = getNComp();
+    if (!skip_fillboundary) {
+        in.FillBoundary(0, ncomp, m_geom[amrlev][mglev].periodicity(), true);
+    }
+
+    const int imaxorder = maxorder;
+
+    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+    const Real dxi = dxinv[0];
+    const Real dyi = (AMREX_SPACEDIM >= 2) ? dxinv[1] : 1.0;
+    const Real dzi = (AMREX_SPACEDIM == 3) ? dxinv[2] : 1.0;
+
+    const auto& maskvals = m_maskvals[amrlev][mglev];
+    const auto& bcondloc = *m_bcondloc[amrlev][mglev];
+
+    // Homogeneous, so the boundary values are never read.
+    FArrayBox foofab(Box::TheUnitBox(),ncomp);
+    const auto& foo = foofab.const_array();
+
+    MFItInfo mfi_info;
+    if (Gpu::notInLaunchRegion()) mfi_info.SetDynamic(true);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(in, mfi_info); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx   = mfi.validbox();
+        const auto& iofab = in.array(mfi);
+
+        const auto & bdlv = bcondloc.bndryLocs(mfi);
+        const auto & bdcv = bcondloc.bndryConds(mfi);
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Orientation olo(idim,Orientation::low);
+            const Orientation ohi(idim,Orientation::high);
+            const Box blo = amrex::adjCellLo(vbx, idim);
+            const Box bhi = amrex::adjCellHi(vbx, idim);
+            const int blen = vbx.length(idim);
+            const auto& mlo = maskvals[olo].array(mfi);
+            const auto& mhi = maskvals[ohi].array(mfi);
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                const BoundCond bctlo = bdcv[icomp][olo];
+                const BoundCond bcthi = bdcv[icomp][ohi];
+                const Real bcllo = bdlv[icomp][olo];
+                const Real bclhi = bdlv[icomp][ohi];
+                if (idim == 0) {
+                    AMREX_LAUNCH_HOST_DEVICE_LAMBDA (
+                    blo, tboxlo, {
+                    mllinop_apply_bc_x(0, tboxlo, blen, iofab, mlo,
+                                       bctlo, bcllo, foo,
+                                       imaxorder, dxi, 0, icomp);
+                    },
+                    bhi, tboxhi, {
+                    mllinop_apply_bc_x(1, tboxhi, blen, iofab, mhi,
+                                       bcthi, bclhi, foo,
+                                       imaxorder, dxi, 0, icomp);
+                    });
+                } else if (idim == 1) {
+                    AMREX_LAUNCH_HOST_DEVICE_LAMBDA (
+                    blo, tboxlo, {
+                    mllinop_apply_bc_y(0, tboxlo, blen, iofab, mlo,
+                                       bctlo, bcllo, foo,
+                                       imaxorder, dyi, 0, icomp);
+                    },
+                    bhi, tboxhi, {
+                    mllinop_apply_bc_y(1, tboxhi, blen, iofab, mhi,
+                                       bcthi, bclhi, foo,
+                                       imaxorder, dyi, 0, icomp);
+                    });
+                } else {
+                    AMREX_LAUNCH_HOST_DEVICE_LAMBDA (
+                    blo, tboxlo, {
+                    mllinop_apply_bc_z(0, tboxlo, blen, iofab, mlo,
+                                       bctlo, bcllo, foo,
+                                       imaxorder, dzi, 0, icomp);
+                    },
+                    bhi, tboxhi, {
+                    mllinop_apply_bc_z(1, tboxhi, blen, iofab, mhi,
+                                       bcthi, bclhi, foo,
+                                       imaxorder, dzi, 0, icomp);
+                    });
+                }
+            }
+        }
+    }
+}
+
+void
+MLCellLinOp::smoothFloat (int amrlev, int mglev, fMultiFab& sol, const fMultiFab& rhs,
+                          bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::smoothFloat()");
+    for (int redblack = 0; redblack < 2; ++redblack)
+    {
+        applyBCFloat(amrlev, mglev, sol, skip_fillboundary);
+        FsmoothFloat(amrlev, mglev, sol, rhs, redblack);
+        skip_fillboundary = false;
+    }
+}
+
+void
+MLCellLinOp::correctionResidualFloat (int amrlev, int mglev, fMultiFab& resid,
+                                      fMultiFab& x, const fMultiFab& b) const
+{
+    BL_PROFILE("MLCellLinOp::correctionResidualFloat()");
+    const int ncomp = getNComp();
+    applyBCFloat(amrlev, mglev, x);
+    FapplyFloat(amrlev, mglev, resid, x);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(resid,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<float> const& rfab = resid.array(mfi);
+        Array4<float const> const& bfab = b.const_array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            rfab(i,j,k,n) = bfab(i,j,k,n) - rfab(i,j,k,n);
+        });
+    }
+}
+
+void
+MLCellLinOp::restrictionFloat (int amrlev, int cmglev, fMultiFab& crse, const fMultiFab& fine) const
+{
+    BL_PROFILE("MLCellLinOp::restrictionFloat()");
+    const int ncomp = getNComp();
+
+    Dim3 ratio3 = {1,1,1};
+    IntVect ratio = (amrlev > 0) ? IntVect(2) : mg_coarsen_ratio_vec[cmglev-1];
+    AMREX_D_TERM(ratio3.x = ratio[0];,
+                 ratio3.y = ratio[1];,
+                 ratio3.z = ratio[2];);
+    const Real volfrac = 1.0/static_cast<Real>(AMREX_D_TERM(ratio[0],*ratio[1],*ratio[2]));
+
+    BoxArray cba = fine.boxArray();
+    cba.coarsen(ratio);
+    const bool direct = (cba == crse.boxArray() and fine.DistributionMap() == crse.DistributionMap());
+
+    fMultiFab cfine;
+    if (!direct) {
+        cfine.define(cba, fine.DistributionMap(), ncomp, 0);
+    }
+    fMultiFab& cmf = direct ? crse : cfine;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(cmf,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<float> const& cfab = cmf.array(mfi);
+        Array4<float const> const& ffab = fine.const_array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            Real c = 0.0;
+            for (int kref = 0; kref < ratio3.z; ++kref) {
+            for (int jref = 0; jref < ratio3.y; ++jref) {
+            for (int iref = 0; iref < ratio3.x; ++iref) {
+                c += ffab(i*ratio3.x+iref,j*ratio3.y+jref,k*ratio3.z+kref,n);
+            }}}
+            cfab(i,j,k,n) = volfrac * c;
+        });
+    }
+
+    if (!direct) {
+        crse.ParallelCopy(cfine);
+    }
+}
+
+void
+MLCellLinOp::interpolationFloat (int amrlev, int fmglev, fMultiFab& fine, const fMultiFab& crse) const
+{
+    BL_PROFILE("MLCellLinOp::interpolationFloat()");
+    const int ncomp = getNComp();
+
+    Dim3 ratio3 = {2,2,2};
+    IntVect ratio = (amrlev > 0) ? IntVect(2) : mg_coarsen_ratio_vec[fmglev];
+    AMREX_D_TERM(ratio3.x = ratio[0];,
+                 ratio3.y = ratio[1];,
+                 ratio3.z = ratio[2];);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(fine,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx    = mfi.tilebox();
+        Array4<float const> const& cfab = crse.const_array(mfi);
+        Array4<float> const& ffab = fine.array(mfi);
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            int ic = amrex::coarsen(i,ratio3.x);
+            int jc = amrex::coarsen(j,ratio3.y);
+            int kc = amrex::coarsen(k,ratio3.z);
+            ffab(i,j,k,n) += cfab(ic,jc,kc,n);
+        });
+    }
+}
+
 void
 MLCellLinOp::reflux (int crse_amrlev,
                      MultiFab& res, const MultiFab& crse_sol, const MultiFab&,
@@ -747,6 +1132,8 @@ MLCellLinOp::prepareForSolve ()
 {
     BL_PROFILE("MLCellLinOp::prepareForSolve()");
 
+    m_cheby_lambda.clear();
+
     const int imaxorder = maxorder;
     const int ncomp = getNComp();
     for (int amrlev = 0;  amrlev < m_num_amr_levels; ++amrlev)
@@ -1003,6 +1390,7 @@ void
 MLCellLinOp::update ()
 {
     if (MLLinOp::needsUpdate()) MLLinOp::update();
+    m_cheby_lambda.clear();
 }
 
 #ifdef AMREX_SOFT_PERF_COUNTERS
@@ -1642,6 +1642,8 @@ MLEBABecLap::update ()
 
     averageDownCoeffs();
 
+    m_cheby_lambda.clear();
+
     m_is_singular.clear();
     m_is_singular.resize(m_num_amr_levels, false);
     auto itlo = std::find(m_lobc[0].begin(), m_lobc[0].end(), BCType::Dirichlet);
@@ -0,0 +1,315 @@
+
+#include <AMReX_MLFGMRES.H>
+#include <AMReX_ParallelReduce.H>
+
+#include <cmath>
+#include <iomanip>
+
+namespace amrex {
+
+namespace {
+
+// dst += a * sum_i c[i]*src[i] in fused sweeps of at most MultiFab::max_fused_ops updates
+void add_combination (MultiFab& dst, Real a, const Vector<MultiFab>& src,
+                      const Vector<Real>& c, int n, int ncomp)
+{
+    Vector<MultiFab::LinCombOp> ops;
+    for (int i = 0; i < n; ++i) {
+        ops.emplace_back(dst, a*c[i], src[i]);
+        if (static_cast<int>(ops.size()) == MultiFab::max_fused_ops || i == n-1) {
+            MultiFab::FusedLinComb(ops, ncomp, 0);
+            ops.clear();
+        }
+    }
+}
+
+}
+
+MLFGMRES::MLFGMRES (MLMG& a_mlmg)
+    : mlmg(a_mlmg),
+      linop(a_mlmg.linop)
+{}
+
+MLFGMRES::~MLFGMRES ()
+{}
+
+Real
+MLFGMRES::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs,
+                 Real a_tol_rel, Real a_tol_abs)
+{
+    BL_PROFILE("MLFGMRES::solve()");
+
+    if (linop.NAMRLevels() != 1) {
+        amrex::Abort("MLFGMRES: only a single AMR level is supported");
+    }
+    AMREX_ALWAYS_ASSERT(restart_length > 0);
+
+    Real solve_start_time = amrex::second();
+    timer.assign(ntimers, 0.0);
+    m_iter_resnorm.clear();
+
+    if (mlmg.bottom_solver == BottomSolver::Default) {
+        mlmg.bottom_solver = linop.getDefaultBottomSolver();
+    }
+    if (mlmg.bottom_solver == BottomSolver::hypre) {
+        int mo = linop.getMaxOrder();
+        linop.setMaxOrder(std::min(3,mo));  // maxorder = 4 not supported
+    }
+
+    mlmg.m_niters_cg.clear();
+    mlmg.m_nreductions_cg.clear();
+    mlmg.m_iter_fine_resnorm0.clear();
+
+    mlmg.prepareForSolve(a_sol, a_rhs);
+
+    const int ncomp = linop.getNComp();
+    MultiFab& sol = *mlmg.sol[0];
+    MultiFab& res = mlmg.res[0][0];
+
+    mlmg.computeResidual(0);
+
+    Real resnorm0 = mlmg.ResNormInf(0, true);
+    Real rhsnorm0 = mlmg.MLRhsNormInf(true);
+    ParallelAllReduce::Max<Real>({resnorm0, rhsnorm0}, ParallelContext::CommunicatorSub());
+
+    if (verbose >= 1)
+    {
+        amrex::Print() << "MLFGMRES: Initial rhs               = " << rhsnorm0 << "\n"
+                       << "MLFGMRES: Initial residual (resid0) = " << resnorm0 << "\n";
+    }
+
+    m_init_resnorm0 = resnorm0;
+    m_rhsnorm0 = rhsnorm0;
+
+    Real max_norm;
+    std::string norm_name;
+    if (always_use_bnorm or rhsnorm0 >= resnorm0) {
+        norm_name = "bnorm";
+        max_norm = rhsnorm0;
+    } else {
+        norm_name = "resid0";
+        max_norm = resnorm0;
+    }
+    const Real res_target = std::max(a_tol_abs, std::max(a_tol_rel,1.e-16_rt)*max_norm);
+
+    Real resnorm = resnorm0;
+
+    if (resnorm0 <= res_target) {
+        if (verbose >= 1) {
+            amrex::Print() << "MLFGMRES: No iterations needed\n";
+        }
+    } else {
+        Real iter_start_time = amrex::second();
+
+        allocate(res);
+
+        const int m = restart_length;
+        Vector<Real> H((m+1)*m, 0.0);
+        auto h = [&H,m] (int i, int j) -> Real& { return H[i*m+j]; };
+        Vector<Real> cs(m), sn(m), g(m+1), y(m);
+
+        int iter = 0;
+        bool converged = false;
+        while (iter < max_iters)
+        {
+            // res = rhs - L(sol)
+            const Real beta = norm2(res);
+            if (beta == 0.0) {
+                converged = true;
+                break;
+            }
+            // The Arnoldi residual is a 2-norm.  Stop at the same reduction
+            // as needed for the max norm and then check the true residual.
+            const Real target2 = beta * (res_target/resnorm);
+
+            MultiFab::LinComb(m_v[0], 1.0/beta, res, 0, 0.0, res, 0, 0, ncomp, 0);
+            std::fill(H.begin(), H.end(), 0.0);
+            std::fill(g.begin(), g.end(), 0.0);
+            g[0] = beta;
+
+            int nk = 0;
+            while (nk < m && iter < max_iters)
+            {
+                const int j = nk++;
+                ++iter;
+
+                precondition(m_z[j], m_v[j]);
+                linop.apply(0, 0, m_v[j+1], m_z[j], MLLinOp::BCMode::Homogeneous,
+                            MLLinOp::StateMode::Correction);
+
+                // Classical Gram-Schmidt with one reorthogonalization, so
+                // that each pass needs only one global reduction.
+                Vector<Real> hcol(j+1);
+                for (int pass = 0; pass < 2; ++pass) {
+                    for (int i = 0; i <= j; ++i) {
+                        hcol[i] = linop.xdoty(0, 0, m_v[i], m_v[j+1], true);
+                    }
+                    ParallelAllReduce::Sum(hcol.data(), j+1, ParallelContext::CommunicatorSub());
+                    add_combination(m_v[j+1], -1.0, m_v, hcol, j+1, ncomp);
+                    for (int i = 0; i <= j; ++i) {
+                        h(i,j) += hcol[i];
+                    }
+                }
+
+                const Real hnext = norm2(m_v[j+1]);
+                h(j+1,j) = hnext;
+                if (hnext > 0.0) {
+                    m_v[j+1].mult(1.0/hnext, 0, ncomp, 0);
+                }
+
+                // Givens rotations for the least squares problem
+                for (int i = 0; i < j; ++i) {
+                    Real t = cs[i]*h(i,j) + sn[i]*h(i+1,j);
+                    h(i+1,j) = -sn[i]*h(i,j) + cs[i]*h(i+1,j);
+                    h(i,j) = t;
+                }
+                Real r = std::sqrt(h(j,j)*h(j,j) + h(j+1,j)*h(j+1,j));
+                cs[j] = (r > 0.0) ? h(j,j)/r : 1.0;
+                sn[j] = (r > 0.0) ? h(j+1,j)/r : 0.0;
+                h(j,j) = r;
+                h(j+1,j) = 0.0;
+                g[j+1] = -sn[j]*g[j];
+                g[j] = cs[j]*g[j];
+
+                const Real est = std::abs(g[j+1]);
+                m_iter_resnorm.push_back(est);
+                if (verbose >= 2) {
+                    amrex::Print() << "MLFGMRES: Iteration " << std::setw(3) << iter
+                                   << " estimated resid/" << norm_name << " = "
+                                   << est*(resnorm/beta)/max_norm << "\n";
+                }
+
+                if (est <= target2 || hnext == 0.0) break;
+            }
+
+            // y = H^{-1} g; sol += Z y
+            for (int i = nk-1; i >= 0; --i) {
+                Real t = g[i];
+                for (int k = i+1; k < nk; ++k) {
+                    t -= h(i,k)*y[k];
+                }
+                y[i] = t/h(i,i);
+            }
+            add_combination(sol, 1.0, m_z, y, nk, ncomp);
+
+            mlmg.computeResidual(0);
+            resnorm = mlmg.ResNormInf(0);
+            if (verbose >= 2) {
+                amrex::Print() << "MLFGMRES: Iteration " << std::setw(3) << iter
+                               << " resid/" << norm_name << " = " << resnorm/max_norm << "\n";
+            }
+
+            if (resnorm <= res_target) {
+                converged = true;
+                break;
+            } else if (resnorm > 1.e20*max_norm) {
+                if (verbose > 0) {
+                    amrex::Print() << "MLFGMRES: Failing to converge after " << iter << " iterations."
+                                   << " resid, resid/" << norm_name << " = "
+                                   << resnorm << ", " << resnorm/max_norm << "\n";
+                }
+                amrex::Abort("MLFGMRES failing so lets stop here");
+            }
+        }
+
+        if (converged) {
+            if (verbose >= 1) {
+                amrex::Print() << "MLFGMRES: Final Iter. " << iter
+                               << " resid, resid/" << norm_name << " = "
+                               << resnorm << ", " << resnorm/max_norm << "\n";
+            }
+        } else {
+            if (verbose > 0) {
+                amrex::Print() << "MLFGMRES: Failed to converge after " << iter << " iterations."
+                               << " resid, resid/" << norm_name << " = "
+                               << resnorm << ", " << resnorm/max_norm << "\n";
+            }
+            amrex::Abort("MLFGMRES failed");
+        }
+
+        timer[iter_time] = amrex::second() - iter_start_time;
+    }
+
+    m_final_resnorm0 = resnorm;
+
+    int ng_back = mlmg.final_fill_bc ? 1 : 0;
+    if (a_sol[0] != mlmg.sol[0]) {
+        MultiFab::Copy(*a_sol[0], sol, 0, 0, ncomp, ng_back);
+    }
+
+    timer[solve_time] = amrex::second() - solve_start_time;
+    if (verbose >= 1) {
+        Vector<Real> t = timer;
+        t.push_back(mlmg.timer[MLMG::bottom_time]);
+        ParallelReduce::Max<Real>(t.data(), t.size(), 0, ParallelContext::CommunicatorSub());
+        if (ParallelContext::MyProcSub() == 0)
+        {
+            amrex::AllPrint() << "MLFGMRES: Timers: Solve = " << t[solve_time]
+                              << " Iter = " << t[iter_time]
+                              << " Precond = " << t[precond_time]
+                              << " Bottom = " << t[ntimers] << "\n";
+        }
+    }
+
+    ++mlmg.solve_called;
+
+    return resnorm;
+}
+
+void
+MLFGMRES::allocate (const MultiFab& a)
+{
+    const int m = restart_length;
+    if (static_cast<int>(m_v.size()) == m+1 &&
+        m_v[0].boxArray() == a.boxArray() &&
+        m_v[0].DistributionMap() == a.DistributionMap()) {
+        return;
+    }
+
+    const int ncomp = linop.getNComp();
+    m_v.clear();
+    m_z.clear();
+    m_v.resize(m+1);
+    m_z.resize(m);
+    for (int i = 0; i <= m; ++i) {
+        m_v[i].define(a.boxArray(), a.DistributionMap(), ncomp, 0, MFInfo(), *linop.Factory(0));
+    }
+    // The preconditioned vectors are operator inputs and need a ghost cell.
+    for (int i = 0; i < m; ++i) {
+        m_z[i].define(a.boxArray(), a.DistributionMap(), ncomp, 1, MFInfo(), *linop.Factory(0));
+    }
+}
+
+// z = one V-cycle applied to v with zero initial guess
+void
+MLFGMRES::precondition (MultiFab& z, const MultiFab& v)
+{
+    BL_PROFILE("MLFGMRES::precondition()");
+    Real t0 = amrex::second();
+
+    const int ncomp = linop.getNComp();
+    MultiFab& res = mlmg.res[0][0];
+    MultiFab::Copy(res, v, 0, 0, ncomp, 0);
+
+    if (linop.isSingular(0)) {
+        mlmg.makeSolvable(0, 0, res);
+    }
+
+    if (mlmg.use_mixed_precision) {
+        mlmg.mgVcycleFloat();
+    } else {
+        mlmg.mgVcycle(0, 0);
+    }
+
+    MultiFab::Copy(z, *mlmg.cor[0][0], 0, 0, ncomp, 0);
+
+    timer[precond_time] += amrex::second() - t0;
+}
+
+Real
+MLFGMRES::norm2 (const MultiFab& a) const
+{
+    return std::sqrt(linop.xdoty(0, 0, a, a, false));
+}
+
+}
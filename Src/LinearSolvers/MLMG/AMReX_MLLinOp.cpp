@@ -136,6 +136,8 @@ MLLinOp::define (const Vector<Geometry>& a_geom,
 
     BL_PROFILE("MLLinOp::define()");
 
+    Real define_start_time = amrex::second();
+
     if (!initialized) {
         Initialize();
     }
@@ -166,6 +168,8 @@ MLLinOp::define (const Vector<Geometry>& a_geom,
     defineGrids(a_geom, a_grids, a_dmap, a_factory);
     defineAuxData();
     defineBC();
+
+    m_define_time = amrex::second() - define_start_time;
 }
 
 void
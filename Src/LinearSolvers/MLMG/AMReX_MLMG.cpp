@@ -74,6 +74,7 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
     Real& composite_norminf = m_final_resnorm0;
 
     m_niters_cg.clear();
+    m_nreductions_cg.clear();
     m_iter_fine_resnorm0.clear();
 
     prepareForSolve(a_sol, a_rhs);
@@ -109,6 +110,10 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
     }
     const Real res_target = std::max(a_tol_abs, std::max(a_tol_rel,1.e-16_rt)*max_norm);
 
+    if (!is_nsolve && componentwise_convergence && ncomp > 1) {
+        resnorm0 = computeComponentWeights(a_tol_rel, a_tol_abs, res_target);
+    }
+
     if (!is_nsolve && resnorm0 <= res_target) {
         composite_norminf = resnorm0;
         if (verbose >= 1) {
@@ -201,13 +206,20 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
 
     timer[solve_time] = amrex::second() - solve_start_time;
     if (verbose >= 1) {
-        ParallelReduce::Max<Real>(timer.data(), timer.size(), 0,
+        Vector<Real> t = timer;
+        t.push_back(m_setup_time_saved);
+        ParallelReduce::Max<Real>(t.data(), t.size(), 0,
                                   ParallelContext::CommunicatorSub());
         if (ParallelContext::MyProcSub() == 0)
         {
-            amrex::AllPrint() << "MLMG: Timers: Solve = " << timer[solve_time]
-                              << " Iter = " << timer[iter_time]
-                              << " Bottom = " << timer[bottom_time] << "\n";
+            amrex::AllPrint() << "MLMG: Timers: Solve = " << t[solve_time]
+                              << " Iter = " << t[iter_time]
+                              << " Bottom = " << t[bottom_time]
+                              << " Setup = " << t[setup_time] << "\n";
+            if (solve_called > 0) {
+                amrex::AllPrint() << "MLMG: Reused setup, time saved so far = " << t[ntimers]
+                                  << " over " << solve_called << " solves\n";
+            }
         }
     }
 
@@ -250,6 +262,8 @@ void MLMG::oneIter (int iter)
 
         if (iter < max_fmg_iters) {
             mgFcycle ();
+        } else if (use_mixed_precision) {
+            mgVcycleFloat ();
         } else {
             mgVcycle (0, 0);
         }
@@ -262,10 +276,11 @@ void MLMG::oneIter (int iter)
         // (Fine AMR correction) = I(Coarse AMR correction)
         interpCorrection(alev);
 
-        MultiFab::Add(*sol[alev], *cor[alev][0], 0, 0, ncomp, nghost);
-
         if (alev != finest_amr_lev) {
-	  MultiFab::Add(*cor_hold[alev][0], *cor[alev][0], 0, 0, ncomp, nghost);
+            MultiFab::FusedLinComb({{*sol[alev], 1.0, *cor[alev][0]},
+                                    {*cor_hold[alev][0], 1.0, *cor[alev][0]}}, ncomp, nghost);
+        } else {
+            MultiFab::Add(*sol[alev], *cor[alev][0], 0, 0, ncomp, nghost);
         }
 
         // Update fine AMR level correction
@@ -273,16 +288,82 @@ void MLMG::oneIter (int iter)
 
         miniCycle(alev);
 
-        MultiFab::Add(*sol[alev], *cor[alev][0], 0, 0, ncomp, nghost);
-
         if (alev != finest_amr_lev) {
-	  MultiFab::Add(*cor[alev][0], *cor_hold[alev][0], 0, 0, ncomp, nghost);
+            MultiFab::FusedLinComb({{*sol[alev], 1.0, *cor[alev][0]},
+                                    {*cor[alev][0], 1.0, *cor_hold[alev][0]}}, ncomp, nghost);
+        } else {
+            MultiFab::Add(*sol[alev], *cor[alev][0], 0, 0, ncomp, nghost);
         }
     }
 
     averageDownAndSync();
 }
 
+// V-cycle on the coarsest AMR level with smoothing, residual, restriction and
+// interpolation of the correction done in single precision.
+// in   : res[0][0]
+// out  : cor[0][0]
+void
+MLMG::mgVcycleFloat ()
+{
+    BL_PROFILE("MLMG::mgVcycleFloat()");
+
+    const int amrlev = 0;
+    const int ncomp = linop.getNComp();
+    const int mglev_bottom = linop.NMGLevels(amrlev) - 1;
+    AMREX_ASSERT(mglev_bottom > 0);
+
+    amrex::CastCopy(res_f[0], res[amrlev][0], 0, 0, ncomp, 0);
+
+    for (int mglev = 0; mglev < mglev_bottom; ++mglev)
+    {
+        cor_f[mglev].setVal(0.0f);
+        bool skip_fillboundary = true;
+        for (int i = 0; i < nu1; ++i) {
+            linop.smoothFloat(amrlev, mglev, cor_f[mglev], res_f[mglev], skip_fillboundary);
+            skip_fillboundary = false;
+        }
+
+        // rescor = res - L(cor)
+        linop.correctionResidualFloat(amrlev, mglev, rescor_f[mglev], cor_f[mglev], res_f[mglev]);
+
+        // res_crse = R(rescor_fine)
+        linop.restrictionFloat(amrlev, mglev+1, res_f[mglev+1], rescor_f[mglev]);
+    }
+
+    // The bottom solver works in double precision.
+    BL_PROFILE_VAR("MLMG::mgVcycle_bottom", blp_bottom);
+    amrex::CastCopy(res[amrlev][mglev_bottom], res_f[mglev_bottom], 0, 0, ncomp, 0);
+    bottomSolve();
+    amrex::CastCopy(cor_f[mglev_bottom], *cor[amrlev][mglev_bottom], 0, 0, ncomp, 0);
+    BL_PROFILE_VAR_STOP(blp_bottom);
+
+    for (int mglev = mglev_bottom-1; mglev >= 0; --mglev)
+    {
+        // cor_fine += I(cor_crse)
+        const fMultiFab& crse_cor = cor_f[mglev+1];
+        fMultiFab&       fine_cor = cor_f[mglev  ];
+        if (amrex::isMFIterSafe(crse_cor, fine_cor))
+        {
+            linop.interpolationFloat(amrlev, mglev, fine_cor, crse_cor);
+        }
+        else
+        {
+            BoxArray cba = fine_cor.boxArray();
+            cba.coarsen(linop.mg_coarsen_ratio_vec[mglev]);
+            fMultiFab cfine(cba, fine_cor.DistributionMap(), ncomp, 0);
+            cfine.ParallelCopy(crse_cor);
+            linop.interpolationFloat(amrlev, mglev, fine_cor, cfine);
+        }
+
+        for (int i = 0; i < nu2; ++i) {
+            linop.smoothFloat(amrlev, mglev, fine_cor, res_f[mglev]);
+        }
+    }
+
+    amrex::CastCopy(*cor[amrlev][0], cor_f[0], 0, 0, ncomp, 0);
+}
+
 // Compute multi-level Residual (res) up to amrlevmax.
 void
 MLMG::computeMLResidual (int amrlevmax)
@@ -943,12 +1024,20 @@ MLMG::actualBottomSolve ()
         {
             bottomSolveWithPETSc(x, *bottom_b);
         }
+        else if (bottom_solver == BottomSolver::fft)
+        {
+            bottomSolveWithFFT(x, *bottom_b);
+        }
         else
         {
             MLCGSolver::Type cg_type;
             if (bottom_solver == BottomSolver::cg ||
                 bottom_solver == BottomSolver::cgbicg) {
                 cg_type = MLCGSolver::Type::CG;
+            } else if (bottom_solver == BottomSolver::pipecg) {
+                cg_type = MLCGSolver::Type::PipeCG;
+            } else if (bottom_solver == BottomSolver::cabicgstab) {
+                cg_type = MLCGSolver::Type::CABiCGStab;
             } else {
                 cg_type = MLCGSolver::Type::BiCGStab;
             }
@@ -994,6 +1083,7 @@ MLMG::bottomSolveWithCG (MultiFab& x, const MultiFab& b, MLCGSolver::Type type)
     cg_solver.setSolver(type);
     cg_solver.setVerbose(bottom_verbose);
     cg_solver.setMaxIter(bottom_maxiter);
+    cg_solver.setSStep(bottom_sstep);
     if (cf_strategy == CFStrategy::ghostnodes) cg_solver.setNGhost(linop.getNGrow());
 
     int ret = cg_solver.solve(x, b, bottom_reltol, bottom_abstol);
@@ -1001,42 +1091,61 @@ MLMG::bottomSolveWithCG (MultiFab& x, const MultiFab& b, MLCGSolver::Type type)
         amrex::Print() << "MLMG: Bottom solve failed.\n";
     }
     m_niters_cg.push_back(cg_solver.getNumIters());
+    m_nreductions_cg.push_back(cg_solver.getNumReductions());
     return ret;
 }
 
 // Compute single-level masked inf-norm of Residual (res).
-Real
-MLMG::ResNormInf (int alev, bool local)
+// Accumulates the masked inf-norm of each component of mf on AMR level alev
+// into norms (local).
+void
+MLMG::compNormInf (int alev, const MultiFab& mf, Real* norms)
 {
-    BL_PROFILE("MLMG::ResNormInf()");
     const int ncomp = linop.getNComp();
-    const int mglev = 0;
-    Real norm = 0.0;
-    MultiFab* pmf = &(res[alev][mglev]);
+    const MultiFab* pmf = &mf;
 #ifdef AMREX_USE_EB
     if (linop.isCellCentered() && scratch[alev]) {
-        pmf = scratch[alev].get();
-        MultiFab::Copy(*pmf, res[alev][mglev], 0, 0, ncomp, 0);
+        MultiFab* p = scratch[alev].get();
+        MultiFab::Copy(*p, mf, 0, 0, ncomp, 0);
         auto factory = dynamic_cast<EBFArrayBoxFactory const*>(linop.Factory(alev));
         if (factory) {
             const MultiFab& vfrac = factory->getVolFrac();
             for (int n=0; n < ncomp; ++n) {
-                MultiFab::Multiply(*pmf, vfrac, 0, n, 1, 0);
+                MultiFab::Multiply(*p, vfrac, 0, n, 1, 0);
             }
         } else {
-            amrex::Abort("MLMG::ResNormInf: not EB Factory");
+            amrex::Abort("MLMG::compNormInf: not EB Factory");
         }
+        pmf = p;
     }
 #endif
     for (int n = 0; n < ncomp; n++)
     {
-	Real newnorm = 0.0;
-	if (fine_mask[alev]) {
+        Real newnorm = 0.0;
+        if (fine_mask[alev]) {
             newnorm = pmf->norm0(*fine_mask[alev],n,0,true);
-	} else {
+        } else {
             newnorm = pmf->norm0(n,0,true);
-	}
-        norm = std::max(norm, newnorm);
+        }
+        norms[n] = std::max(norms[n], newnorm);
+    }
+}
+
+Real
+MLMG::ResNormInf (int alev, bool local)
+{
+    BL_PROFILE("MLMG::ResNormInf()");
+    const int ncomp = linop.getNComp();
+    Vector<Real> norms(ncomp, 0.0);
+    compNormInf(alev, res[alev][0], norms.data());
+    Real norm = 0.0;
+    for (int n = 0; n < ncomp; n++)
+    {
+        if (m_comp_weight.empty()) {
+            norm = std::max(norm, norms[n]);
+        } else {
+            norm = std::max(norm, norms[n]*m_comp_weight[n]);
+        }
     }
     if (!local) ParallelAllReduce::Max(norm, ParallelContext::CommunicatorSub());
     return norm;
@@ -1062,35 +1171,51 @@ MLMG::MLRhsNormInf (bool local)
 {
     BL_PROFILE("MLMG::MLRhsNormInf()");
     const int ncomp = linop.getNComp();
+    Vector<Real> norms(ncomp, 0.0);
+    for (int alev = 0; alev <= finest_amr_lev; ++alev)
+    {
+        compNormInf(alev, rhs[alev], norms.data());
+    }
     Real r = 0.0;
+    for (int n=0; n<ncomp; ++n) {
+        r = std::max(r, norms[n]);
+    }
+    if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
+    return r;
+}
+
+// For componentwise convergence, scale the residual of each component so
+// that the common target res_target corresponds to the component's own
+// target max(tol_abs, tol_rel*max(|rhs_n|,|resid0_n|)).  The norms of all
+// components are computed with a single reduction.  Returns the weighted
+// initial residual.
+Real
+MLMG::computeComponentWeights (Real a_tol_rel, Real a_tol_abs, Real res_target)
+{
+    const int ncomp = linop.getNComp();
+    Vector<Real> norms(2*ncomp, 0.0);
     for (int alev = 0; alev <= finest_amr_lev; ++alev)
     {
-        MultiFab* pmf = &(rhs[alev]);
-#ifdef AMREX_USE_EB
-        if (linop.isCellCentered() && scratch[alev]) {
-            pmf = scratch[alev].get();
-            MultiFab::Copy(*pmf, rhs[alev], 0, 0, ncomp, 0);
-            auto factory = dynamic_cast<EBFArrayBoxFactory const*>(linop.Factory(alev));
-            if (factory) {
-                const MultiFab& vfrac = factory->getVolFrac();
-                for (int n=0; n < ncomp; ++n) {
-                    MultiFab::Multiply(*pmf, vfrac, 0, n, 1, 0);
-                }
-            } else {
-                amrex::Abort("MLMG::MLRhsNormInf: not EB Factory");
-            }
-        }
-#endif
-        for (int n=0; n<ncomp; ++n)
-        {
-            if (alev < finest_amr_lev) {
-                r = std::max(r, pmf->norm0(*fine_mask[alev],n,0,true));
-            } else {
-                r = std::max(r, pmf->norm0(n,0,true));
-            }
+        compNormInf(alev, res[alev][0], norms.data());
+        compNormInf(alev, rhs[alev], norms.data()+ncomp);
+    }
+    ParallelAllReduce::Max(norms.data(), 2*ncomp, ParallelContext::CommunicatorSub());
+
+    m_comp_weight.resize(ncomp);
+    Real r = 0.0;
+    for (int n = 0; n < ncomp; ++n)
+    {
+        const Real resnorm = norms[n];
+        const Real rhsnorm = norms[ncomp+n];
+        const Real max_norm = (always_use_bnorm or rhsnorm >= resnorm) ? rhsnorm : resnorm;
+        const Real target = std::max(a_tol_abs, std::max(a_tol_rel,1.e-16_rt)*max_norm);
+        m_comp_weight[n] = (target > 0.0) ? res_target/target : 1.0;
+        r = std::max(r, resnorm*m_comp_weight[n]);
+        if (verbose >= 2) {
+            amrex::Print() << "MLMG: Component " << n << ": rhs = " << rhsnorm
+                           << ", resid0 = " << resnorm << "\n";
         }
     }
-    if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
     return r;
 }
 
@@ -1128,6 +1253,9 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     AMREX_ASSERT(namrlevs <= a_rhs.size());
 
     timer.assign(ntimers, 0.0);
+    m_comp_weight.clear();
+
+    Real setup_start_time = amrex::second();
 
     const int ncomp = linop.getNComp();
     int nghost = 0;
@@ -1140,8 +1268,9 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         linop.update();
 
 #ifdef AMREX_USE_HYPRE
+        // The matrix and the AMG hierarchy depend on the coefficients, but
+        // hypre_bndry depends on the grids and the boundary types only.
         hypre_solver.reset();
-        hypre_bndry.reset();
         hypre_node_solver.reset();
 #endif
 
@@ -1274,6 +1403,28 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         cor_hold[alev][0]->setVal(0.0);
     }
 
+    use_mixed_precision = do_mixed_precision && linop.supportsMixedPrecision()
+        && linop.getSmoother() == Smoother::gsrb
+        && cf_strategy == CFStrategy::none && linop.NMGLevels(0) > 1;
+    if (use_mixed_precision)
+    {
+        const int nmglevs = linop.NMGLevels(0);
+        if (res_f.empty()) {
+            res_f.resize(nmglevs);
+            cor_f.resize(nmglevs);
+            rescor_f.resize(nmglevs);
+            for (int mglev = 0; mglev < nmglevs; ++mglev)
+            {
+                const BoxArray& ba = res[0][mglev].boxArray();
+                const DistributionMapping& dm = res[0][mglev].DistributionMap();
+                res_f   [mglev].define(ba, dm, ncomp, 0);
+                cor_f   [mglev].define(ba, dm, ncomp, 1);
+                rescor_f[mglev].define(ba, dm, ncomp, 0);
+            }
+        }
+        linop.prepareForMixedPrecision();
+    }
+
     buildFineMask();
 
     if (!solve_called)
@@ -1302,6 +1453,13 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         prepareForNSolve();
     }
 
+    timer[setup_time] = amrex::second() - setup_start_time;
+    if (!solve_called) {
+        m_full_setup_time = linop.getDefineTime() + timer[setup_time];
+    } else {
+        m_setup_time_saved += std::max(m_full_setup_time - timer[setup_time], 0.0_rt);
+    }
+
     if (verbose >= 2) {
         amrex::Print() << "MLMG: # of AMR levels: " << namrlevs << "\n"
                        << "      # of MG levels on the coarsest AMR level: " << linop.NMGLevels(0)
@@ -1310,6 +1468,9 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
             amrex::Print() << "      # of MG levels in N-Solve: " << ns_linop->NMGLevels(0) << "\n"
                            << "      # of grids in N-Solve: " << ns_linop->m_grids[0][0].size() << "\n";
         }
+        if (use_mixed_precision) {
+            amrex::Print() << "      Mixed-precision V-cycle on the coarsest AMR level\n";
+        }
     }
 }
 
@@ -1844,7 +2005,10 @@ MLMG::bottomSolveWithHypre (MultiFab& x, const MultiFab& b)
             hypre_solver->setHypreRelaxOrder(hypre_relax_order);
             hypre_solver->setHypreNumSweeps(hypre_num_sweeps);
             hypre_solver->setHypreStrongThreshold(hypre_strong_threshold);
+        }
 
+        if (hypre_bndry == nullptr)  // Kept when only the coefficients change
+        {
             const BoxArray& ba = linop.m_grids[amrlev].back();
             const DistributionMapping& dm = linop.m_dmap[amrlev].back();
             const Geometry& geom = linop.m_geom[amrlev].back();
@@ -1912,6 +2076,23 @@ MLMG::bottomSolveWithPETSc (MultiFab& x, const MultiFab& b)
 #endif
 }
 
+void
+MLMG::bottomSolveWithFFT (MultiFab& x, const MultiFab& b)
+{
+#if !defined(AMREX_USE_SWFFT)
+    amrex::ignore_unused(x,b);
+    amrex::Abort("bottomSolveWithFFT is called without building with SWFFT");
+#else
+    // The FFT solver depends on the bottom geometry only, so it is kept
+    // when the coefficients are updated.
+    if (fft_solver == nullptr)
+    {
+        fft_solver = linop.makeSWFFT();
+    }
+    fft_solver->solve(x, b);
+#endif
+}
+
 void
 MLMG::checkPoint (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs,
                   Real a_tol_rel, Real a_tol_abs, const char* a_file_name) const
@@ -135,6 +135,7 @@ void
 MLNodeLaplacian::setSigma (int amrlev, const MultiFab& a_sigma)
 {
     MultiFab::Copy(*m_sigma[amrlev][0][0], a_sigma, 0, 0, 1, 0);
+    m_needs_update = true;
 }
 
 void
@@ -862,11 +863,13 @@ MLNodeLaplacian::buildStencil ()
     {
         for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
         {
-            const int nghost = (0 == amrlev && mglev+1 == m_num_mg_levels[amrlev]) ? 1 : 4;
-            m_stencil[amrlev][mglev].reset
-                (new MultiFab(amrex::convert(m_grids[amrlev][mglev],
-                                             IntVect::TheNodeVector()),
-                              m_dmap[amrlev][mglev], ncomp_s, nghost));
+            if (m_stencil[amrlev][mglev] == nullptr) {
+                const int nghost = (0 == amrlev && mglev+1 == m_num_mg_levels[amrlev]) ? 1 : 4;
+                m_stencil[amrlev][mglev].reset
+                    (new MultiFab(amrex::convert(m_grids[amrlev][mglev],
+                                                 IntVect::TheNodeVector()),
+                                  m_dmap[amrlev][mglev], ncomp_s, nghost));
+            }
             m_stencil[amrlev][mglev]->setVal(0.0);
         }
 
@@ -1100,6 +1103,21 @@ MLNodeLaplacian::prepareForSolve ()
 #endif
 
     buildStencil();
+
+    m_needs_update = false;
+}
+
+void
+MLNodeLaplacian::update ()
+{
+    BL_PROFILE("MLNodeLaplacian::update()");
+
+    // Masks, integrals and the stencil MultiFabs are kept; only the
+    // coefficients on the coarse levels are recomputed.
+    averageDownCoeffs();
+    buildStencil();
+
+    m_needs_update = false;
 }
 
 void
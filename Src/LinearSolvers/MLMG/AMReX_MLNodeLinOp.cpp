@@ -30,6 +30,8 @@ MLNodeLinOp::define (const Vector<Geometry>& a_geom,
 #endif
     MLLinOp::define(a_geom, a_grids, a_dmap, a_info, a_factory, eb_limit_coarsening);
 
+    Real t0 = amrex::second();
+
     m_owner_mask.resize(m_num_amr_levels);
     m_dirichlet_mask.resize(m_num_amr_levels);
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev) {
@@ -64,6 +66,8 @@ MLNodeLinOp::define (const Vector<Geometry>& a_geom,
         }
         m_has_fine_bndry[amrlev].reset(new LayoutData<int>(m_grids[amrlev][0], m_dmap[amrlev][0]));
     }
+
+    m_define_time += amrex::second() - t0;
 }
 
 std::unique_ptr<iMultiFab>
@@ -0,0 +1,308 @@
+
+#include <AMReX_MLSolutionHistory.H>
+#include <AMReX_ParallelReduce.H>
+
+#include <algorithm>
+#include <cmath>
+
+namespace amrex {
+
+namespace {
+
+// dst = sum_i c[i]*x[i][lev] in fused sweeps of at most MultiFab::max_fused_ops updates
+void set_combination (MultiFab& dst, const Vector<Real>& c,
+                      const Vector<Vector<MultiFab> >& x, int lev)
+{
+    const int ncomp = dst.nComp();
+    const int n = c.size();
+    dst.setVal(0.0, 0, ncomp, 0);
+    Vector<MultiFab::LinCombOp> ops;
+    for (int i = 0; i < n; ++i) {
+        if (c[i] != 0.0) {
+            ops.emplace_back(dst, c[i], x[i][lev]);
+        }
+        if (static_cast<int>(ops.size()) == MultiFab::max_fused_ops ||
+            (i == n-1 && !ops.empty())) {
+            MultiFab::FusedLinComb(ops, ncomp, 0);
+            ops.clear();
+        }
+    }
+}
+
+}
+
+MLSolutionHistory::MLSolutionHistory (int a_max_size, Method a_method)
+    : m_max_size(a_max_size),
+      m_method(a_method)
+{
+    AMREX_ALWAYS_ASSERT(m_max_size >= 0);
+}
+
+void
+MLSolutionHistory::setMaxSize (int a_max_size)
+{
+    AMREX_ALWAYS_ASSERT(a_max_size >= 0);
+    m_max_size = a_max_size;
+    if (static_cast<int>(m_hist.size()) > m_max_size) {
+        m_hist.resize(m_max_size);
+    }
+}
+
+Real
+MLSolutionHistory::solve (MLMG& mlmg, const Vector<MultiFab*>& a_sol,
+                          const Vector<MultiFab const*>& a_rhs,
+                          Real a_tol_rel, Real a_tol_abs)
+{
+    BL_PROFILE("MLSolutionHistory::solve()");
+
+    if (!isCompatible(a_sol)) {
+        m_hist.clear();
+    }
+
+    const int verbose = mlmg.getVerbose();
+    const int nhist = m_hist.size();
+
+    Real base_resnorm = -1.0;
+    Real guess_resnorm = -1.0;
+    if (nhist > 0)
+    {
+        if (verbose >= 1) {
+            base_resnorm = resNorm(mlmg, a_sol, a_rhs);
+        }
+        makeGuess(mlmg, a_sol, a_rhs);
+        if (verbose >= 1) {
+            guess_resnorm = resNorm(mlmg, a_sol, a_rhs);
+        }
+    }
+
+    Real r = mlmg.solve(a_sol, a_rhs, a_tol_rel, a_tol_abs);
+
+    const int niters = mlmg.getNumIters();
+    const Real resnorm0 = mlmg.getInitResidual();
+    const Real resnorm = mlmg.getFinalResidual();
+    if (niters > 0 && resnorm0 > 0.0 && resnorm > 0.0 && resnorm < resnorm0) {
+        m_rho = std::pow(resnorm/resnorm0, 1.0_rt/niters);
+    }
+
+    m_iters_saved = 0.0;
+    if (nhist > 0 && verbose >= 1)
+    {
+        if (base_resnorm > 0.0 && guess_resnorm > 0.0 && m_rho > 0.0 && m_rho < 1.0) {
+            m_iters_saved = std::log(base_resnorm/guess_resnorm) / (-std::log(m_rho));
+        }
+        m_total_iters_saved += m_iters_saved;
+        amrex::Print() << "MLMG: Initial guess from " << nhist << " previous solutions ("
+                       << (m_method == Method::projection ? "projection" : "extrapolation")
+                       << "): resid " << guess_resnorm << ", resid of the given guess "
+                       << base_resnorm << "\n"
+                       << "MLMG: Estimated V-cycles saved = " << m_iters_saved
+                       << ", total = " << m_total_iters_saved << "\n";
+    }
+
+    push(a_sol);
+
+    return r;
+}
+
+bool
+MLSolutionHistory::isCompatible (const Vector<MultiFab*>& a_sol) const
+{
+    if (m_hist.empty()) return true;
+    const Vector<MultiFab>& x = m_hist[0];
+    if (x.size() != a_sol.size()) return false;
+    for (int lev = 0, nlevs = a_sol.size(); lev < nlevs; ++lev) {
+        if (x[lev].nComp() != a_sol[lev]->nComp() ||
+            x[lev].boxArray() != a_sol[lev]->boxArray() ||
+            x[lev].DistributionMap() != a_sol[lev]->DistributionMap()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+MLSolutionHistory::makeGuess (MLMG& mlmg, const Vector<MultiFab*>& a_sol,
+                              const Vector<MultiFab const*>& a_rhs)
+{
+    if (m_method == Method::projection) {
+        project(mlmg, a_sol, a_rhs);
+    } else {
+        extrapolate(a_sol);
+    }
+}
+
+// Polynomial extrapolation to the next of equally spaced points,
+// sol = sum_i (-1)^i binomial(n,i+1) x_i
+void
+MLSolutionHistory::extrapolate (const Vector<MultiFab*>& a_sol) const
+{
+    const int n = m_hist.size();
+    Vector<Real> w(n);
+    Real c = 1.0;
+    for (int i = 0; i < n; ++i) {
+        c = c * (n-i) / (i+1);
+        w[i] = (i % 2 == 0) ? c : -c;
+    }
+
+    for (int lev = 0, nlevs = a_sol.size(); lev < nlevs; ++lev) {
+        set_combination(*a_sol[lev], w, m_hist, lev);
+    }
+}
+
+// Minimize |f - sum_i c_i A x_i|, where f = rhs - L(0) and A x_i = L(x_i) - L(0)
+void
+MLSolutionHistory::project (MLMG& mlmg, const Vector<MultiFab*>& a_sol,
+                            const Vector<MultiFab const*>& a_rhs) const
+{
+    BL_PROFILE("MLSolutionHistory::project()");
+
+    const int n = m_hist.size();
+    const int nlevs = a_sol.size();
+
+    auto make = [&] (Vector<MultiFab>& v, int ng) {
+        v.resize(nlevs);
+        for (int lev = 0; lev < nlevs; ++lev) {
+            v[lev].define(a_sol[lev]->boxArray(), a_sol[lev]->DistributionMap(),
+                          a_sol[lev]->nComp(), ng, MFInfo(), a_sol[lev]->Factory());
+        }
+    };
+
+    Vector<MultiFab> f, zero;
+    make(f, 0);
+    make(zero, 1);
+    for (auto& mf : zero) mf.setVal(0.0);
+    mlmg.apply(amrex::GetVecOfPtrs(f), amrex::GetVecOfPtrs(zero));
+
+    Vector<Vector<MultiFab> > y(n);
+    Vector<MultiFab> xtmp;
+    make(xtmp, 1);
+    for (auto& mf : xtmp) mf.setVal(0.0);
+    for (int i = 0; i < n; ++i) {
+        make(y[i], 0);
+        for (int lev = 0; lev < nlevs; ++lev) {
+            MultiFab::Copy(xtmp[lev], m_hist[i][lev], 0, 0, xtmp[lev].nComp(), 0);
+        }
+        mlmg.apply(amrex::GetVecOfPtrs(y[i]), amrex::GetVecOfPtrs(xtmp));
+        for (int lev = 0; lev < nlevs; ++lev) {
+            MultiFab::Subtract(y[i][lev], f[lev], 0, 0, f[lev].nComp(), 0);
+        }
+    }
+    for (int lev = 0; lev < nlevs; ++lev) {
+        MultiFab::LinComb(f[lev], 1.0, *a_rhs[lev], 0, -1.0, f[lev], 0, 0, f[lev].nComp(), 0);
+    }
+
+    // G_ij = (y_i,y_j) for j <= i, followed by h_i = (y_i,f), in one reduction
+    auto dot = [&] (const Vector<MultiFab>& a, const Vector<MultiFab>& b) {
+        Real r = 0.0;
+        for (int lev = 0; lev < nlevs; ++lev) {
+            r += MultiFab::Dot(a[lev], 0, b[lev], 0, a[lev].nComp(), 0, true);
+        }
+        return r;
+    };
+    const int ng = n*(n+1)/2;
+    Vector<Real> gh(ng+n);
+    for (int i = 0, k = 0; i < n; ++i) {
+        for (int j = 0; j <= i; ++j) {
+            gh[k++] = dot(y[i], y[j]);
+        }
+        gh[ng+i] = dot(y[i], f);
+    }
+    ParallelAllReduce::Sum(gh.data(), gh.size(), ParallelContext::CommunicatorSub());
+
+    // Cholesky factorization G = L L^T.  Nearly dependent solutions are
+    // dropped.
+    Vector<Real> L(n*n, 0.0);
+    Vector<int> keep(n, 1);
+    Real gmax = 0.0;
+    for (int i = 0; i < n; ++i) {
+        gmax = std::max(gmax, gh[i*(i+1)/2+i]);
+    }
+    if (gmax <= 0.0) return;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j <= i; ++j) {
+            if (!keep[j]) continue;
+            Real s = gh[i*(i+1)/2+j];
+            for (int k = 0; k < j; ++k) {
+                s -= L[i*n+k]*L[j*n+k];
+            }
+            if (j < i) {
+                L[i*n+j] = s / L[j*n+j];
+            } else if (s > 1.e-12*gmax) {
+                L[i*n+i] = std::sqrt(s);
+            } else {
+                keep[i] = 0;
+                for (int k = 0; k < i; ++k) L[i*n+k] = 0.0;
+            }
+        }
+    }
+
+    Vector<Real> c(n, 0.0);
+    for (int i = 0; i < n; ++i) {
+        if (!keep[i]) continue;
+        Real s = gh[ng+i];
+        for (int k = 0; k < i; ++k) s -= L[i*n+k]*c[k];
+        c[i] = s / L[i*n+i];
+    }
+    for (int i = n-1; i >= 0; --i) {
+        if (!keep[i]) continue;
+        Real s = c[i];
+        for (int k = i+1; k < n; ++k) s -= L[k*n+i]*c[k];
+        c[i] = s / L[i*n+i];
+    }
+
+    for (int lev = 0; lev < nlevs; ++lev) {
+        set_combination(*a_sol[lev], c, m_hist, lev);
+    }
+}
+
+void
+MLSolutionHistory::push (const Vector<MultiFab*>& a_sol)
+{
+    if (m_max_size == 0) return;
+
+    const int nlevs = a_sol.size();
+    if (static_cast<int>(m_hist.size()) < m_max_size) {
+        m_hist.emplace(m_hist.begin());
+        m_hist[0].resize(nlevs);
+        for (int lev = 0; lev < nlevs; ++lev) {
+            m_hist[0][lev].define(a_sol[lev]->boxArray(), a_sol[lev]->DistributionMap(),
+                                  a_sol[lev]->nComp(), 0, MFInfo(), a_sol[lev]->Factory());
+        }
+    } else {
+        // Reuse the memory of the oldest solution
+        std::rotate(m_hist.begin(), m_hist.end()-1, m_hist.end());
+    }
+    for (int lev = 0; lev < nlevs; ++lev) {
+        MultiFab::Copy(m_hist[0][lev], *a_sol[lev], 0, 0, a_sol[lev]->nComp(), 0);
+    }
+}
+
+Real
+MLSolutionHistory::resNorm (MLMG& mlmg, const Vector<MultiFab*>& a_sol,
+                            const Vector<MultiFab const*>& a_rhs) const
+{
+    const int nlevs = a_sol.size();
+    Vector<MultiFab> res(nlevs);
+    Vector<MultiFab> x(nlevs);
+    for (int lev = 0; lev < nlevs; ++lev) {
+        const int ncomp = a_sol[lev]->nComp();
+        res[lev].define(a_sol[lev]->boxArray(), a_sol[lev]->DistributionMap(), ncomp, 0,
+                        MFInfo(), a_sol[lev]->Factory());
+        x[lev].define(a_sol[lev]->boxArray(), a_sol[lev]->DistributionMap(), ncomp, 1,
+                      MFInfo(), a_sol[lev]->Factory());
+        x[lev].setVal(0.0);
+        MultiFab::Copy(x[lev], *a_sol[lev], 0, 0, ncomp, 0);
+    }
+    mlmg.apply(amrex::GetVecOfPtrs(res), amrex::GetVecOfPtrs(x));
+    Real r = 0.0;
+    for (int lev = 0; lev < nlevs; ++lev) {
+        MultiFab::Subtract(res[lev], *a_rhs[lev], 0, 0, res[lev].nComp(), 0);
+        for (int n = 0; n < res[lev].nComp(); ++n) {
+            r = std::max(r, res[lev].norminf(n, 0, true));
+        }
+    }
+    ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
+    return r;
+}
+
+}
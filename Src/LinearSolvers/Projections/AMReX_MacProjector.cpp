@@ -154,7 +154,12 @@ MacProjector::project (Real reltol, Real atol)
         MultiFab::Subtract(m_rhs[ilev], divu, 0, 0, 1, 0);
     }
 
-    m_mlmg->solve(amrex::GetVecOfPtrs(m_phi), amrex::GetVecOfConstPtrs(m_rhs), reltol, atol);
+    if (m_history) {
+        m_history->solve(*m_mlmg, amrex::GetVecOfPtrs(m_phi), amrex::GetVecOfConstPtrs(m_rhs),
+                         reltol, atol);
+    } else {
+        m_mlmg->solve(amrex::GetVecOfPtrs(m_phi), amrex::GetVecOfConstPtrs(m_rhs), reltol, atol);
+    }
 
     m_mlmg->getFluxes(amrex::GetVecOfArrOfPtrs(m_fluxes), m_umac_loc);
 
@@ -199,7 +204,12 @@ MacProjector::project (const Vector<MultiFab*>& phi_inout, Real reltol, Real ato
         MultiFab::Copy(m_phi[ilev], *phi_inout[ilev], 0, 0, 1, 0);
     }
 
-    m_mlmg->solve(amrex::GetVecOfPtrs(m_phi), amrex::GetVecOfConstPtrs(m_rhs), reltol, atol);
+    if (m_history) {
+        m_history->solve(*m_mlmg, amrex::GetVecOfPtrs(m_phi), amrex::GetVecOfConstPtrs(m_rhs),
+                         reltol, atol);
+    } else {
+        m_mlmg->solve(amrex::GetVecOfPtrs(m_phi), amrex::GetVecOfConstPtrs(m_rhs), reltol, atol);
+    }
 
     m_mlmg->getFluxes(amrex::GetVecOfArrOfPtrs(m_fluxes), m_umac_loc);
 
@@ -284,12 +294,28 @@ MacProjector::setOptions ()
     {
         m_mlmg->setBottomSolver(MLMG::BottomSolver::cgbicg);
     }
+    else if (bottom_solver == "pipecg")
+    {
+        m_mlmg->setBottomSolver(MLMG::BottomSolver::pipecg);
+    }
+    else if (bottom_solver == "cabicgstab")
+    {
+        m_mlmg->setBottomSolver(MLMG::BottomSolver::cabicgstab);
+    }
     else if (bottom_solver == "hypre")
     {
 #ifdef AMREX_USE_HYPRE
         m_mlmg->setBottomSolver(MLMG::BottomSolver::hypre);
 #else
         amrex::Abort("AMReX was not built with HYPRE support");
+#endif
+    }
+    else if (bottom_solver == "fft")
+    {
+#ifdef AMREX_USE_SWFFT
+        m_mlmg->setBottomSolver(MLMG::BottomSolver::fft);
+#else
+        amrex::Abort("AMReX was not built with SWFFT support");
 #endif
     }
 }
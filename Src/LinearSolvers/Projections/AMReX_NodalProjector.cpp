@@ -166,6 +166,14 @@ NodalProjector::setOptions ()
     {
         m_mlmg->setBottomSolver(MLMG::BottomSolver::cgbicg);
     }
+    else if (bottom_solver == "pipecg")
+    {
+        m_mlmg->setBottomSolver(MLMG::BottomSolver::pipecg);
+    }
+    else if (bottom_solver == "cabicgstab")
+    {
+        m_mlmg->setBottomSolver(MLMG::BottomSolver::cabicgstab);
+    }
 #ifdef AMREX_USE_HYPRE
     else if (bottom_solver == "hypre")
     {
@@ -239,7 +247,11 @@ NodalProjector::project ( Real a_rtol, Real a_atol )
 
     // Solve
     // phi comes out already averaged-down and ready to be used by caller if needed
-    m_mlmg -> solve( GetVecOfPtrs(m_phi), GetVecOfConstPtrs(m_rhs), a_rtol, a_atol );
+    if (m_history) {
+        m_history -> solve( *m_mlmg, GetVecOfPtrs(m_phi), GetVecOfConstPtrs(m_rhs), a_rtol, a_atol );
+    } else {
+        m_mlmg -> solve( GetVecOfPtrs(m_phi), GetVecOfConstPtrs(m_rhs), a_rtol, a_atol );
+    }
 
     // Get fluxes -- fluxes = -  (alpha/beta) * grad(phi)
     m_mlmg -> getFluxes( GetVecOfPtrs(m_fluxes) );
@@ -0,0 +1,152 @@
+//
+// Tests the size-class free lists of CArena under OpenMP, e.g.,
+//
+//     OMP_NUM_THREADS=4 ./main3d.gnu.OMP.ex inputs
+//
+// Blocks are allocated and freed by the threads of OpenMP teams started
+// from two std::threads at once.  Each block is filled with a pattern
+// that is checked before it is freed, which fails if a block is given out
+// twice.  Then blocks parked in the size-class free lists must be reused,
+// after coalescing, by a request of another size class before the arena
+// asks the system for more memory.
+//
+
+#include <AMReX.H>
+#include <AMReX_CArena.H>
+#include <AMReX_OpenMP.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace amrex;
+
+namespace {
+
+std::size_t random_size (std::uint64_t& seed)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    // Mostly FAB-like sizes between 256 B and 1 MB, some larger than a hunk
+    const std::size_t n = (seed >> 33) % (1024*1024);
+    return ((seed >> 20) % 64 == 0) ? CArena::DefaultHunkSize + n : 256 + n;
+}
+
+void stress (CArena& arena, int nalloc, int team, std::atomic<int>& nerrors)
+{
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        const int tid = OpenMP::get_thread_num();
+        std::uint64_t seed = 12345 + 1000*team + tid;
+        std::vector<std::pair<unsigned char*,std::size_t> > live;
+        for (int i = 0; i < nalloc; ++i)
+        {
+            if (live.size() < 16 and (seed >> 40) % 3 != 0) {
+                const std::size_t n = random_size(seed);
+                auto p = static_cast<unsigned char*>(arena.alloc(n));
+                const unsigned char tag = static_cast<unsigned char>(16*team + tid + 1);
+                for (std::size_t k = 0; k < n; k += 64) { p[k] = tag; }
+                p[n-1] = tag;
+                live.emplace_back(p, n);
+            } else if (not live.empty()) {
+                random_size(seed);
+                auto& b = live[(seed >> 35) % live.size()];
+                const unsigned char tag = static_cast<unsigned char>(16*team + tid + 1);
+                bool ok = b.first[b.second-1] == tag;
+                for (std::size_t k = 0; k < b.second; k += 64) { ok = ok and b.first[k] == tag; }
+                if (not ok) ++nerrors;
+                arena.free(b.first);
+                b = live.back();
+                live.pop_back();
+            } else {
+                random_size(seed);
+            }
+        }
+        for (auto const& b : live) {
+            arena.free(b.first);
+        }
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int nalloc = 20000;
+        bool use_size_classes = false;
+        {
+            ParmParse pp;
+            pp.query("nalloc", nalloc);
+            ParmParse ppa("amrex");
+            ppa.query("use_size_classes", use_size_classes);
+        }
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(use_size_classes, "Run with amrex.use_size_classes = 1");
+
+        auto the_arena = dynamic_cast<CArena*>(The_Arena());
+        AMREX_ALWAYS_ASSERT(the_arena != nullptr and the_arena->usingSizeClasses());
+
+        amrex::Print() << "OpenMP threads: " << OpenMP::get_max_threads() << "\n";
+
+        // Two OpenMP teams at the same time
+        {
+            CArena arena(0, ArenaInfo().SetSizeClasses());
+            std::atomic<int> nerrors{0};
+            std::thread t0(stress, std::ref(arena), nalloc, 0, std::ref(nerrors));
+            std::thread t1(stress, std::ref(arena), nalloc, 1, std::ref(nerrors));
+            t0.join();
+            t1.join();
+
+            const auto st = arena.sizeClassStats();
+            amrex::Print() << "stress: hit rate " << st.hitRate()
+                           << ", rounding waste " << st.roundingWaste()
+                           << ", cached bytes " << st.cached_bytes
+                           << ", corrupted blocks " << nerrors.load() << "\n";
+            AMREX_ALWAYS_ASSERT(nerrors.load() == 0);
+            AMREX_ALWAYS_ASSERT(arena.heap_space_actually_used() == 0);
+            AMREX_ALWAYS_ASSERT(st.hits > 0);
+
+            arena.releaseCachedBlocks();
+            AMREX_ALWAYS_ASSERT(arena.sizeClassStats().cached_bytes == 0);
+        }
+
+        // Blocks in the size-class free lists are flushed and coalesced before
+        // the arena grows.
+        {
+            CArena arena(0, ArenaInfo().SetSizeClasses());
+            const std::size_t half = CArena::DefaultHunkSize / 2;
+            const int nthreads = OpenMP::get_max_threads();
+            std::vector<void*> blocks(2*nthreads);
+            for (auto& p : blocks) {
+                p = arena.alloc(half);
+            }
+            const std::size_t used = arena.heap_space_used();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            {
+                const int tid = OpenMP::get_thread_num();
+                arena.free(blocks[2*tid]);
+                arena.free(blocks[2*tid+1]);
+            }
+            AMREX_ALWAYS_ASSERT(arena.sizeClassStats().cached_bytes == 2*nthreads*half);
+
+            // A size class that does not match the cached blocks, and only
+            // fits in a whole hunk.
+            void* p = arena.alloc(half + half/2);
+            amrex::Print() << "flush: heap space before " << used
+                           << ", after " << arena.heap_space_used() << "\n";
+            AMREX_ALWAYS_ASSERT(arena.heap_space_used() == used);
+            AMREX_ALWAYS_ASSERT(arena.sizeClassStats().cached_bytes == 0);
+            arena.free(p);
+        }
+
+        amrex::Print() << "SizeClasses test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,188 @@
+//
+// Tests the pool of AsyncOut writer threads and its memory budget, e.g.,
+//
+//     mpiexec -n 4 ./main3d.gnu.TPROF.MTMPI.MPI.ex inputs
+//
+// with amrex.async_out_nthreads and amrex.async_out_max_bytes set in the
+// inputs file.
+//
+//   * Jobs submitted directly must run on all the writer threads, and the
+//     bytes they reserve must never exceed the budget, unless a job is the
+//     only one holding any.
+//   * MultiFabs written with VisMF::AsyncWrite, both the copying and the
+//     moving version, and a plotfile written with WriteSingleLevelPlotfile
+//     must read back identical to the data at the time of the call and to
+//     the same MultiFabs written with VisMF::Write.  The source of the
+//     copying version is changed right after the call.
+//
+
+#include <AMReX.H>
+#include <AMReX_AsyncOut.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_VisMF.H>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace amrex;
+
+namespace {
+
+void init (MultiFab& mf, int iwrite)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Array4<Real> const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), mf.nComp(), [=] (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = std::sin(0.1*i + 0.2*j + 0.3*k + n) + iwrite;
+        });
+    }
+}
+
+// Whether a and b are identical, ghost cells included.
+bool identical (const MultiFab& a, const MultiFab& b)
+{
+    Long r = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi)
+    {
+        Array4<Real const> const& aa = a.const_array(mfi);
+        Array4<Real const> const& bb = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), a.nComp(), [&] (int i, int j, int k, int n) noexcept
+        {
+            if (aa(i,j,k,n) != bb(i,j,k,n)) ++r;
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(r);
+    return r == 0;
+}
+
+bool check (const std::string& name, bool ok)
+{
+    amrex::Print() << "  " << name << ": " << (ok ? "ok" : "FAILED") << "\n";
+    return ok;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int nwrites = 6;
+        int njobs = 20;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nwrites", nwrites);
+            pp.query("njobs", njobs);
+        }
+        int nthreads = 1;
+        Long max_bytes = 0;
+        {
+            ParmParse pp("amrex");
+            pp.query("async_out_nthreads", nthreads);
+            pp.query("async_out_max_bytes", max_bytes);
+        }
+        AMREX_ALWAYS_ASSERT(AsyncOut::UseAsyncOut());
+
+        bool ok = true;
+
+        // ---- jobs submitted directly
+        {
+            std::mutex mtx;
+            std::set<std::thread::id> ids;
+            std::atomic<Long> held{0};
+            std::atomic<int> nover{0};
+            std::atomic<int> ndone{0};
+            for (int i = 0; i < njobs; ++i) {
+                // ---- sizes from a quarter to the whole budget
+                const Long nbytes = max_bytes > 0 ? max_bytes/4 * (1 + i%4) : 1000;
+                AsyncOut::Reserve(nbytes);
+                const Long h = (held += nbytes);
+                if (max_bytes > 0 and h > max_bytes and h != nbytes) ++nover;
+                AsyncOut::Submit([&, nbytes] ()
+                {
+                    {
+                        std::lock_guard<std::mutex> lck(mtx);
+                        ids.insert(std::this_thread::get_id());
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    held -= nbytes;
+                    ++ndone;
+                }, nbytes);
+            }
+            AsyncOut::Finish();
+            amrex::Print() << "  " << njobs << " jobs ran on " << ids.size() << " threads\n";
+            ok = check("jobs", ndone == njobs && held == 0 && nover == 0 &&
+                       static_cast<int>(ids.size()) == std::min(nthreads, njobs) &&
+                       ids.count(std::this_thread::get_id()) == 0) && ok;
+        }
+
+        Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        Geometry geom(domain, RealBox(AMREX_D_DECL(0.,0.,0.),AMREX_D_DECL(1.,1.,1.)), 0,
+                      {AMREX_D_DECL(1,1,1)});
+
+        // ---- VisMF::AsyncWrite, and WriteSingleLevelPlotfile
+        Vector<MultiFab> expected(nwrites);
+        for (int iwrite = 0; iwrite < nwrites; ++iwrite)
+        {
+            const int ng = iwrite % 2;
+            const std::string name = "asyncout_mf_" + std::to_string(iwrite);
+            MultiFab mf(ba, dm, 1, ng);
+            init(mf, iwrite);
+            expected[iwrite].define(ba, dm, 1, ng);
+            MultiFab::Copy(expected[iwrite], mf, 0, 0, 1, ng);
+
+            VisMF::Write(mf, "sync_mf_" + std::to_string(iwrite));
+            if (iwrite % 3 == 2) {
+                VisMF::AsyncWrite(std::move(mf), name);
+            } else {
+                VisMF::AsyncWrite(mf, name);
+                // ---- the job has its own copy
+                mf.setVal(-1.0);
+            }
+        }
+        WriteSingleLevelPlotfile("asyncout_plt", expected[0], {"phi"}, geom, 0.0, 0);
+        AsyncOut::Finish();
+        ParallelDescriptor::Barrier();
+
+        bool mfok = true;
+        for (int iwrite = 0; iwrite < nwrites; ++iwrite)
+        {
+            const int ng = iwrite % 2;
+            MultiFab mf(ba, dm, 1, ng);
+            MultiFab sync(ba, dm, 1, ng);
+            VisMF::Read(mf, "asyncout_mf_" + std::to_string(iwrite));
+            VisMF::Read(sync, "sync_mf_" + std::to_string(iwrite));
+            mfok = identical(mf, expected[iwrite]) && identical(mf, sync) && mfok;
+        }
+        ok = check("VisMF::AsyncWrite", mfok) && ok;
+
+        {
+            PlotFileData pf("asyncout_plt");
+            MultiFab phi(ba, dm, 1, 0);
+            phi.ParallelCopy(pf.get(0, "phi"));
+            MultiFab phi_ref(ba, dm, 1, 0);
+            MultiFab::Copy(phi_ref, expected[0], 0, 0, 1, 0);
+            ok = check("WriteSingleLevelPlotfile", identical(phi, phi_ref)) && ok;
+        }
+
+        AMREX_ALWAYS_ASSERT(ok);
+        amrex::Print() << "AsyncOut writer pool test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,115 @@
+//
+// Compares the hash and the bounding volume hierarchy (boxarray.use_bvh)
+// used by BoxArray::intersections on a BoxArray with boxes of very
+// different sizes, like after particle-driven refinement.  For each
+// method, the time to build the search structure and the time to find the
+// neighbors of every box are reported.
+//
+
+#include <AMReX.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+namespace {
+
+Long find_neighbors (const BoxArray& ba, int nghost, bool batched, Long& checksum)
+{
+    const int N = ba.size();
+    Long nisects = 0;
+    checksum = 0;
+    if (batched) {
+        Vector<Box> bxs(N);
+        for (int i = 0; i < N; ++i) bxs[i] = ba[i];
+        Vector<std::vector<std::pair<int,Box> > > isects;
+        ba.intersections(bxs, isects, false, IntVect(nghost));
+        for (const auto& v : isects) {
+            nisects += v.size();
+            for (const auto& is : v) checksum += is.first + is.second.numPts();
+        }
+    } else {
+        std::vector<std::pair<int,Box> > isects;
+        for (int i = 0; i < N; ++i) {
+            ba.intersections(ba[i], isects, false, IntVect(nghost));
+            nisects += isects.size();
+            for (const auto& is : isects) checksum += is.first + is.second.numPts();
+        }
+    }
+    return nisects;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 1024;
+        int coarse_size = 64;
+        int fine_size = 8;
+        Real refine_fraction = 0.1;
+        int nghost = 1;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("coarse_size", coarse_size);
+            pp.query("fine_size", fine_size);
+            pp.query("refine_fraction", refine_fraction);
+            pp.query("nghost", nghost);
+        }
+
+        BoxArray cba(Box(IntVect(0), IntVect(n_cell-1)));
+        cba.maxSize(coarse_size);
+
+        BoxList bl;
+        const int nrefine = static_cast<int>(refine_fraction*cba.size());
+        // Refine a cluster of boxes around the center of the domain.
+        const IntVect center(n_cell/2);
+        Vector<std::pair<Long,int> > dist(cba.size());
+        for (int i = 0; i < cba.size(); ++i) {
+            const Box& b = cba[i];
+            const IntVect d = b.smallEnd() - center;
+            dist[i] = std::make_pair(AMREX_D_TERM(Long(d[0])*d[0], + Long(d[1])*d[1], + Long(d[2])*d[2]), i);
+        }
+        std::sort(dist.begin(), dist.end());
+        for (int k = 0; k < cba.size(); ++k) {
+            const Box& b = cba[dist[k].second];
+            if (k < nrefine) {
+                BoxList fbl(b);
+                fbl.maxSize(fine_size);
+                bl.join(fbl);
+            } else {
+                bl.push_back(b);
+            }
+        }
+        BoxArray ba(std::move(bl));
+        amrex::Print() << "BoxArray with " << ba.size() << " boxes\n";
+
+        for (int method = 0; method < 2; ++method)
+        {
+            BoxArray::use_bvh = (method == 1);
+            for (int batched = 0; batched < 2; ++batched)
+            {
+                ba.clear_hash_bin();
+
+                Real t0 = amrex::second();
+                ba.intersects(ba[0]);  // builds the search structure
+                Real t1 = amrex::second();
+                Long checksum;
+                Long n = find_neighbors(ba, nghost, batched, checksum);
+                Real t2 = amrex::second();
+
+                amrex::Print() << (method ? "BVH " : "hash") << (batched ? " batched" : "        ")
+                               << ": build time = " << t1-t0
+                               << ", query time = " << t2-t1
+                               << ", intersections = " << n << ", checksum = " << checksum << "\n";
+            }
+        }
+    }
+    amrex::Finalize();
+}
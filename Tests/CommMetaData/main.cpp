@@ -0,0 +1,231 @@
+//
+// Checks that the communication metadata of FillBoundary (FB),
+// ParallelCopy (CPC) and FillPatchTwoLevels (FPinfo), which are built
+// with OpenMP threads over the boxes, are the same as those built on one
+// thread, e.g.,
+//
+//     OMP_NUM_THREADS=4 mpiexec -n 4 ./main3d.gnu.MPI.OMP.ex inputs
+//
+// It also checks that the FPinfo built with fabarray.distributed_fpinfo
+// has the same coarse patches as the one built without it, and that the
+// local patches are in the order of dst_boxes.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#ifdef AMREX_USE_OMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <tuple>
+
+using namespace amrex;
+
+namespace {
+
+// A copy of the tags of a CommMetaData.
+struct Tags
+{
+    bool threadsafe_loc;
+    bool threadsafe_rcv;
+    FabArrayBase::CopyComTagsContainer loc;
+    FabArrayBase::MapOfCopyComTagContainers snd;
+    FabArrayBase::MapOfCopyComTagContainers rcv;
+
+    explicit Tags (const FabArrayBase::CommMetaData& md)
+        : threadsafe_loc(md.m_threadsafe_loc), threadsafe_rcv(md.m_threadsafe_rcv),
+          loc(*md.m_LocTags), snd(*md.m_SndTags), rcv(*md.m_RcvTags)
+        {}
+};
+
+bool same (const FabArrayBase::CopyComTagsContainer& a, const FabArrayBase::CopyComTagsContainer& b)
+{
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].dbox != b[i].dbox || a[i].sbox != b[i].sbox ||
+            a[i].dstIndex != b[i].dstIndex || a[i].srcIndex != b[i].srcIndex) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool same (const FabArrayBase::MapOfCopyComTagContainers& a,
+           const FabArrayBase::MapOfCopyComTagContainers& b)
+{
+    if (a.size() != b.size()) return false;
+    for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib) {
+        if (ia->first != ib->first || !same(ia->second, ib->second)) return false;
+    }
+    return true;
+}
+
+bool same (const Tags& a, const Tags& b)
+{
+    return a.threadsafe_loc == b.threadsafe_loc && a.threadsafe_rcv == b.threadsafe_rcv
+        && same(a.loc, b.loc) && same(a.snd, b.snd) && same(a.rcv, b.rcv);
+}
+
+void set_num_threads (int nthreads)
+{
+#ifdef AMREX_USE_OMP
+    omp_set_num_threads(nthreads);
+#else
+    amrex::ignore_unused(nthreads);
+#endif
+}
+
+struct Coarsener
+    : public BoxConverter
+{
+    virtual Box doit (const Box& fine) const override {
+        return amrex::coarsen(amrex::grow(fine,1), 2);
+    }
+    virtual BoxConverter* clone () const override {
+        return new Coarsener(*this);
+    }
+};
+
+using Patch = std::tuple<IntVect,IntVect,int>;
+
+// The coarse patches, sorted, and the ones of this process in their order.
+void patches (const FabArrayBase::FPinfo& fpi, Vector<Patch>& all, Vector<Box>& mine)
+{
+    all.clear();
+    mine.clear();
+    for (int i = 0; i < fpi.ba_crse_patch.size(); ++i) {
+        const Box& bx = fpi.ba_crse_patch[i];
+        all.emplace_back(bx.smallEnd(), bx.bigEnd(), fpi.dm_crse_patch[i]);
+        if (fpi.dm_crse_patch[i] == ParallelDescriptor::MyProc()) {
+            mine.push_back(bx);
+        }
+    }
+    std::sort(all.begin(), all.end());
+}
+
+bool check (const std::string& name, bool ok)
+{
+    bool allok = ok;
+    ParallelDescriptor::ReduceBoolAnd(allok);
+    amrex::Print() << "  " << name << ": " << (allok ? "same" : "DIFFERENT") << "\n";
+    return allok;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int nghost = 2;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nghost", nghost);
+        }
+
+#ifdef AMREX_USE_OMP
+        const int nthreads = omp_get_max_threads();
+#else
+        const int nthreads = 1;
+#endif
+        amrex::Print() << "Comparing metadata built on 1 and " << nthreads << " threads\n";
+
+        const int n = n_cell;
+        Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(n-1,n-1,n-1)));
+        const Periodicity period(IntVect(AMREX_D_DECL(n,n,n)));
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        // ---- another decomposition of the domain, for ParallelCopy
+        BoxArray ba2(domain);
+        ba2.maxSize(max_grid_size/2);
+        DistributionMapping dm2(ba2);
+
+        // ---- a fine level that does not cover its domain
+        const Box fdomain = amrex::refine(domain, 2);
+        BoxList fbl;
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(n/2,n/2,n/2)), IntVect(AMREX_D_DECL(3*n/2-1,3*n/2-1,3*n/2-1))));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(3*n/2,n/2,n/2)), IntVect(AMREX_D_DECL(2*n-1,n-1,n-1))));
+        BoxArray fba(std::move(fbl));
+        fba.maxSize(max_grid_size);
+        DistributionMapping fdm(fba);
+
+        MultiFab mf(ba, dm, 1, nghost);
+        MultiFab mf2(ba2, dm2, 1, nghost);
+        MultiFab fmf(fba, fdm, 1, nghost);
+
+        bool ok = true;
+
+        // ---- FillBoundary
+        for (int cross = 0; cross <= 1; ++cross)
+        {
+            set_num_threads(1);
+            Tags serial(mf.getFB(mf.nGrowVect(), period, cross));
+            mf.flushFB();
+            set_num_threads(nthreads);
+            Tags threaded(mf.getFB(mf.nGrowVect(), period, cross));
+            mf.flushFB();
+            ok = check(cross ? "FB, cross" : "FB", same(serial, threaded)) && ok;
+        }
+
+        // ---- ParallelCopy
+        {
+            set_num_threads(1);
+            Tags serial(mf.getCPC(mf.nGrowVect(), mf2, IntVect::TheZeroVector(), period));
+            mf.flushCPC();
+            set_num_threads(nthreads);
+            Tags threaded(mf.getCPC(mf.nGrowVect(), mf2, IntVect::TheZeroVector(), period));
+            mf.flushCPC();
+            ok = check("CPC", same(serial, threaded)) && ok;
+        }
+
+        // ---- FillPatchTwoLevels
+        {
+            Coarsener coarsener;
+            const IntVect ng = fmf.nGrowVect();
+            Vector<Patch> all[3];
+            Vector<Box> mine[3];
+            Vector<Box> dst_boxes[3];
+            Vector<int> dst_idxs[3];
+            for (int ibuild = 0; ibuild < 3; ++ibuild) {
+                set_num_threads(ibuild == 0 ? 1 : nthreads);
+                FabArrayBase::distributed_fpinfo = (ibuild == 2);
+                const auto& fpi = FabArrayBase::TheFPinfo(fmf, fmf, fdomain, ng, coarsener,
+                                                          domain, nullptr);
+                patches(fpi, all[ibuild], mine[ibuild]);
+                dst_boxes[ibuild] = fpi.dst_boxes;
+                dst_idxs[ibuild] = fpi.dst_idxs;
+                fmf.flushFPinfo();
+            }
+            FabArrayBase::distributed_fpinfo = false;
+
+            amrex::Print() << "  " << all[0].size() << " coarse patches\n";
+            ok = check("FPinfo", all[0] == all[1] && mine[0] == mine[1] &&
+                       dst_boxes[0] == dst_boxes[1] && dst_idxs[0] == dst_idxs[1]) && ok;
+            ok = check("FPinfo, distributed_fpinfo", all[0] == all[2] && mine[0] == mine[2] &&
+                       dst_boxes[0] == dst_boxes[2] && dst_idxs[0] == dst_idxs[2]) && ok;
+            AMREX_ALWAYS_ASSERT(!all[0].empty());
+
+            // ---- the local patches are the coarsened dst_boxes
+            bool consistent = (mine[2].size() == dst_boxes[2].size());
+            for (int i = 0; consistent && i < mine[2].size(); ++i) {
+                consistent = (mine[2][i] == coarsener.doit(dst_boxes[2][i]));
+            }
+            ok = check("local patches in the order of dst_boxes", consistent) && ok;
+        }
+
+        AMREX_ALWAYS_ASSERT(ok);
+        amrex::Print() << "CommMetaData test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,175 @@
+//
+// Compares the fused linear combination kernels (MultiFab::FusedLinComb,
+// FusedLinCombDot, FusedLinCombDot_nowait and FusedLinCombNorm0) with
+// the same updates done one after another with MultiFab::LinComb, followed
+// by MultiFab::Dot or MultiFab::norm0, e.g.,
+//
+//     mpiexec -n 4 ./main3d.gnu.MPI.ex inputs
+//
+// The updates include ones that use the results of earlier ones, ones
+// whose x or y is the destination, several components and ghost cells.
+// The updated MultiFabs must agree to rounding, as must the dot products,
+// which may be added up in a different order.  The max norms must be
+// identical.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+constexpr int nmf = 5;
+
+void init (Array<MultiFab,nmf>& mf)
+{
+    for (int m = 0; m < nmf; ++m)
+    {
+        for (MFIter mfi(mf[m]); mfi.isValid(); ++mfi)
+        {
+            Array4<Real> const& a = mf[m].array(mfi);
+            amrex::LoopOnCpu(mfi.fabbox(), mf[m].nComp(), [=] (int i, int j, int k, int n) noexcept
+            {
+                a(i,j,k,n) = std::sin(0.1*i + 0.2*j + 0.3*k + n + m) + 0.1*m;
+            });
+        }
+    }
+}
+
+// Max difference between a and b over all components and ghost cells.
+Real maxdiff (const MultiFab& a, const MultiFab& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), a.nGrow());
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), a.nGrow());
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), a.nGrow());
+    Real r = 0.0;
+    for (int n = 0; n < a.nComp(); ++n) {
+        r = std::max(r, d.norm0(n, a.nGrow()));
+    }
+    return r;
+}
+
+bool close (Real a, Real b, Real tol)
+{
+    return std::abs(a-b) <= tol * std::max(std::abs(a), std::abs(b));
+}
+
+bool check (const std::string& name, bool ok)
+{
+    amrex::Print() << "  " << name << ": " << (ok ? "ok" : "FAILED") << "\n";
+    return ok;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int ncomp = 2;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+        }
+
+        Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const int nghost = 1;
+        Array<MultiFab,nmf> f, s;
+        for (int m = 0; m < nmf; ++m) {
+            f[m].define(ba, dm, 2*ncomp, nghost);
+            s[m].define(ba, dm, 2*ncomp, nghost);
+        }
+        init(f);
+        init(s);
+
+        // ---- updates as in BiCGStab, and ones on other components
+        const Real alpha = 0.7, beta = -1.3, omega = 0.4;
+        auto ops = [&] (Array<MultiFab,nmf>& mf) -> Vector<MultiFab::LinCombOp> {
+            return {{mf[0], -omega, mf[1]},                      // p -= omega*v
+                    {mf[0], 1.0, mf[2], beta, mf[0]},            // p = r + beta*p
+                    {mf[3], alpha, mf[0]},                       // x += alpha*p
+                    {mf[2], -alpha, mf[1]},                      // r -= alpha*v
+                    {mf[4], 2.0, mf[2], 0.5, mf[3], ncomp, 0, 0},// other components
+                    {mf[1], 0.0, mf[1], 3.0, mf[4], 0, ncomp, ncomp}};
+        };
+        auto sequential = [&] (Array<MultiFab,nmf>& mf, int ng) {
+            for (auto const& op : ops(mf)) {
+                MultiFab::LinComb(*op.dst, op.a, *op.x, op.xcomp, op.b, *op.y, op.ycomp,
+                                  op.dstcomp, ncomp, ng);
+            }
+        };
+        auto fdiff = [&] () {
+            Real r = 0.0;
+            for (int m = 0; m < nmf; ++m) r = std::max(r, maxdiff(f[m], s[m]));
+            return r;
+        };
+        const Real tol = 1.e-14;
+        bool ok = true;
+
+        // ---- FusedLinComb
+        MultiFab::FusedLinComb(ops(f), ncomp, nghost);
+        sequential(s, nghost);
+        ok = check("FusedLinComb", fdiff() <= tol) && ok;
+
+        // ---- FusedLinCombDot
+        {
+            const Real d = MultiFab::FusedLinCombDot(ops(f), f[2], 0, f[3], ncomp, ncomp, 0);
+            sequential(s, 0);
+            const Real d_ref = MultiFab::Dot(s[2], 0, s[3], ncomp, ncomp, 0);
+            ok = check("FusedLinCombDot", fdiff() <= tol && close(d, d_ref, 1.e-13)) && ok;
+        }
+
+        // ---- FusedLinCombDot_nowait, and with local = true
+        {
+            auto h = MultiFab::FusedLinCombDot_nowait(ops(f), f[0], 0, f[0], 0, ncomp, 0);
+            sequential(s, 0);
+            const Real d_ref = MultiFab::Dot(s[0], 0, s[0], 0, ncomp, 0);
+            const Real d = h.get();
+            ok = check("FusedLinCombDot_nowait", fdiff() <= tol && close(d, d_ref, 1.e-13)) && ok;
+
+            Real dl = MultiFab::FusedLinCombDot({}, f[1], 0, f[2], 0, ncomp, 0, true);
+            const Real dl_ref = MultiFab::Dot(s[1], 0, s[2], 0, ncomp, 0, true);
+            ok = check("FusedLinCombDot, local", close(dl, dl_ref, 1.e-13)) && ok;
+        }
+
+        // ---- FusedLinCombNorm0
+        {
+            const Real n0 = MultiFab::FusedLinCombNorm0(ops(f), f[4], ncomp, ncomp, 0);
+            sequential(s, 0);
+            Real n0_ref = 0.0;
+            for (int n = ncomp; n < 2*ncomp; ++n) n0_ref = std::max(n0_ref, s[4].norm0(n));
+            ok = check("FusedLinCombNorm0", fdiff() <= tol && n0 == n0_ref) && ok;
+        }
+
+        // ---- the maximum number of updates
+        {
+            Vector<MultiFab::LinCombOp> many;
+            for (int m = 0; m < MultiFab::max_fused_ops; ++m) {
+                many.push_back({f[m%nmf], 0.5, f[(m+1)%nmf], 0.5, f[(m+2)%nmf]});
+            }
+            MultiFab::FusedLinComb(many, ncomp, nghost);
+            for (int m = 0; m < MultiFab::max_fused_ops; ++m) {
+                MultiFab::LinComb(s[m%nmf], 0.5, s[(m+1)%nmf], 0, 0.5, s[(m+2)%nmf], 0,
+                                  0, ncomp, nghost);
+            }
+            ok = check("max_fused_ops updates", fdiff() <= tol) && ok;
+        }
+
+        AMREX_ALWAYS_ASSERT(ok);
+        amrex::Print() << "FusedLinComb test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,154 @@
+//
+// Tests DistributionMapping::makeIncremental, e.g.,
+//
+//     mpiexec -n 8 ./main3d.gnu.MPI.ex inputs
+//
+// The boxes are first distributed by SFC for uniform costs.  Then the
+// boxes in one corner of the domain become more expensive, and the
+// incremental rebalance must reach the target efficiency, report the
+// bytes of the boxes whose owner has changed, and move less data than a
+// knapsack distribution computed from scratch.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+Long bytes_moved (const DistributionMapping& from, const DistributionMapping& to,
+                  const Vector<Long>& box_bytes)
+{
+    Long r = 0;
+    for (int i = 0; i < from.size(); ++i) {
+        if (from[i] != to[i]) r += box_bytes[i];
+    }
+    return r;
+}
+
+Real efficiency (const DistributionMapping& dm, const Vector<Real>& cost)
+{
+    Real eff;
+    DistributionMapping::ComputeDistributionMappingEfficiency(dm, cost, &eff);
+    return eff;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 96;
+        int max_grid_size = 16;
+        int ncomp = 4;
+        Real target_efficiency = 0.9;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+            pp.query("target_efficiency", target_efficiency);
+        }
+
+        Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        const int nboxes = ba.size();
+        DistributionMapping dm(ba);
+
+        Vector<Long> box_bytes(nboxes);
+        Vector<Real> cost(nboxes);
+        for (int i = 0; i < nboxes; ++i) {
+            box_bytes[i] = ba[i].numPts()*ncomp*sizeof(Real);
+            // The boxes in one corner cost four times as much.
+            const Box& bx = ba[i];
+            const IntVect& c = bx.smallEnd();
+            const bool hot = AMREX_D_TERM(c[0] < n_cell/2, && c[1] < n_cell/2, && c[2] < n_cell/2);
+            cost[i] = hot ? 4.0 : 1.0;
+        }
+        const Long total_bytes = std::accumulate(box_bytes.begin(), box_bytes.end(), Long(0));
+
+        amrex::Print() << nboxes << " boxes on " << ParallelDescriptor::NProcs() << " ranks\n";
+
+        // Rebalancing the new costs
+        {
+            Real current_eff, proposed_eff;
+            Long moved;
+            DistributionMapping r = DistributionMapping::makeIncremental
+                (dm, cost, box_bytes, target_efficiency, current_eff, proposed_eff, &moved);
+
+            Real knapsack_eff;
+            DistributionMapping k = DistributionMapping::makeKnapSack(cost, knapsack_eff);
+            const Long knapsack_moved = bytes_moved(dm, k, box_bytes);
+
+            amrex::Print() << "incremental: efficiency " << current_eff << " -> " << proposed_eff
+                           << ", moved " << moved << " of " << total_bytes << " bytes\n"
+                           << "knapsack:    efficiency " << current_eff << " -> " << knapsack_eff
+                           << ", moved " << knapsack_moved << " of " << total_bytes << " bytes\n";
+
+            AMREX_ALWAYS_ASSERT(std::abs(current_eff - efficiency(dm, cost)) < 1.e-12);
+            AMREX_ALWAYS_ASSERT(std::abs(proposed_eff - efficiency(r, cost)) < 1.e-12);
+            AMREX_ALWAYS_ASSERT(moved == bytes_moved(dm, r, box_bytes));
+            if (ParallelDescriptor::NProcs() > 1) {
+                AMREX_ALWAYS_ASSERT(current_eff < target_efficiency);
+                AMREX_ALWAYS_ASSERT(proposed_eff >= target_efficiency);
+                AMREX_ALWAYS_ASSERT(moved < knapsack_moved);
+            }
+
+            // Rebalancing again with the same costs moves nothing.
+            Real eff2a, eff2b;
+            Long moved2;
+            DistributionMapping r2 = DistributionMapping::makeIncremental
+                (r, cost, box_bytes, target_efficiency, eff2a, eff2b, &moved2);
+            AMREX_ALWAYS_ASSERT(moved2 == 0 && r2 == r);
+        }
+
+        // A target of 1 usually cannot be reached, so boxes are moved for as
+        // long as that helps, and some of them may be moved more than once.
+        // The reported bytes must still be those of the final map.
+        {
+            Vector<Real> cost2(nboxes);
+            for (int i = 0; i < nboxes; ++i) {
+                cost2[i] = 1.0 + (i % 7);
+            }
+            Real current_eff, proposed_eff;
+            Long moved;
+            DistributionMapping r = DistributionMapping::makeIncremental
+                (dm, cost2, box_bytes, 1.0, current_eff, proposed_eff, &moved);
+            amrex::Print() << "target 1:    efficiency " << current_eff << " -> " << proposed_eff
+                           << ", moved " << moved << " of " << total_bytes << " bytes\n";
+            AMREX_ALWAYS_ASSERT(moved == bytes_moved(dm, r, box_bytes));
+            AMREX_ALWAYS_ASSERT(proposed_eff >= current_eff);
+        }
+
+        // The LayoutData version uses the number of cells as the bytes, and
+        // its result is the same on all ranks.
+        {
+            LayoutData<Real> costs(ba, dm);
+            for (MFIter mfi(costs); mfi.isValid(); ++mfi) {
+                costs[mfi] = cost[mfi.index()];
+            }
+            Real current_eff, proposed_eff;
+            DistributionMapping r = DistributionMapping::makeIncremental
+                (costs, target_efficiency, current_eff, proposed_eff);
+
+            Vector<Long> npts(nboxes);
+            for (int i = 0; i < nboxes; ++i) {
+                npts[i] = ba[i].numPts();
+            }
+            Real eff_a, eff_b;
+            DistributionMapping rs = DistributionMapping::makeIncremental
+                (dm, cost, npts, target_efficiency, eff_a, eff_b);
+            AMREX_ALWAYS_ASSERT(r == rs);
+        }
+
+        amrex::Print() << "IncrementalRebalance test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,182 @@
+//
+// Solves
+//
+//     - del dot (b grad phi) = rhs
+//
+// with Dirichlet boundaries on a single level without coarsening, so that
+// the whole solve is done by the MLMG bottom solver, once with each of the
+// Krylov bottom solvers.  In the first bottom solve, the pipelined CG must
+// converge like CG with one global reduction per iteration, and the
+// communication-avoiding BiCGStab must converge like BiCGStab with fewer
+// reductions.  All the solutions must agree.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLABecLaplacian.H>
+
+#include <iomanip>
+
+using namespace amrex;
+
+namespace {
+
+void init_data (const Geometry& geom, MultiFab& rhs, Array<MultiFab,AMREX_SPACEDIM>& bcoef)
+{
+    const auto dx = geom.CellSizeArray();
+    const auto problo = geom.ProbLoArray();
+    const Real tpi = 2.0*3.14159265358979323846;
+
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi)
+    {
+        Array4<Real> const& r = rhs.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [=] (int i, int j, int k) noexcept
+        {
+            Real x = problo[0] + (i+0.5)*dx[0];
+            Real y = problo[1] + (j+0.5)*dx[1];
+#if (AMREX_SPACEDIM == 3)
+            Real z = problo[2] + (k+0.5)*dx[2];
+#else
+            Real z = 0.0;
+#endif
+            r(i,j,k) = std::sin(tpi*x) * std::sin(2.0*tpi*y) + std::cos(tpi*z);
+        });
+    }
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        for (MFIter mfi(bcoef[idim]); mfi.isValid(); ++mfi)
+        {
+            Array4<Real> const& b = bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [=] (int i, int j, int k) noexcept
+            {
+                Real x = problo[0] + i*dx[0];
+                Real y = problo[1] + j*dx[1];
+                b(i,j,k) = 1.0 + 0.5*std::sin(tpi*(x+y));
+            });
+        }
+    }
+}
+
+struct Result
+{
+    int niters = 0;
+    int nreductions = 0;
+    Real resid = 0.0;
+};
+
+Result solve (MLMG::BottomSolver bottom, Real tol_rel, int verbose,
+              const Geometry& geom, const BoxArray& ba, const DistributionMapping& dm,
+              const MultiFab& rhs, const Array<MultiFab,AMREX_SPACEDIM>& bcoef,
+              MultiFab& sol)
+{
+    LPInfo info;
+    info.setMaxCoarseningLevel(0);
+    MLABecLaplacian linop({geom}, {ba}, {dm}, info);
+    const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                            LinOpBCType::Dirichlet,
+                                                            LinOpBCType::Dirichlet)};
+    linop.setDomainBC(bc, bc);
+    linop.setLevelBC(0, nullptr);
+    linop.setScalars(0.0, 1.0);
+    linop.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+
+    MLMG mlmg(linop);
+    mlmg.setVerbose(verbose);
+    mlmg.setBottomVerbose(verbose);
+    mlmg.setBottomSolver(bottom);
+    mlmg.setBottomTolerance(tol_rel);
+    mlmg.setBottomMaxIter(1000);
+
+    sol.setVal(0.0);
+    mlmg.solve({&sol}, {&rhs}, tol_rel, 0.0);
+
+    // The counts of the first bottom solve.  The solvers do not all
+    // measure the residual in the same norm, so MLMG may need another
+    // iteration with some of them.
+    Result r;
+    r.niters = mlmg.getNumCGIters()[0];
+    r.nreductions = mlmg.getNumCGReductions()[0];
+    r.resid = mlmg.getFinalResidual() / mlmg.getInitResidual();
+    return r;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        Real tol_rel = 1.e-10;
+        int verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("tol_rel", tol_rel);
+            pp.query("verbose", verbose);
+        }
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab rhs(ba, dm, 1, 0);
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+        }
+        init_data(geom, rhs, bcoef);
+
+        const MLMG::BottomSolver solvers[4] = {MLMG::BottomSolver::cg,
+                                               MLMG::BottomSolver::pipecg,
+                                               MLMG::BottomSolver::bicgstab,
+                                               MLMG::BottomSolver::cabicgstab};
+        const char* name[4] = {"cg", "pipecg", "bicgstab", "cabicgstab"};
+        Result res[4];
+        Vector<MultiFab> sol(4);
+
+        amrex::Print() << "\n" << n_cell << "^" << AMREX_SPACEDIM << " cells, "
+                       << ba.size() << " boxes, tol_rel " << tol_rel << "\n";
+        for (int i = 0; i < 4; ++i)
+        {
+            sol[i].define(ba, dm, 1, 1);
+            res[i] = solve(solvers[i], tol_rel, verbose, geom, ba, dm, rhs, bcoef, sol[i]);
+        }
+
+        const Real norm = sol[0].norm0();
+        for (int i = 0; i < 4; ++i)
+        {
+            MultiFab diff(ba, dm, 1, 0);
+            MultiFab::LinComb(diff, 1.0, sol[i], 0, -1.0, sol[0], 0, 0, 1, 0);
+            const Real d = diff.norm0() / norm;
+            amrex::Print() << "  " << std::setw(10) << name[i] << ": "
+                           << std::setw(4) << res[i].niters << " iterations, "
+                           << std::setw(4) << res[i].nreductions << " reductions"
+                           << ", residual " << res[i].resid
+                           << ", difference from cg " << d << "\n";
+            AMREX_ALWAYS_ASSERT(res[i].resid <= tol_rel);
+            AMREX_ALWAYS_ASSERT(d <= 1.e4*tol_rel);
+        }
+
+        // Pipelining changes the rounding, not the Krylov space.
+        AMREX_ALWAYS_ASSERT(res[1].niters <= res[0].niters + res[0].niters/5 + 2);
+        AMREX_ALWAYS_ASSERT(res[1].nreductions <= res[1].niters + 4);
+        AMREX_ALWAYS_ASSERT(res[1].nreductions < res[0].nreductions);
+        // So does the s-step basis, for small s.
+        AMREX_ALWAYS_ASSERT(res[3].niters <= res[2].niters + res[2].niters/5 + 2);
+        AMREX_ALWAYS_ASSERT(res[3].nreductions < res[2].nreductions);
+
+        amrex::Print() << "BottomSolvers test passed\n";
+    }
+    amrex::Finalize();
+}
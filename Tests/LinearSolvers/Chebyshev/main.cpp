@@ -0,0 +1,291 @@
+//
+// Solves
+//
+//     - del dot (b grad phi) = rhs
+//
+// with MLABecLaplacian and Dirichlet boundaries, once with the red-black
+// Gauss-Seidel smoother and once with the Chebyshev smoother of degrees 2
+// and 4.  The Chebyshev solves must converge to the same solution in a
+// comparable number of V-cycles.
+//
+// It also checks the estimate of the largest eigenvalue of D^{-1}A that
+// the Chebyshev smoother uses:
+//
+//   * for the periodic Poisson operator, whose largest eigenvalue is 2 on
+//     every multigrid level, the estimate must be at most 2 and close
+//     enough to it that 1.1 times the estimate covers the spectrum;
+//   * it must not depend on the domain decomposition;
+//   * after setBCoeffs with new coefficients, it must be recomputed and
+//     agree with that of a newly built operator.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MLABecLaplacian.H>
+
+#include <cmath>
+#include <iomanip>
+
+using namespace amrex;
+
+namespace {
+
+const Real tpi = 2.0*3.14159265358979323846;
+
+// A right-hand side with zero sum, so that the periodic problem is
+// solvable, and a variable b of contrast 1+2*amp.
+void init_data (const Geometry& geom, Real amp, MultiFab& rhs, MultiFab& bcc)
+{
+    const auto dx = geom.CellSizeArray();
+    const auto problo = geom.ProbLoArray();
+
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        Array4<Real> const& r = rhs.array(mfi);
+        amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+        {
+            Real x = problo[0] + (i+0.5)*dx[0];
+            Real y = problo[1] + (j+0.5)*dx[1];
+#if (AMREX_SPACEDIM == 3)
+            Real z = problo[2] + (k+0.5)*dx[2];
+#else
+            Real z = 0.0;
+#endif
+            r(i,j,k) = std::cos(tpi*x) * std::cos(2.0*tpi*y) + std::cos(tpi*z);
+        });
+
+        const Box& gbx = amrex::grow(bx, bcc.nGrow());
+        Array4<Real> const& b = bcc.array(mfi);
+        amrex::LoopOnCpu(gbx, [=] (int i, int j, int k) noexcept
+        {
+            Real x = problo[0] + (i+0.5)*dx[0];
+            Real y = problo[1] + (j+0.5)*dx[1];
+            b(i,j,k) = 1.0 + amp + amp*std::sin(tpi*(x+y));
+        });
+    }
+}
+
+void average_to_faces (const MultiFab& bcc, Array<MultiFab,AMREX_SPACEDIM>& bcoef)
+{
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        const IntVect iv = IntVect::TheDimensionVector(idim);
+        for (MFIter mfi(bcoef[idim]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            Array4<Real const> const& b = bcc.const_array(mfi);
+            Array4<Real> const& bf = bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+            {
+                bf(i,j,k) = 0.5*(b(i-iv[0],j-iv[1],k-iv[2]) + b(i,j,k));
+            });
+        }
+    }
+}
+
+// For the number of multigrid levels.
+struct ABecLaplacian
+    : public MLABecLaplacian
+{
+    using MLABecLaplacian::NMGLevels;
+};
+
+struct Problem
+{
+    Problem (const Geometry& a_geom, int max_grid_size, Real amp,
+             const DistributionMapping* a_dm = nullptr)
+        : geom(a_geom)
+    {
+        ba.define(geom.Domain());
+        ba.maxSize(max_grid_size);
+        if (a_dm) {
+            dm = *a_dm;
+        } else {
+            dm.define(ba);
+        }
+        rhs.define(ba, dm, 1, 0);
+        bcc.define(ba, dm, 1, 1);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+        }
+        init_data(geom, amp, rhs, bcc);
+        average_to_faces(bcc, bcoef);
+    }
+
+    Geometry geom;
+    BoxArray ba;
+    DistributionMapping dm;
+    MultiFab rhs;
+    MultiFab bcc;
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+};
+
+void define_abec (MLABecLaplacian& linop, const Problem& p)
+{
+    const LinOpBCType bct = p.geom.isAllPeriodic() ? LinOpBCType::Periodic
+                                                   : LinOpBCType::Dirichlet;
+    const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(bct,bct,bct)};
+    linop.define({p.geom}, {p.ba}, {p.dm});
+    linop.setDomainBC(bc, bc);
+    linop.setLevelBC(0, nullptr);
+    linop.setScalars(0.0, 1.0);
+    linop.setBCoeffs(0, amrex::GetArrOfConstPtrs(p.bcoef));
+}
+
+// degree 0 means Gauss-Seidel.
+int solve (MLABecLaplacian& linop, int degree, Real tol_rel, int verbose,
+           const MultiFab& rhs, MultiFab& sol, Real* resid = nullptr)
+{
+    if (degree > 0) {
+        linop.setSmoother(Smoother::chebyshev);
+        linop.setChebyshevDegree(degree);
+    }
+
+    MLMG mlmg(linop);
+    mlmg.setVerbose(verbose);
+
+    sol.setVal(0.0);
+    mlmg.solve({&sol}, {&rhs}, tol_rel, 0.0);
+
+    if (resid) {
+        MultiFab res(rhs.boxArray(), rhs.DistributionMap(), 1, 0);
+        mlmg.compResidual({&res}, {&sol}, {&rhs});
+        *resid = res.norminf() / rhs.norminf();
+    }
+    return mlmg.getNumIters();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        Real tol_rel = 1.e-10;
+        int verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("tol_rel", tol_rel);
+            pp.query("verbose", verbose);
+        }
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+
+        amrex::Print() << "\n" << n_cell << "^" << AMREX_SPACEDIM << " cells, tol_rel "
+                       << tol_rel << "\n";
+
+        // Gauss-Seidel vs. Chebyshev
+        {
+            Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+            Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+            Problem p(geom, max_grid_size, 0.5);
+
+            MultiFab sol_gs(p.ba, p.dm, 1, 1);
+            MultiFab sol_cheby(p.ba, p.dm, 1, 1);
+
+            MLABecLaplacian op_gs;
+            define_abec(op_gs, p);
+            Real resid;
+            const int niters_gs = solve(op_gs, 0, tol_rel, verbose, p.rhs, sol_gs, &resid);
+            amrex::Print() << "  Gauss-Seidel: " << niters_gs << " iterations, residual "
+                           << resid << "\n";
+            AMREX_ALWAYS_ASSERT(resid <= tol_rel);
+
+            for (int degree : {2, 4})
+            {
+                MLABecLaplacian op;
+                define_abec(op, p);
+                const int niters = solve(op, degree, tol_rel, verbose, p.rhs, sol_cheby, &resid);
+
+                MultiFab::Subtract(sol_cheby, sol_gs, 0, 0, 1, 0);
+                const Real diff = sol_cheby.norm0() / sol_gs.norm0();
+
+                amrex::Print() << "  Chebyshev degree " << degree << ": " << niters
+                               << " iterations, residual " << resid
+                               << ", max |sol - sol_gs| / max |sol_gs| = " << diff
+                               << ", lambda_max estimate " << op.chebyshevMaxEigenvalue(0,0)
+                               << "\n";
+
+                AMREX_ALWAYS_ASSERT(resid <= tol_rel);
+                AMREX_ALWAYS_ASSERT(diff <= 100.*tol_rel);
+                // A degree-2 Chebyshev sweep costs about as much as a
+                // Gauss-Seidel sweep, and is a somewhat weaker smoother.
+                AMREX_ALWAYS_ASSERT(niters <= 2*niters_gs);
+            }
+        }
+
+        // The estimate for the periodic Poisson operator on every level,
+        // with two domain decompositions.
+        {
+            Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+            Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+            Vector<Real> lambda[2];
+            for (int idecomp = 0; idecomp < 2; ++idecomp)
+            {
+                Problem p(geom, max_grid_size/(idecomp+1), 0.0);
+                ABecLaplacian op;
+                define_abec(op, p);
+                MultiFab sol(p.ba, p.dm, 1, 1);
+                solve(op, 2, tol_rel, verbose, p.rhs, sol);
+                for (int mglev = 0; mglev < op.NMGLevels(0); ++mglev) {
+                    lambda[idecomp].push_back(op.chebyshevMaxEigenvalue(0,mglev));
+                }
+                amrex::Print() << "  Periodic Poisson, " << p.ba.size()
+                               << " boxes, lambda_max estimates:";
+                for (Real l : lambda[idecomp]) {
+                    amrex::Print() << " " << std::setprecision(15) << l;
+                }
+                amrex::Print() << std::setprecision(6) << "\n";
+            }
+
+            AMREX_ALWAYS_ASSERT(lambda[0].size() == lambda[1].size());
+            for (int mglev = 0; mglev < lambda[0].size(); ++mglev) {
+                const Real l = lambda[0][mglev];
+                AMREX_ALWAYS_ASSERT(l <= 2.0*(1.0+1.e-12) && 1.1*l >= 2.0);
+                AMREX_ALWAYS_ASSERT(std::abs(l-lambda[1][mglev]) <= 1.e-12*l);
+            }
+        }
+
+        // Reusing the operator with new coefficients.
+        {
+            Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+            Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+            Problem p0(geom, max_grid_size, 0.1);
+            Problem p1(geom, max_grid_size, 5.0, &p0.dm);
+
+            MultiFab sol(p0.ba, p0.dm, 1, 1);
+
+            MLABecLaplacian op;
+            define_abec(op, p0);
+            solve(op, 2, tol_rel, verbose, p0.rhs, sol);
+            const Real lambda0 = op.chebyshevMaxEigenvalue(0,0);
+
+            op.setBCoeffs(0, amrex::GetArrOfConstPtrs(p1.bcoef));
+            solve(op, 2, tol_rel, verbose, p1.rhs, sol);
+            const Real lambda1 = op.chebyshevMaxEigenvalue(0,0);
+
+            MLABecLaplacian op_new;
+            define_abec(op_new, p1);
+            solve(op_new, 2, tol_rel, verbose, p1.rhs, sol);
+            const Real lambda_new = op_new.chebyshevMaxEigenvalue(0,0);
+
+            amrex::Print() << "  New coefficients: lambda_max estimates " << lambda0
+                           << " before, " << lambda1 << " after, "
+                           << lambda_new << " for a new operator\n";
+
+            AMREX_ALWAYS_ASSERT(lambda1 != lambda0);
+            AMREX_ALWAYS_ASSERT(std::abs(lambda1-lambda_new) <= 1.e-12*lambda_new);
+        }
+    }
+    amrex::Finalize();
+}
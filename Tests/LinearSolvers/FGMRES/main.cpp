@@ -0,0 +1,191 @@
+//
+// Compare MLMG with flexible GMRES preconditioned by an MLMG V-cycle on a
+// variable coefficient problem with high contrast,
+//
+//     - del dot (b grad phi) = rhs,  phi = 0 on the domain boundary,
+//
+// where b is 1 outside and `contrast` inside a checkerboard of blocks.
+// Plain MLMG diverges on this problem for contrasts of about 10 and up;
+// set compare_with_mlmg = 0 to run only MLFGMRES.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLFGMRES.H>
+#include <AMReX_MLABecLaplacian.H>
+
+#include <iomanip>
+#include <limits>
+
+using namespace amrex;
+
+namespace {
+
+void init_coefs (const Geometry& geom, int nblocks, Real contrast,
+                 MultiFab& rhs, Array<MultiFab,AMREX_SPACEDIM>& bcoef)
+{
+    const auto dx = geom.CellSizeArray();
+    const auto problo = geom.ProbLoArray();
+    const int n_cell = geom.Domain().length(0);
+    const int bsize = std::max(n_cell/nblocks, 1);
+
+    // b in cells, with one ghost cell for averaging to faces
+    MultiFab bcc(rhs.boxArray(), rhs.DistributionMap(), 1, 1);
+
+    for (MFIter mfi(bcc); mfi.isValid(); ++mfi)
+    {
+        const Box& gbx = mfi.fabbox();
+        Array4<Real> const& b = bcc.array(mfi);
+        amrex::LoopOnCpu(gbx, [=] (int i, int j, int k) noexcept
+        {
+            int ib = amrex::coarsen(i, bsize);
+            int jb = amrex::coarsen(j, bsize);
+#if (AMREX_SPACEDIM == 3)
+            int kb = amrex::coarsen(k, bsize);
+#else
+            int kb = 0;
+#endif
+            b(i,j,k) = ((ib+jb+kb) % 2 == 0) ? 1.0 : contrast;
+        });
+
+        const Box& bx = mfi.validbox();
+        Array4<Real> const& r = rhs.array(mfi);
+        amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+        {
+            Real x = problo[0] + (i+0.5)*dx[0];
+            Real y = problo[1] + (j+0.5)*dx[1];
+#if (AMREX_SPACEDIM == 3)
+            Real z = problo[2] + (k+0.5)*dx[2];
+#else
+            Real z = 0.0;
+#endif
+            r(i,j,k) = std::sin(6.2831853*x) * std::cos(3.1415927*y) + z;
+        });
+    }
+
+    // Harmonic average to faces
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        const IntVect iv = IntVect::TheDimensionVector(idim);
+        for (MFIter mfi(bcoef[idim]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            Array4<Real const> const& b = bcc.const_array(mfi);
+            Array4<Real> const& bf = bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+            {
+                Real b0 = b(i-iv[0],j-iv[1],k-iv[2]);
+                Real b1 = b(i,j,k);
+                bf(i,j,k) = 2.0*b0*b1/(b0+b1);
+            });
+        }
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        Real contrast = 5.;
+        int nblocks = 4;
+        Real tol_rel = 1.e-10;
+        int nrep = 3;
+        int verbose = 1;
+        int max_iter = 200;
+        int compare_with_mlmg = 1;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("contrast", contrast);
+            pp.query("nblocks", nblocks);
+            pp.query("tol_rel", tol_rel);
+            pp.query("nrep", nrep);
+            pp.query("verbose", verbose);
+            pp.query("max_iter", max_iter);
+            pp.query("compare_with_mlmg", compare_with_mlmg);
+        }
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab rhs(ba, dm, 1, 0);
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+        }
+        init_coefs(geom, nblocks, contrast, rhs, bcoef);
+
+        MultiFab sol_mlmg(ba, dm, 1, 1);
+        MultiFab sol_fgmres(ba, dm, 1, 1);
+
+        const std::string solver_name[2] = {"MLMG", "MLFGMRES"};
+        int niters[2] = {0, 0};
+        Real tmin[2] = {std::numeric_limits<Real>::max(), std::numeric_limits<Real>::max()};
+
+        const int first_solver = compare_with_mlmg ? 0 : 1;
+        for (int isolver = first_solver; isolver < 2; ++isolver)
+        {
+            MultiFab& sol = (isolver == 0) ? sol_mlmg : sol_fgmres;
+            for (int irep = 0; irep < nrep; ++irep)
+            {
+                MLABecLaplacian mlabec({geom}, {ba}, {dm});
+                mlabec.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                 LinOpBCType::Dirichlet,
+                                                 LinOpBCType::Dirichlet)},
+                                   {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                 LinOpBCType::Dirichlet,
+                                                 LinOpBCType::Dirichlet)});
+                sol.setVal(0.0);
+                mlabec.setLevelBC(0, &sol);
+                mlabec.setScalars(0.0, 1.0);
+                mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+
+                MLMG mlmg(mlabec);
+                mlmg.setMaxIter(max_iter);
+                mlmg.setVerbose(irep == 0 ? verbose : 0);
+
+                Real t0 = amrex::second();
+                if (isolver == 0) {
+                    mlmg.solve({&sol}, {&rhs}, tol_rel, 0.0);
+                    niters[isolver] = mlmg.getNumIters();
+                } else {
+                    MLFGMRES fgmres(mlmg);
+                    fgmres.setMaxIter(max_iter);
+                    fgmres.setVerbose(irep == 0 ? verbose : 0);
+                    fgmres.solve({&sol}, {&rhs}, tol_rel, 0.0);
+                    niters[isolver] = fgmres.getNumIters();
+                }
+                Real t = amrex::second() - t0;
+                ParallelDescriptor::ReduceRealMax(t);
+                tmin[isolver] = std::min(tmin[isolver], t);
+            }
+        }
+
+        amrex::Print() << "\nContrast " << contrast << ", " << n_cell << "^" << AMREX_SPACEDIM
+                       << " cells, tol_rel " << tol_rel << "\n";
+        for (int isolver = first_solver; isolver < 2; ++isolver) {
+            amrex::Print() << "  " << std::setw(8) << solver_name[isolver] << ": "
+                           << std::setw(4) << niters[isolver] << " V-cycles, time "
+                           << tmin[isolver] << "\n";
+        }
+        if (compare_with_mlmg) {
+            MultiFab::Subtract(sol_fgmres, sol_mlmg, 0, 0, 1, 0);
+            amrex::Print() << "  max |sol_fgmres - sol_mlmg| / max |sol_mlmg| = "
+                           << sol_fgmres.norm0() / sol_mlmg.norm0() << "\n";
+        }
+    }
+    amrex::Finalize();
+}
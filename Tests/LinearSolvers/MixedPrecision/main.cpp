@@ -0,0 +1,198 @@
+//
+// Solves
+//
+//     - del dot grad phi = rhs                  (MLPoisson), and
+//     a phi - del dot (b grad phi) = rhs        (MLABecLaplacian),
+//
+// with Dirichlet or Neumann boundaries, once in double precision and once
+// with MLMG::setMixedPrecision(true).  The mixed-precision solve must
+// actually run in mixed precision, take about as many iterations, and give
+// the same solution to within the solver tolerance.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MLABecLaplacian.H>
+
+#include <iomanip>
+#include <memory>
+
+using namespace amrex;
+
+namespace {
+
+// A right-hand side with zero sum, so that the Neumann Poisson problem
+// is solvable, and a variable b.
+void init_data (const Geometry& geom, MultiFab& rhs, MultiFab& bcc)
+{
+    const auto dx = geom.CellSizeArray();
+    const auto problo = geom.ProbLoArray();
+    const Real tpi = 2.0*3.14159265358979323846;
+
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        Array4<Real> const& r = rhs.array(mfi);
+        amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+        {
+            Real x = problo[0] + (i+0.5)*dx[0];
+            Real y = problo[1] + (j+0.5)*dx[1];
+#if (AMREX_SPACEDIM == 3)
+            Real z = problo[2] + (k+0.5)*dx[2];
+#else
+            Real z = 0.0;
+#endif
+            r(i,j,k) = std::cos(tpi*x) * std::cos(2.0*tpi*y) + std::cos(tpi*z);
+        });
+
+        const Box& gbx = amrex::grow(bx, bcc.nGrow());
+        Array4<Real> const& b = bcc.array(mfi);
+        amrex::LoopOnCpu(gbx, [=] (int i, int j, int k) noexcept
+        {
+            Real x = problo[0] + (i+0.5)*dx[0];
+            Real y = problo[1] + (j+0.5)*dx[1];
+            b(i,j,k) = 1.0 + 0.5*std::sin(tpi*(x+y));
+        });
+    }
+}
+
+void average_to_faces (const MultiFab& bcc, Array<MultiFab,AMREX_SPACEDIM>& bcoef)
+{
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        const IntVect iv = IntVect::TheDimensionVector(idim);
+        for (MFIter mfi(bcoef[idim]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            Array4<Real const> const& b = bcc.const_array(mfi);
+            Array4<Real> const& bf = bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+            {
+                bf(i,j,k) = 0.5*(b(i-iv[0],j-iv[1],k-iv[2]) + b(i,j,k));
+            });
+        }
+    }
+}
+
+struct Result
+{
+    int niters = 0;
+    bool mixed = false;
+};
+
+// problem: 0 Poisson Dirichlet, 1 Poisson Neumann, 2 ABec Dirichlet,
+//          3 ABec Neumann with a > 0
+Result solve (int problem, bool mixed, Real tol_rel, int verbose,
+              const Geometry& geom, const BoxArray& ba, const DistributionMapping& dm,
+              const MultiFab& rhs, const Array<MultiFab,AMREX_SPACEDIM>& bcoef,
+              MultiFab& sol)
+{
+    const LinOpBCType bct = (problem == 1 || problem == 3) ? LinOpBCType::Neumann
+                                                           : LinOpBCType::Dirichlet;
+    const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(bct,bct,bct)};
+
+    std::unique_ptr<MLLinOp> linop;
+    if (problem < 2) {
+        auto p = new MLPoisson({geom}, {ba}, {dm});
+        linop.reset(p);
+        p->setDomainBC(bc, bc);
+        p->setLevelBC(0, nullptr);
+    } else {
+        auto p = new MLABecLaplacian({geom}, {ba}, {dm});
+        linop.reset(p);
+        p->setDomainBC(bc, bc);
+        p->setLevelBC(0, nullptr);
+        p->setScalars((problem == 3) ? 1.0 : 0.0, 1.0);
+        if (problem == 3) p->setACoeffs(0, 1.0);
+        p->setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+    }
+
+    MLMG mlmg(*linop);
+    mlmg.setVerbose(verbose);
+    mlmg.setMixedPrecision(mixed);
+
+    sol.setVal(0.0);
+    mlmg.solve({&sol}, {&rhs}, tol_rel, 0.0);
+
+    // The Neumann Poisson solution is only defined up to a constant.
+    if (problem == 1) {
+        sol.plus(-sol.sum()/ba.numPts(), 0, 1, 0);
+    }
+
+    Result r;
+    r.niters = mlmg.getNumIters();
+    r.mixed = mlmg.usingMixedPrecision();
+    return r;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        Real tol_rel = 1.e-10;
+        int verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("tol_rel", tol_rel);
+            pp.query("verbose", verbose);
+        }
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab rhs(ba, dm, 1, 0);
+        MultiFab bcc(ba, dm, 1, 1);
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+        }
+        init_data(geom, rhs, bcc);
+        average_to_faces(bcc, bcoef);
+
+        MultiFab sol_double(ba, dm, 1, 1);
+        MultiFab sol_mixed(ba, dm, 1, 1);
+
+        const char* name[4] = {"Poisson Dirichlet", "Poisson Neumann",
+                               "ABec Dirichlet", "ABec a>0 Neumann"};
+
+        amrex::Print() << "\n" << n_cell << "^" << AMREX_SPACEDIM << " cells, "
+                       << ba.size() << " boxes, tol_rel " << tol_rel << "\n";
+        for (int problem = 0; problem < 4; ++problem)
+        {
+            Result rd = solve(problem, false, tol_rel, verbose, geom, ba, dm, rhs, bcoef, sol_double);
+            Result rm = solve(problem, true , tol_rel, verbose, geom, ba, dm, rhs, bcoef, sol_mixed);
+
+            MultiFab::Subtract(sol_mixed, sol_double, 0, 0, 1, 0);
+            const Real diff = sol_mixed.norm0() / sol_double.norm0();
+
+            amrex::Print() << "  " << std::setw(17) << name[problem] << ": "
+                           << rd.niters << " vs " << rm.niters << " iterations"
+                           << ", max |sol_mixed - sol_double| / max |sol_double| = "
+                           << diff << "\n";
+
+            AMREX_ALWAYS_ASSERT(!rd.mixed && rm.mixed);
+            // Each iteration is a step of iterative refinement whose
+            // correction is accurate to about single precision, so the
+            // convergence rate should barely change.
+            AMREX_ALWAYS_ASSERT(rm.niters <= rd.niters + 2);
+            // Both solutions are converged to tol_rel.
+            AMREX_ALWAYS_ASSERT(diff <= 100.*tol_rel);
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,202 @@
+//
+// Solves ncomp independent equations
+//
+//     a phi_n - del dot (b_n grad phi_n) = rhs_n,    n = 0, ..., ncomp-1
+//
+// with Dirichlet boundaries, once with one ncomp-component MLABecLaplacian
+// and once as ncomp single-component solves, and checks that the
+// solutions agree.  The right-hand sides differ by orders of magnitude,
+// and MLMG::setComponentwiseConvergence(1) is used, so each component has
+// to converge relative to its own right-hand side.  The b coefficients
+// are given once as an ncomp-component MultiFab and once as one constant
+// per component with setBCoeffs(amrlev, Vector<Real>).
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLABecLaplacian.H>
+
+#include <cmath>
+#include <memory>
+
+using namespace amrex;
+
+namespace {
+
+const Real tpi = 2.0*3.14159265358979323846;
+
+void init_data (const Geometry& geom, MultiFab& rhs, MultiFab& bcc)
+{
+    const auto dx = geom.CellSizeArray();
+    const auto problo = geom.ProbLoArray();
+    const int ncomp = rhs.nComp();
+
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        Array4<Real> const& r = rhs.array(mfi);
+        amrex::LoopOnCpu(bx, ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            Real x = problo[0] + (i+0.5)*dx[0];
+            Real y = problo[1] + (j+0.5)*dx[1];
+#if (AMREX_SPACEDIM == 3)
+            Real z = problo[2] + (k+0.5)*dx[2];
+#else
+            Real z = 0.0;
+#endif
+            r(i,j,k,n) = std::pow(10.0, -3*n)
+                * (std::cos((n+1)*tpi*x) * std::cos(2.0*tpi*y) + std::cos(tpi*z));
+        });
+
+        const Box& gbx = amrex::grow(bx, bcc.nGrow());
+        Array4<Real> const& b = bcc.array(mfi);
+        amrex::LoopOnCpu(gbx, ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            Real x = problo[0] + (i+0.5)*dx[0];
+            Real y = problo[1] + (j+0.5)*dx[1];
+            b(i,j,k,n) = 1.0 + 0.9*std::sin(tpi*(x+(n+1)*y));
+        });
+    }
+}
+
+void average_to_faces (const MultiFab& bcc, Array<MultiFab,AMREX_SPACEDIM>& bcoef)
+{
+    const int ncomp = bcc.nComp();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        const IntVect iv = IntVect::TheDimensionVector(idim);
+        for (MFIter mfi(bcoef[idim]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            Array4<Real const> const& b = bcc.const_array(mfi);
+            Array4<Real> const& bf = bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(bx, ncomp, [=] (int i, int j, int k, int n) noexcept
+            {
+                bf(i,j,k,n) = 0.5*(b(i-iv[0],j-iv[1],k-iv[2],n) + b(i,j,k,n));
+            });
+        }
+    }
+}
+
+// Either bcoef or beta is used.
+void solve (int ncomp, Real tol_rel, int verbose,
+            const Geometry& geom, const BoxArray& ba, const DistributionMapping& dm,
+            const Array<MultiFab const*,AMREX_SPACEDIM>& bcoef, const Vector<Real>& beta,
+            const MultiFab& rhs, MultiFab& sol)
+{
+    const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                            LinOpBCType::Dirichlet,
+                                                            LinOpBCType::Dirichlet)};
+
+    MLABecLaplacian linop({geom}, {ba}, {dm}, LPInfo(), {}, ncomp);
+    linop.setDomainBC(bc, bc);
+    linop.setLevelBC(0, nullptr);
+    linop.setScalars(1.0, 1.0);
+    linop.setACoeffs(0, 1.0);
+    if (bcoef[0]) {
+        linop.setBCoeffs(0, bcoef);
+    } else {
+        linop.setBCoeffs(0, beta);
+    }
+
+    MLMG mlmg(linop);
+    mlmg.setVerbose(verbose);
+    mlmg.setComponentwiseConvergence(1);
+
+    sol.setVal(0.0);
+    mlmg.solve({&sol}, {&rhs}, tol_rel, 0.0);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        int ncomp = 4;
+        Real tol_rel = 1.e-10;
+        int verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+            pp.query("tol_rel", tol_rel);
+            pp.query("verbose", verbose);
+        }
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab rhs(ba, dm, ncomp, 0);
+        MultiFab bcc(ba, dm, ncomp, 1);
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, ncomp, 0);
+        }
+        init_data(geom, rhs, bcc);
+        average_to_faces(bcc, bcoef);
+
+        Vector<Real> beta(ncomp);
+        for (int n = 0; n < ncomp; ++n) {
+            beta[n] = std::pow(4.0, n);
+        }
+
+        MultiFab sol_multi(ba, dm, ncomp, 1);
+        MultiFab sol_single(ba, dm, ncomp, 1);
+
+        amrex::Print() << "\n" << n_cell << "^" << AMREX_SPACEDIM << " cells, "
+                       << ba.size() << " boxes, " << ncomp << " components, tol_rel "
+                       << tol_rel << "\n";
+
+        for (int variable_b = 1; variable_b >= 0; --variable_b)
+        {
+            Array<MultiFab const*,AMREX_SPACEDIM> bmulti{AMREX_D_DECL(nullptr,nullptr,nullptr)};
+            if (variable_b) {
+                bmulti = amrex::GetArrOfConstPtrs(bcoef);
+            }
+            solve(ncomp, tol_rel, verbose, geom, ba, dm, bmulti, beta, rhs, sol_multi);
+
+            for (int n = 0; n < ncomp; ++n)
+            {
+                MultiFab rhs_n(rhs, amrex::make_alias, n, 1);
+                MultiFab sol_n(ba, dm, 1, 1);
+                Array<std::unique_ptr<MultiFab>,AMREX_SPACEDIM> bcoef_n;
+                Array<MultiFab const*,AMREX_SPACEDIM> bsingle{AMREX_D_DECL(nullptr,nullptr,nullptr)};
+                if (variable_b) {
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        bcoef_n[idim].reset(new MultiFab(bcoef[idim], amrex::make_alias, n, 1));
+                        bsingle[idim] = bcoef_n[idim].get();
+                    }
+                }
+                solve(1, tol_rel, verbose, geom, ba, dm, bsingle, {beta[n]}, rhs_n, sol_n);
+                MultiFab::Copy(sol_single, sol_n, 0, n, 1, 0);
+            }
+
+            amrex::Print() << "  " << (variable_b ? "MultiFab b:" : "Vector<Real> b:")
+                           << " max |sol_multi - sol_single| / max |sol_single| =";
+            for (int n = 0; n < ncomp; ++n)
+            {
+                const Real norm = sol_single.norm0(n);
+                MultiFab::Subtract(sol_multi, sol_single, n, n, 1, 0);
+                const Real diff = sol_multi.norm0(n) / norm;
+                amrex::Print() << " " << diff;
+                // Both are converged to tol_rel relative to the component's
+                // own right-hand side.
+                AMREX_ALWAYS_ASSERT(diff <= 100.*tol_rel);
+            }
+            amrex::Print() << "\n";
+        }
+    }
+    amrex::Finalize();
+}
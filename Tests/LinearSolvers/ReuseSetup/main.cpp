@@ -0,0 +1,212 @@
+//
+// Time stepping with a linear solve per step whose coefficients and
+// right-hand side change every step, either
+//
+//     - del dot (b grad phi) + phi = rhs        (nodal = 0, MLABecLaplacian), or
+//       del dot (sigma grad phi)   = rhs        (nodal = 1, MLNodeLaplacian),
+//
+// with phi = 0 on the domain boundary.  The steps are run twice: once
+// building new MLLinOp and MLMG objects every step, and once reusing the
+// objects of the first step and only setting new coefficients.  The two
+// runs must give the same answer.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLNodeLaplacian.H>
+
+#include <memory>
+
+using namespace amrex;
+
+namespace {
+
+// b (or sigma) in cells and the right-hand side at step `step`
+void init_step (const Geometry& geom, int step, MultiFab& bcc, MultiFab& rhs)
+{
+    const auto dx = geom.CellSizeArray();
+    const auto problo = geom.ProbLoArray();
+    const Real t = 0.3*step;
+    const IntVect rhs_type = rhs.ixType().toIntVect();
+
+    for (MFIter mfi(bcc); mfi.isValid(); ++mfi)
+    {
+        const Box& gbx = mfi.fabbox();
+        Array4<Real> const& b = bcc.array(mfi);
+        amrex::LoopOnCpu(gbx, [=] (int i, int j, int k) noexcept
+        {
+            Real x = problo[0] + (i+0.5)*dx[0];
+            Real y = problo[1] + (j+0.5)*dx[1];
+#if (AMREX_SPACEDIM == 3)
+            Real z = problo[2] + (k+0.5)*dx[2];
+#else
+            Real z = 0.0;
+#endif
+            b(i,j,k) = 1.0 + 0.5*std::sin(6.2831853*(x+y+z) + t);
+        });
+
+        const Box& bx = mfi.validbox();
+        Box rbx = amrex::convert(bx, rhs_type);
+        Array4<Real> const& r = rhs.array(mfi);
+        amrex::LoopOnCpu(rbx, [=] (int i, int j, int k) noexcept
+        {
+            Real x = problo[0] + (i+0.5*(1-rhs_type[0]))*dx[0];
+            Real y = problo[1] + (j+0.5*(1-rhs_type[1]))*dx[1];
+#if (AMREX_SPACEDIM == 3)
+            Real z = problo[2] + (k+0.5*(1-rhs_type[2]))*dx[2];
+#else
+            Real z = 0.0;
+#endif
+            r(i,j,k) = std::sin(6.2831853*x + t) * std::cos(3.1415927*y) + z;
+        });
+    }
+}
+
+void average_to_faces (const MultiFab& bcc, Array<MultiFab,AMREX_SPACEDIM>& bcoef)
+{
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        const IntVect iv = IntVect::TheDimensionVector(idim);
+        for (MFIter mfi(bcoef[idim]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            Array4<Real const> const& b = bcc.const_array(mfi);
+            Array4<Real> const& bf = bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+            {
+                bf(i,j,k) = 0.5*(b(i-iv[0],j-iv[1],k-iv[2]) + b(i,j,k));
+            });
+        }
+    }
+}
+
+struct Result
+{
+    Real time = 0.0;
+    Real setup_time_saved = 0.0;
+};
+
+Result run (bool reuse, int nodal, int nsteps, Real tol_rel, int verbose,
+            const Geometry& geom, const BoxArray& ba, const DistributionMapping& dm,
+            MultiFab& sol)
+{
+    const BoxArray& rhs_ba = nodal ? amrex::convert(ba, IntVect::TheNodeVector()) : ba;
+    MultiFab rhs(rhs_ba, dm, 1, 0);
+    MultiFab bcc(ba, dm, 1, 1);
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+    if (!nodal) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+        }
+    }
+
+    const Array<LinOpBCType,AMREX_SPACEDIM> bc{AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                            LinOpBCType::Dirichlet,
+                                                            LinOpBCType::Dirichlet)};
+
+    std::unique_ptr<MLABecLaplacian> mlabec;
+    std::unique_ptr<MLNodeLaplacian> mlndlap;
+    std::unique_ptr<MLMG> mlmg;
+
+    sol.setVal(0.0);
+
+    Result r;
+    Real t0 = amrex::second();
+    for (int step = 0; step < nsteps; ++step)
+    {
+        init_step(geom, step, bcc, rhs);
+
+        if (!reuse || mlmg == nullptr)
+        {
+            mlmg.reset();
+            if (nodal) {
+                mlndlap.reset(new MLNodeLaplacian({geom}, {ba}, {dm}));
+                mlndlap->setDomainBC(bc, bc);
+                mlmg.reset(new MLMG(*mlndlap));
+            } else {
+                mlabec.reset(new MLABecLaplacian({geom}, {ba}, {dm}));
+                mlabec->setDomainBC(bc, bc);
+                mlabec->setScalars(1.0, 1.0);
+                mlabec->setACoeffs(0, 1.0);
+                mlmg.reset(new MLMG(*mlabec));
+            }
+            mlmg->setVerbose(verbose);
+        }
+
+        // Only the coefficients and the boundary data are set every step.
+        if (nodal) {
+            mlndlap->setSigma(0, bcc);
+        } else {
+            mlabec->setLevelBC(0, &sol);
+            average_to_faces(bcc, bcoef);
+            mlabec->setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+        }
+
+        mlmg->solve({&sol}, {&rhs}, tol_rel, 0.0);
+    }
+    r.time = amrex::second() - t0;
+    r.setup_time_saved = mlmg->getSetupTimeSaved();
+
+    ParallelDescriptor::ReduceRealMax(r.time);
+    ParallelDescriptor::ReduceRealMax(r.setup_time_saved);
+    return r;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int nsteps = 10;
+        int nodal = 0;
+        Real tol_rel = 1.e-10;
+        int verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nsteps", nsteps);
+            pp.query("nodal", nodal);
+            pp.query("tol_rel", tol_rel);
+            pp.query("verbose", verbose);
+        }
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const BoxArray& sol_ba = nodal ? amrex::convert(ba, IntVect::TheNodeVector()) : ba;
+        MultiFab sol_rebuild(sol_ba, dm, 1, 1);
+        MultiFab sol_reuse(sol_ba, dm, 1, 1);
+
+        Result rebuild = run(false, nodal, nsteps, tol_rel, verbose, geom, ba, dm, sol_rebuild);
+        Result reuse   = run(true , nodal, nsteps, tol_rel, verbose, geom, ba, dm, sol_reuse);
+
+        amrex::Print() << "\n" << (nodal ? "MLNodeLaplacian" : "MLABecLaplacian")
+                       << ", " << n_cell << "^" << AMREX_SPACEDIM << " cells, "
+                       << ba.size() << " boxes, " << nsteps << " steps\n"
+                       << "  rebuild every step: time " << rebuild.time << "\n"
+                       << "  reuse setup       : time " << reuse.time
+                       << ", setup time saved " << reuse.setup_time_saved << "\n";
+
+        MultiFab::Subtract(sol_reuse, sol_rebuild, 0, 0, 1, 0);
+        const Real diff = sol_reuse.norm0() / sol_rebuild.norm0();
+        amrex::Print() << "  max |sol_reuse - sol_rebuild| / max |sol_rebuild| = "
+                       << diff << "\n";
+        // Reusing the setup must not change the answer beyond the solver
+        // tolerance.
+        AMREX_ALWAYS_ASSERT(diff <= 100.*tol_rel);
+    }
+    amrex::Finalize();
+}
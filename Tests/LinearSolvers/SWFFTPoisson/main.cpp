@@ -0,0 +1,152 @@
+//
+// Solve lap(phi) = rhs on a periodic domain
+//
+//   - with MLMG and its default bottom solver,
+//   - directly with SWFFTPoisson, and
+//   - with MLMG, coarsening only a few times and using SWFFTPoisson as
+//     the bottom solver,
+//
+// and compare the solutions and the times.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_SWFFTPoisson.H>
+
+using namespace amrex;
+
+namespace {
+
+void init_rhs (const Geometry& geom, MultiFab& rhs)
+{
+    const auto dx = geom.CellSizeArray();
+    const auto problo = geom.ProbLoArray();
+    const Real tpi = 8.0*std::atan(1.0);
+
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        Array4<Real> const& r = rhs.array(mfi);
+        amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+        {
+            Real x = problo[0] + (i+0.5)*dx[0];
+            Real y = problo[1] + (j+0.5)*dx[1];
+            Real z = problo[2] + (k+0.5)*dx[2];
+            r(i,j,k) = std::sin(tpi*x) * std::cos(2.0*tpi*y) * std::sin(tpi*z)
+                + 0.5 * std::cos(3.0*tpi*(x+z)) + 0.3;  // the mean is ignored
+        });
+    }
+}
+
+Real solve_mlmg (const Geometry& geom, const BoxArray& ba, const DistributionMapping& dm,
+                 MultiFab& phi, const MultiFab& rhs, int nsolves, int fft_coarsening_level,
+                 Real tol_rel, int verbose, int& niters)
+{
+    LPInfo info;
+    if (fft_coarsening_level >= 0) {
+        info.setMaxCoarseningLevel(fft_coarsening_level);
+    }
+    MLPoisson mlpoisson({geom}, {ba}, {dm}, info);
+    mlpoisson.setDomainBC({LinOpBCType::Periodic, LinOpBCType::Periodic, LinOpBCType::Periodic},
+                          {LinOpBCType::Periodic, LinOpBCType::Periodic, LinOpBCType::Periodic});
+    mlpoisson.setLevelBC(0, nullptr);
+
+    MLMG mlmg(mlpoisson);
+    mlmg.setVerbose(verbose);
+    if (fft_coarsening_level >= 0) {
+        mlmg.setBottomSolver(MLMG::BottomSolver::fft);
+    }
+
+    niters = 0;
+    Real t0 = amrex::second();
+    for (int i = 0; i < nsolves; ++i) {
+        phi.setVal(0.0);
+        mlmg.solve({&phi}, {&rhs}, tol_rel, 0.0);
+        niters += mlmg.getNumIters();
+    }
+    Real t = amrex::second() - t0;
+    ParallelDescriptor::ReduceRealMax(t);
+    return t;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int nsolves = 5;
+        int fft_coarsening_level = 2;
+        Real tol_rel = 1.e-10;
+        int verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nsolves", nsolves);
+            pp.query("fft_coarsening_level", fft_coarsening_level);
+            pp.query("tol_rel", tol_rel);
+            pp.query("verbose", verbose);
+        }
+
+        RealBox rb({0.,0.,0.}, {1.,1.,1.});
+        Array<int,AMREX_SPACEDIM> is_periodic{1,1,1};
+        Box domain(IntVect(0), IntVect(n_cell-1));
+        Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab rhs(ba, dm, 1, 0);
+        init_rhs(geom, rhs);
+
+        MultiFab phi_mg(ba, dm, 1, 1);
+        MultiFab phi_fft(ba, dm, 1, 0);
+        MultiFab phi_mgfft(ba, dm, 1, 1);
+
+        int niters_mg, niters_mgfft;
+        Real t_mg = solve_mlmg(geom, ba, dm, phi_mg, rhs, nsolves, -1,
+                               tol_rel, verbose, niters_mg);
+
+        Real t0 = amrex::second();
+        SWFFTPoisson fft(geom);
+        Real t_fft_setup = amrex::second() - t0;
+        t0 = amrex::second();
+        for (int i = 0; i < nsolves; ++i) {
+            fft.solve(phi_fft, rhs);
+        }
+        Real t_fft = amrex::second() - t0;
+        ParallelDescriptor::ReduceRealMax({t_fft_setup, t_fft});
+
+        Real t_mgfft = solve_mlmg(geom, ba, dm, phi_mgfft, rhs, nsolves, fft_coarsening_level,
+                                  tol_rel, verbose, niters_mgfft);
+
+        // The solutions are unique up to a constant.
+        const Real npts = domain.d_numPts();
+        phi_mg.plus(-phi_mg.sum()/npts, 0, 1, 0);
+        phi_mgfft.plus(-phi_mgfft.sum()/npts, 0, 1, 0);
+        const Real phinorm = phi_fft.norm0();
+        MultiFab::Subtract(phi_mgfft, phi_mg, 0, 0, 1, 0);
+        MultiFab::Subtract(phi_mg, phi_fft, 0, 0, 1, 0);
+
+        amrex::Print() << "\n" << n_cell << "^3 cells, " << ba.size() << " boxes, "
+                       << nsolves << " solves, FFT blocks " << fft.boxArray().size() << "\n"
+                       << "  MLMG                 : " << niters_mg << " V-cycles, time "
+                       << t_mg << "\n"
+                       << "  SWFFTPoisson         : setup time " << t_fft_setup
+                       << ", time " << t_fft << "\n"
+                       << "  MLMG with FFT bottom : " << niters_mgfft << " V-cycles, time "
+                       << t_mgfft << "\n"
+                       << "  max |phi_mlmg - phi_fft| / max |phi_fft|        = "
+                       << phi_mg.norm0() / phinorm << "\n"
+                       << "  max |phi_mlmg_fft - phi_mlmg| / max |phi_fft|   = "
+                       << phi_mgfft.norm0() / phinorm << "\n";
+    }
+    amrex::Finalize();
+}
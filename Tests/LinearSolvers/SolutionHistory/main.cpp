@@ -0,0 +1,179 @@
+//
+// Time stepping with the solve
+//
+//     - del dot (b grad phi) = rhs,  phi = 0 on the domain boundary,
+//
+// where b and rhs change smoothly in time.  Each step starts from a zero
+// initial guess, from the previous solution, or from an initial guess
+// built by MLSolutionHistory, and the total number of V-cycles is
+// compared.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLSolutionHistory.H>
+
+#include <iomanip>
+#include <memory>
+
+using namespace amrex;
+
+namespace {
+
+void init_step (const Geometry& geom, Real time, MultiFab& rhs,
+                Array<MultiFab,AMREX_SPACEDIM>& bcoef)
+{
+    const auto dx = geom.CellSizeArray();
+    const auto problo = geom.ProbLoArray();
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        const IntVect iv = IntVect::TheDimensionVector(idim);
+        for (MFIter mfi(bcoef[idim]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            Array4<Real> const& b = bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+            {
+                Real x = problo[0] + (i+0.5*(1-iv[0]))*dx[0];
+                Real y = problo[1] + (j+0.5*(1-iv[1]))*dx[1];
+#if (AMREX_SPACEDIM == 3)
+                Real z = problo[2] + (k+0.5*(1-iv[2]))*dx[2];
+#else
+                Real z = 0.0;
+#endif
+                b(i,j,k) = 1.0 + 0.5*std::sin(6.2831853*(x+y+z) + time);
+            });
+        }
+    }
+
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        Array4<Real> const& r = rhs.array(mfi);
+        amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+        {
+            Real x = problo[0] + (i+0.5)*dx[0];
+            Real y = problo[1] + (j+0.5)*dx[1];
+#if (AMREX_SPACEDIM == 3)
+            Real z = problo[2] + (k+0.5)*dx[2];
+#else
+            Real z = 0.0;
+#endif
+            r(i,j,k) = std::sin(6.2831853*x + time) * std::cos(3.1415927*y)
+                + std::cos(6.2831853*z - 2.0*time);
+        });
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int nsteps = 20;
+        Real dt = 0.05;
+        int history_size = 3;
+        Real tol_rel = 1.e-10;
+        int verbose = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nsteps", nsteps);
+            pp.query("dt", dt);
+            pp.query("history_size", history_size);
+            pp.query("tol_rel", tol_rel);
+            pp.query("verbose", verbose);
+        }
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab rhs(ba, dm, 1, 0);
+        Array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+        }
+
+        const int nmodes = 4;
+        const std::string mode_name[nmodes] = {"zero guess", "previous solution",
+                                               "extrapolation", "projection"};
+        int total_iters[nmodes] = {0};
+        Real total_time[nmodes] = {0.0};
+        MultiFab sol(ba, dm, 1, 1);
+        MultiFab sol_ref(ba, dm, 1, 0);
+
+        for (int mode = 0; mode < nmodes; ++mode)
+        {
+            std::unique_ptr<MLSolutionHistory> history;
+            if (mode == 2) {
+                history.reset(new MLSolutionHistory(history_size,
+                                                    MLSolutionHistory::Method::extrapolation));
+            } else if (mode == 3) {
+                history.reset(new MLSolutionHistory(history_size,
+                                                    MLSolutionHistory::Method::projection));
+            }
+
+            sol.setVal(0.0);
+            Real t0 = amrex::second();
+            for (int step = 0; step < nsteps; ++step)
+            {
+                init_step(geom, step*dt, rhs, bcoef);
+
+                // New objects every step, as in a typical projection
+                MLABecLaplacian mlabec({geom}, {ba}, {dm});
+                mlabec.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                 LinOpBCType::Dirichlet,
+                                                 LinOpBCType::Dirichlet)},
+                                   {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                 LinOpBCType::Dirichlet,
+                                                 LinOpBCType::Dirichlet)});
+                mlabec.setLevelBC(0, nullptr);
+                mlabec.setScalars(0.0, 1.0);
+                mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+
+                MLMG mlmg(mlabec);
+                mlmg.setVerbose(verbose);
+
+                if (mode != 1) sol.setVal(0.0);
+                if (history) {
+                    history->solve(mlmg, {&sol}, {&rhs}, tol_rel, 0.0);
+                } else {
+                    mlmg.solve({&sol}, {&rhs}, tol_rel, 0.0);
+                }
+                total_iters[mode] += mlmg.getNumIters();
+            }
+            total_time[mode] = amrex::second() - t0;
+            ParallelDescriptor::ReduceRealMax(total_time[mode]);
+
+            if (mode == 0) {
+                MultiFab::Copy(sol_ref, sol, 0, 0, 1, 0);
+            } else {
+                MultiFab::Subtract(sol, sol_ref, 0, 0, 1, 0);
+                AMREX_ALWAYS_ASSERT(sol.norm0() <= 1.e-6*sol_ref.norm0());
+            }
+        }
+
+        amrex::Print() << "\n" << nsteps << " steps, " << n_cell << "^" << AMREX_SPACEDIM
+                       << " cells, history size " << history_size << "\n";
+        for (int mode = 0; mode < nmodes; ++mode) {
+            amrex::Print() << "  " << std::setw(18) << mode_name[mode] << ": "
+                           << std::setw(4) << total_iters[mode] << " V-cycles, time "
+                           << total_time[mode] << "\n";
+        }
+    }
+    amrex::Finalize();
+}
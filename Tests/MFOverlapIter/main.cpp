@@ -0,0 +1,181 @@
+//
+// Applies a stencil of width ng to a MultiFab on a periodic domain in
+// three ways:
+//
+//   * after FillBoundary, with a tiling MFIter (the reference);
+//   * with MFOverlapIter, running the InteriorTiles phase between
+//     FillBoundary_nowait and FillBoundary_finish and the BoundaryTiles
+//     phase after it;
+//   * with MFOverlapIter, running the InteriorTiles phase before any
+//     FillBoundary, with garbage in the ghost cells.
+//
+// All three must give identical results, for cell-centered and nodal
+// data, several stencil widths and tile sizes, e.g.,
+//
+//     mpiexec -n 4 ./main3d.gnu.MPI.ex inputs
+//
+// It also checks that the two phases together visit every valid cell
+// (node) exactly once, and that interior tiles stay within interiorbox().
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+// Valid cells get a value that depends on the cell, ghost cells get garbage.
+void fill (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        Array4<Real> const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), mf.nComp(), [=] (int i, int j, int k, int n) noexcept
+        {
+            if (bx.contains(IntVect(AMREX_D_DECL(i,j,k)))) {
+                a(i,j,k,n) = AMREX_D_TERM(i, + 100*j, + 10000*k) + 0.5*n;
+            } else {
+                a(i,j,k,n) = 1.e200;
+            }
+        });
+    }
+}
+
+// The sum over a star of width ng.
+void stencil (const Box& bx, Array4<Real const> const& in, Array4<Real> const& out,
+              int ncomp, int ng)
+{
+    amrex::LoopOnCpu(bx, ncomp, [=] (int i, int j, int k, int n) noexcept
+    {
+        Real s = in(i,j,k,n);
+        for (int m = 1; m <= ng; ++m) {
+            s += AMREX_D_TERM(in(i-m,j,k,n) + in(i+m,j,k,n),
+                            + in(i,j-m,k,n) + in(i,j+m,k,n),
+                            + in(i,j,k-m,n) + in(i,j,k+m,n));
+        }
+        out(i,j,k,n) = s;
+    });
+}
+
+// Adds 1 to cnt on the tilebox.
+void visit (MFOverlapIter& mfi, MultiFab& cnt)
+{
+    const Box& bx = mfi.tilebox();
+    Array4<Real> const& c = cnt.array(mfi);
+    amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+    {
+        c(i,j,k) += 1.0;
+    });
+}
+
+Long ndiff (const MultiFab& a, const MultiFab& b)
+{
+    Long r = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi)
+    {
+        Array4<Real const> const& aa = a.const_array(mfi);
+        Array4<Real const> const& bb = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), a.nComp(), [&] (int i, int j, int k, int n) noexcept
+        {
+            if (aa(i,j,k,n) != bb(i,j,k,n)) ++r;
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(r);
+    return r;
+}
+
+Long test (const BoxArray& ba, const DistributionMapping& dm, int ncomp, int ng,
+           const IntVect& tilesize, const Periodicity& period)
+{
+    MultiFab in(ba, dm, ncomp, ng);
+    MultiFab ref(ba, dm, ncomp, 0);
+    MultiFab out1(ba, dm, ncomp, 0);
+    MultiFab out2(ba, dm, ncomp, 0);
+    MultiFab cnt(ba, dm, 1, 0);
+
+    // ---- reference
+    fill(in);
+    in.FillBoundary(period);
+    for (MFIter mfi(ref, tilesize); mfi.isValid(); ++mfi) {
+        stencil(mfi.tilebox(), in.const_array(mfi), ref.array(mfi), ncomp, ng);
+    }
+
+    // ---- overlapped with FillBoundary
+    fill(in);
+    cnt.setVal(0.0);
+    in.FillBoundary_nowait(period);
+    for (MFOverlapIter mfi(in, ng, MFOverlapIter::InteriorTiles, tilesize); mfi.isValid(); ++mfi) {
+        AMREX_ALWAYS_ASSERT(mfi.interiorbox().contains(mfi.tilebox()));
+        stencil(mfi.tilebox(), in.const_array(mfi), out1.array(mfi), ncomp, ng);
+        visit(mfi, cnt);
+    }
+    in.FillBoundary_finish();
+    for (MFOverlapIter mfi(in, ng, MFOverlapIter::BoundaryTiles, tilesize); mfi.isValid(); ++mfi) {
+        stencil(mfi.tilebox(), in.const_array(mfi), out1.array(mfi), ncomp, ng);
+        visit(mfi, cnt);
+    }
+    AMREX_ALWAYS_ASSERT(cnt.min(0) == 1.0 && cnt.max(0) == 1.0);
+
+    // ---- interior tiles with garbage in the ghost cells
+    fill(in);
+    for (MFOverlapIter mfi(in, ng, MFOverlapIter::InteriorTiles, tilesize); mfi.isValid(); ++mfi) {
+        stencil(mfi.tilebox(), in.const_array(mfi), out2.array(mfi), ncomp, ng);
+    }
+    in.FillBoundary(period);
+    for (MFOverlapIter mfi(in, ng, MFOverlapIter::BoundaryTiles, tilesize); mfi.isValid(); ++mfi) {
+        stencil(mfi.tilebox(), in.const_array(mfi), out2.array(mfi), ncomp, ng);
+    }
+
+    return ndiff(ref, out1) + ndiff(ref, out2);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int ncomp = 2;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+        }
+
+        Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        const Periodicity period(IntVect(AMREX_D_DECL(n_cell,n_cell,n_cell)));
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const IntVect tilesizes[] = {IntVect(AMREX_D_DECL(1024000,1024000,1024000)),
+                                     IntVect(AMREX_D_DECL(1024000,8,8)),
+                                     IntVect(AMREX_D_DECL(8,4,2))};
+
+        Long r = 0;
+        for (int nodal = 0; nodal <= 1; ++nodal) {
+            const BoxArray& ba2 = nodal ? amrex::convert(ba, IntVect::TheNodeVector()) : ba;
+            for (int ng : {1, 2, max_grid_size/2, max_grid_size}) {
+                for (const IntVect& ts : tilesizes) {
+                    const Long d = test(ba2, dm, ncomp, ng, ts, period);
+                    amrex::Print() << (nodal ? "  nodal" : "  cell-centered") << ", stencil width "
+                                   << ng << ", tile size " << ts << ": " << d
+                                   << " values differ from the reference\n";
+                    r += d;
+                }
+            }
+        }
+        AMREX_ALWAYS_ASSERT(r == 0);
+
+        amrex::Print() << "MFOverlapIter test passed\n";
+    }
+    amrex::Finalize();
+}
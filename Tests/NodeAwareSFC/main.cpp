@@ -0,0 +1,105 @@
+//
+// Compares the amount of ghost cell data exchanged between nodes by
+// FillBoundary for the flat and the node-aware SFC distributions.  The
+// assignment of ranks to nodes comes from machine.topology_file, so a fake
+// topology can be used to test on a single machine, e.g.,
+//
+//     mpiexec -n 8 ./main3d.gnu.MPI.ex inputs
+//
+// It also checks the node-aware distribution computed by the weighted
+// makeSFC on one process, and with and without sorting by weight.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Machine.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <set>
+
+using namespace amrex;
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 128;
+        int max_grid_size = 16;
+        int ncomp = 4;
+        int nghost = 2;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+            pp.query("nghost", nghost);
+        }
+
+        Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+
+        const Vector<int>& node_ids = machine::rank_node_ids();
+        const int nnodes = std::set<int>(node_ids.begin(), node_ids.end()).size();
+        amrex::Print() << ba.size() << " boxes on " << ParallelDescriptor::NProcs()
+                       << " ranks and " << nnodes << " nodes\n";
+
+        for (int node_aware = 0; node_aware < 2; ++node_aware)
+        {
+            DistributionMapping::SFC_NodeAware(node_aware);
+            DistributionMapping dm(ba);
+
+            const Long cells = DistributionMapping::ComputeDistributionMappingEdgeCut
+                (dm, ba, nghost, node_ids);
+            const Long all_cells = DistributionMapping::ComputeDistributionMappingEdgeCut
+                (dm, ba, nghost);
+
+            MultiFab mf(ba, dm, ncomp, nghost);
+            mf.setVal(1.0);
+            Real t0 = amrex::second();
+            for (int i = 0; i < 10; ++i) {
+                mf.FillBoundary();
+            }
+            Real t = amrex::second() - t0;
+            ParallelDescriptor::ReduceRealMax(t);
+
+            amrex::Print() << (node_aware ? "node-aware" : "flat      ") << " SFC: "
+                           << "inter-node bytes per FillBoundary = "
+                           << cells*ncomp*sizeof(Real)
+                           << ", inter-rank bytes = " << all_cells*ncomp*sizeof(Real)
+                           << ", time for 10 FillBoundary = " << t << "\n";
+        }
+
+        // The weighted makeSFC computes the node-aware distribution on the
+        // I/O process only, and sorting the buckets by weight must not move
+        // boxes to other nodes.
+        {
+            DistributionMapping::SFC_NodeAware(true);
+            DistributionMapping dm(ba);
+            LayoutData<Real> costs(ba, dm);
+            Vector<Real> rcost(ba.size());
+            for (int i = 0; i < ba.size(); ++i) {
+                rcost[i] = 1.0 + (i % 5);
+            }
+            for (MFIter mfi(costs); mfi.isValid(); ++mfi) {
+                costs[mfi] = rcost[mfi.index()];
+            }
+
+            Real current_eff, proposed_eff;
+            DistributionMapping dm_root = DistributionMapping::makeSFC(costs, current_eff, proposed_eff);
+            DistributionMapping dm_unsorted = DistributionMapping::makeSFC(rcost, ba, false);
+            DistributionMapping dm_sorted = DistributionMapping::makeSFC(rcost, ba, true);
+
+            int nwrong = 0;
+            for (int i = 0; i < ba.size(); ++i) {
+                if (dm_root[i] != dm_unsorted[i]) ++nwrong;
+                if (node_ids[dm_sorted[i]] != node_ids[dm_unsorted[i]]) ++nwrong;
+            }
+            amrex::Print() << "weighted node-aware SFC: efficiency " << proposed_eff
+                           << ", boxes on the wrong rank or node " << nwrong << "\n";
+            AMREX_ALWAYS_ASSERT(nwrong == 0);
+        }
+    }
+    amrex::Finalize();
+}
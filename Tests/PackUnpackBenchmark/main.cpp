@@ -0,0 +1,198 @@
+//
+// Microbenchmark of the CPU pack and unpack kernels used by FillBoundary
+// and ParallelCopy.  The copy tags of a FillBoundary pattern are grouped
+// into nmessages pseudo messages, and the current kernels are compared
+// with a reference that, like the original implementation, threads over
+// messages and copies one tag at a time.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <functional>
+
+using namespace amrex;
+
+#ifdef AMREX_USE_MPI
+
+namespace {
+
+using CCTC = FabArrayBase::CopyComTagsContainer;
+
+void pack_reference (MultiFab const& src, int ncomp, Vector<char*> const& send_data,
+                     Vector<const CCTC*> const& send_cctc)
+{
+    const int N_snds = send_data.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int j = 0; j < N_snds; ++j)
+    {
+        char* dptr = send_data[j];
+        for (auto const& tag : *send_cctc[j])
+        {
+            const Box& bx = tag.sbox;
+            auto const sfab = src.array(tag.srcIndex);
+            auto pfab = amrex::makeArray4((Real*)(dptr),bx,ncomp);
+            amrex::LoopConcurrentOnCpu( bx, ncomp,
+            [=] (int ii, int jj, int kk, int n) noexcept
+            {
+                pfab(ii,jj,kk,n) = sfab(ii,jj,kk,n);
+            });
+            dptr += (bx.numPts() * ncomp * sizeof(Real));
+        }
+    }
+}
+
+void unpack_reference (MultiFab& dst, int ncomp, Vector<char*> const& recv_data,
+                       Vector<const CCTC*> const& recv_cctc)
+{
+    const int N_rcvs = recv_data.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int k = 0; k < N_rcvs; ++k)
+    {
+        const char* dptr = recv_data[k];
+        for (auto const& tag : *recv_cctc[k])
+        {
+            dst[tag.dstIndex].copyFromMem<RunOn::Host>(tag.dbox, 0, ncomp, dptr);
+            dptr += tag.dbox.numPts() * ncomp * sizeof(Real);
+        }
+    }
+}
+
+}
+
+void main_main ()
+{
+    int n_cell = 256;
+    int max_grid_size = 32;
+    int ncomp = 4;
+    int nghost = 2;
+    int nmessages = 16;
+    int nrounds = 20;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("ncomp", ncomp);
+        pp.query("nghost", nghost);
+        pp.query("nmessages", nmessages);
+        pp.query("nrounds", nrounds);
+    }
+
+    BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm{ba};
+
+    MultiFab mf(ba, dm, ncomp, nghost);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = i + 1.e-3*j + 1.e-6*k + n;
+        });
+    }
+
+    //
+    // Group all copy tags of the FillBoundary pattern into pseudo messages.
+    //
+    const FabArrayBase::FB& fb = mf.getFB(IntVect(nghost), Periodicity(IntVect(n_cell)));
+    Vector<CCTC> msgs(nmessages);
+    for (auto const& tag : *fb.m_LocTags) {
+        msgs[tag.dstIndex % nmessages].push_back(tag);
+    }
+    for (auto const& kv : *fb.m_SndTags) {
+        for (auto const& tag : kv.second) {
+            msgs[tag.dstIndex % nmessages].push_back(tag);
+        }
+    }
+
+    Vector<std::size_t> size(nmessages, 0);
+    Vector<const CCTC*> cctc(nmessages);
+    std::size_t total_bytes = 0;
+    Long ntags = 0;
+    for (int i = 0; i < nmessages; ++i) {
+        for (auto const& tag : msgs[i]) {
+            size[i] += tag.sbox.numPts() * ncomp * sizeof(Real);
+        }
+        cctc[i] = &msgs[i];
+        total_bytes += size[i];
+        ntags += msgs[i].size();
+    }
+
+    Vector<char> buf_new(total_bytes), buf_ref(total_bytes);
+    Vector<char*> data_new(nmessages), data_ref(nmessages);
+    for (std::size_t i = 0, offset = 0; i < static_cast<std::size_t>(nmessages); ++i) {
+        data_new[i] = buf_new.data() + offset;
+        data_ref[i] = buf_ref.data() + offset;
+        offset += size[i];
+    }
+
+    auto timeit = [nrounds] (std::function<void()> const& f) -> double
+    {
+        f();
+        double t0 = amrex::second();
+        for (int i = 0; i < nrounds; ++i) {
+            f();
+        }
+        return (amrex::second() - t0) / nrounds;
+    };
+
+    const double t_pack_ref = timeit([&] () {
+        pack_reference(mf, ncomp, data_ref, cctc);
+    });
+    const double t_pack_new = timeit([&] () {
+        MultiFab::pack_send_buffer_cpu(mf, 0, ncomp, data_new, size, cctc);
+    });
+    const bool pack_ok = buf_new == buf_ref;
+
+    MultiFab mf_new(ba, dm, ncomp, nghost);
+    MultiFab mf_ref(ba, dm, ncomp, nghost);
+    mf_new.setVal(0.0);
+    mf_ref.setVal(0.0);
+    for (auto& m : msgs) {
+        // the unpack kernel reads from the buffer with dbox, so make it match sbox
+        for (auto& tag : m) tag.dbox = tag.sbox;
+    }
+
+    const double t_unpack_ref = timeit([&] () {
+        unpack_reference(mf_ref, ncomp, data_ref, cctc);
+    });
+    const double t_unpack_new = timeit([&] () {
+        MultiFab::unpack_recv_buffer_cpu(mf_new, 0, ncomp, data_new, size, cctc,
+                                         FabArrayBase::COPY, true);
+    });
+    MultiFab::Subtract(mf_new, mf_ref, 0, 0, ncomp, nghost);
+    bool unpack_ok = true;
+    for (int n = 0; n < ncomp; ++n) {
+        unpack_ok = unpack_ok && mf_new.norm0(n, nghost) == 0.0;
+    }
+
+    const double gb = static_cast<double>(total_bytes) / 1.e9;
+    amrex::Print() << "boxes: " << ba.size() << ", tags: " << ntags
+                   << ", messages: " << nmessages << ", buffer MB: "
+                   << static_cast<double>(total_bytes)/(1024.*1024.) << "\n"
+                   << "  pack   reference: " << gb/t_pack_ref   << " GB/s\n"
+                   << "  pack   current  : " << gb/t_pack_new   << " GB/s"
+                   << (pack_ok ? "" : "  (MISMATCH)") << "\n"
+                   << "  unpack reference: " << gb/t_unpack_ref << " GB/s\n"
+                   << "  unpack current  : " << gb/t_unpack_new << " GB/s"
+                   << (unpack_ok ? "" : "  (MISMATCH)") << "\n";
+}
+
+#endif
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+#ifdef AMREX_USE_MPI
+    main_main();
+#else
+    amrex::Print() << "This benchmark requires USE_MPI=TRUE\n";
+#endif
+    amrex::Finalize();
+}
@@ -0,0 +1,191 @@
+//
+// Compares FillBoundary with persistent MPI requests
+// (fabarray.use_persistent_comm = 1) against FillBoundary with the
+// per-call messages, on a periodic domain, over several calls with new
+// data each time, e.g.,
+//
+//     mpiexec -n 4 ./main3d.gnu.MPI.ex inputs
+//
+// The ghost cells must be identical.  It also checks
+//
+//   * two MultiFabs with the same layout between FillBoundary_nowait and
+//     FillBoundary_finish at the same time, where the second one cannot
+//     use the persistent requests of the first;
+//   * a flush of the FillBoundary cache between FillBoundary_nowait and
+//     FillBoundary_finish, which must not free the requests in flight;
+//   * an iMultiFab, whose values have a different size;
+//   * a regrid to a different BoxArray and DistributionMapping.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_iMultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+namespace {
+
+// Valid cells get a value that depends on the cell, the component and the
+// call, and ghost cells get garbage.
+template <class FAB>
+void fill (FabArray<FAB>& fa, int icall)
+{
+    using T = typename FAB::value_type;
+    const int ncomp = fa.nComp();
+    for (MFIter mfi(fa); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const Box& gbx = mfi.fabbox();
+        Array4<T> const& a = fa.array(mfi);
+        amrex::LoopOnCpu(gbx, ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            if (bx.contains(IntVect(AMREX_D_DECL(i,j,k)))) {
+                a(i,j,k,n) = static_cast<T>(AMREX_D_TERM(i, + 1000*j, + 1000000*k)
+                                            + 7*n + 13*icall);
+            } else {
+                a(i,j,k,n) = static_cast<T>(-1);
+            }
+        });
+    }
+}
+
+// Number of cells, including ghost cells, where a and b differ.
+template <class FAB>
+Long ndiff (const FabArray<FAB>& a, const FabArray<FAB>& b)
+{
+    using T = typename FAB::value_type;
+    Long r = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi)
+    {
+        Array4<T const> const& aa = a.const_array(mfi);
+        Array4<T const> const& bb = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), a.nComp(), [&] (int i, int j, int k, int n) noexcept
+        {
+            if (aa(i,j,k,n) != bb(i,j,k,n)) ++r;
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(r);
+    return r;
+}
+
+// Is the persistent communication of fa's FillBoundary set up, and idle?
+template <class FAB>
+bool has_idle_persistent (const FabArray<FAB>& fa, const Periodicity& period)
+{
+    if (ParallelDescriptor::NProcs() == 1) return true;
+    using T = typename FAB::value_type;
+    const auto& fb = fa.getFB(fa.nGrowVect(), period);
+    auto pc = fb.getPersistentComm(fa.nComp(), sizeof(T), alignof(T));
+    return pc && !pc->m_active;
+}
+
+template <class FAB>
+Long compare (const BoxArray& ba, const DistributionMapping& dm, int ncomp, int nghost,
+              int ncalls, const Periodicity& period)
+{
+    FabArray<FAB> a(ba, dm, ncomp, nghost);
+    FabArray<FAB> b(ba, dm, ncomp, nghost);
+    FabArray<FAB> c(ba, dm, ncomp, nghost);
+    FabArray<FAB> d(ba, dm, ncomp, nghost);
+
+    Long r = 0;
+    for (int icall = 0; icall < ncalls; ++icall)
+    {
+        fill(a, icall);
+        fill(b, icall);
+        fill(c, icall);
+        fill(d, icall);
+
+        FabArrayBase::use_persistent_comm = false;
+        a.FillBoundary(period);
+
+        FabArrayBase::use_persistent_comm = true;
+        b.FillBoundary(period);
+        AMREX_ALWAYS_ASSERT(has_idle_persistent(b, period));
+
+        // Two at once
+        b.FillBoundary_nowait(period);
+        c.FillBoundary_nowait(period);
+        c.FillBoundary_finish();
+        b.FillBoundary_finish();
+
+        // A flush of the cache in between
+        d.FillBoundary_nowait(period);
+        if (icall % 2 == 1) {
+            FabArrayBase::flushFBCache();
+        }
+        d.FillBoundary_finish();
+
+        r += ndiff(a, b) + ndiff(a, c) + ndiff(a, d);
+    }
+    return r;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int ncomp = 3;
+        int nghost = 2;
+        int ncalls = 5;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+            pp.query("nghost", nghost);
+            pp.query("ncalls", ncalls);
+        }
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(FabArrayBase::use_persistent_comm,
+                                         "Run with fabarray.use_persistent_comm = 1");
+
+        Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        const Periodicity period(IntVect(AMREX_D_DECL(n_cell,n_cell,n_cell)));
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        // After a regrid: smaller boxes in one corner, and another mapping.
+        BoxList bl;
+        for (int i = 0; i < ba.size(); ++i) {
+            const Box bx = ba[i];
+            if (bx.smallEnd() == IntVect::TheZeroVector()) {
+                BoxArray corner(bx);
+                corner.maxSize(max_grid_size/2);
+                for (int j = 0; j < corner.size(); ++j) bl.push_back(corner[j]);
+            } else {
+                bl.push_back(bx);
+            }
+        }
+        BoxArray ba2(std::move(bl));
+        DistributionMapping dm2(ba2, ParallelDescriptor::NProcs());
+        Vector<int> pmap2 = dm2.ProcessorMap();
+        std::reverse(pmap2.begin(), pmap2.end());
+        dm2.define(std::move(pmap2));
+
+        amrex::Print() << ba.size() << " boxes, then " << ba2.size() << " boxes, on "
+                       << ParallelDescriptor::NProcs() << " processes\n";
+
+        const Long n1 = compare<FArrayBox>(ba, dm, ncomp, nghost, ncalls, period);
+        const Long n2 = compare<IArrayBox>(ba, dm, ncomp, nghost, ncalls, period);
+        const Long n3 = compare<FArrayBox>(ba2, dm2, ncomp, nghost, ncalls, period);
+        const Long n4 = compare<IArrayBox>(ba2, dm2, 1, nghost, ncalls, period);
+
+        amrex::Print() << "cells that differ from the non-persistent FillBoundary: "
+                       << n1 << " " << n2 << " (before regrid), "
+                       << n3 << " " << n4 << " (after regrid)\n";
+        AMREX_ALWAYS_ASSERT(n1 == 0 && n2 == 0 && n3 == 0 && n4 == 0);
+
+        amrex::Print() << "PersistentFillBoundary test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,171 @@
+//
+// Compares the split-phase reductions (ParallelAllReduce::*_nowait,
+// MultiFab::Dot_nowait and MultiFab::norm*_nowait) with the blocking
+// ones, e.g.,
+//
+//     mpiexec -n 4 ./main3d.gnu.MPI.ex inputs
+//
+// Several reductions are in flight at once and are completed in a
+// different order than they were started, with wait(), test(), get() and
+// by the destructor of the handle.  Sums may be added up in a different
+// order by MPI_Iallreduce and MPI_Allreduce, so they are compared to a
+// relative 1e-14; maxima and minima must be identical.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_iMultiFab.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+bool close (Real a, Real b)
+{
+    return std::abs(a-b) <= 1.e-14 * std::max(std::abs(a), std::abs(b));
+}
+
+bool check (const std::string& name, bool ok)
+{
+    amrex::Print() << "  " << name << ": " << (ok ? "ok" : "FAILED") << "\n";
+    return ok;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int ncomp = 3;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+        }
+
+        const MPI_Comm comm = ParallelDescriptor::Communicator();
+        const int myproc = ParallelDescriptor::MyProc();
+        bool ok = true;
+
+        // ---- ParallelAllReduce
+        {
+            Real s = myproc + 0.25, smax = s, smin = -s;
+            Real v[3] = {1.0*myproc, 2.0*myproc, -1.0*myproc};
+            Long a = myproc, b = 2*myproc;
+            auto hs = ParallelAllReduce::Sum_nowait(s, comm);
+            auto hmax = ParallelAllReduce::Max_nowait(smax, comm);
+            auto hmin = ParallelAllReduce::Min_nowait(smin, comm);
+            auto hv = ParallelAllReduce::Sum_nowait(v, 3, comm);
+            {
+                auto hab = ParallelAllReduce::Sum_nowait<Long>({a,b}, comm);
+                // ---- the destructor completes hab
+            }
+            while (!hmin.test()) {}
+            hv.wait();
+            hmax.wait();
+            hs.wait();
+
+            Real s_ref = myproc + 0.25, smax_ref = s_ref, smin_ref = -s_ref;
+            Real v_ref[3] = {1.0*myproc, 2.0*myproc, -1.0*myproc};
+            Long a_ref = myproc, b_ref = 2*myproc;
+            ParallelAllReduce::Sum(s_ref, comm);
+            ParallelAllReduce::Max(smax_ref, comm);
+            ParallelAllReduce::Min(smin_ref, comm);
+            ParallelAllReduce::Sum(v_ref, 3, comm);
+            ParallelAllReduce::Sum<Long>({a_ref,b_ref}, comm);
+
+            ok = check("ParallelAllReduce",
+                       close(s, s_ref) && smax == smax_ref && smin == smin_ref &&
+                       close(v[0], v_ref[0]) && close(v[1], v_ref[1]) && close(v[2], v_ref[2]) &&
+                       a == a_ref && b == b_ref && hs.get() == s) && ok;
+        }
+
+        Box domain(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab x(ba, dm, ncomp, 1);
+        MultiFab y(ba, dm, ncomp, 1);
+        iMultiFab mask(ba, dm, 1, 1);
+        for (MFIter mfi(x); mfi.isValid(); ++mfi)
+        {
+            Array4<Real> const& xa = x.array(mfi);
+            Array4<Real> const& ya = y.array(mfi);
+            Array4<int> const& ma = mask.array(mfi);
+            amrex::LoopOnCpu(mfi.fabbox(), ncomp, [=] (int i, int j, int k, int n) noexcept
+            {
+                xa(i,j,k,n) = std::sin(0.1*i + 0.2*j + 0.3*k + n) - 0.1*n;
+                ya(i,j,k,n) = std::cos(0.3*i - 0.1*j + 0.2*k) + n;
+                if (n == 0) ma(i,j,k) = (i+j+k) % 3 != 0;
+            });
+        }
+
+        // ---- MultiFab dot products
+        {
+            auto h1 = MultiFab::Dot_nowait(x, 0, y, 0, ncomp, 1);
+            auto h2 = MultiFab::Dot_nowait(x, 1, ncomp-1, 0);
+            auto h3 = MultiFab::Dot_nowait(mask, x, 0, y, 1, ncomp-1, 1);
+            const Real d3 = h3.get();
+            const Real d2 = h2.get();
+            const Real d1 = h1.get();
+            ok = check("Dot",
+                       close(d1, MultiFab::Dot(x, 0, y, 0, ncomp, 1)) &&
+                       close(d2, MultiFab::Dot(x, 1, ncomp-1, 0)) &&
+                       close(d3, MultiFab::Dot(mask, x, 0, y, 1, ncomp-1, 1))) && ok;
+        }
+
+        // ---- MultiFab norms
+        {
+            Vector<int> comps(ncomp);
+            for (int n = 0; n < ncomp; ++n) comps[n] = ncomp-1-n;
+
+            auto h0 = x.norm0_nowait(1, 1);
+            auto h0v = x.norm0_nowait(comps);
+            auto h1 = x.norm1_nowait(2, 1);
+            auto h1v = x.norm1_nowait(comps);
+            auto h2 = x.norm2_nowait(0);
+            auto h2v = x.norm2_nowait(comps);
+
+            const Vector<Real> n2v = h2v.values();
+            const Real n2 = h2.get();
+            const Vector<Real> n1v = h1v.values();
+            const Real n1 = h1.get();
+            const Vector<Real> n0v = h0v.values();
+            const Real n0 = h0.get();
+
+            const Vector<Real> n0v_ref = x.norm0(comps);
+            const Vector<Real> n1v_ref = x.norm1(comps);
+            const Vector<Real> n2v_ref = x.norm2(comps);
+            bool vok = (n0v.size() == ncomp && n1v.size() == ncomp && n2v.size() == ncomp);
+            for (int n = 0; vok && n < ncomp; ++n) {
+                vok = n0v[n] == n0v_ref[n] && close(n1v[n], n1v_ref[n]) && close(n2v[n], n2v_ref[n]);
+            }
+            ok = check("norms",
+                       n0 == x.norm0(1, 1) && close(n1, x.norm1(2, 1)) && close(n2, x.norm2(0)) && vok) && ok;
+        }
+
+        // ---- moved handles
+        {
+            Real s = 1.0;
+            ReduceHandle<Real> h;
+            h = ParallelAllReduce::Sum_nowait(s, comm);
+            ReduceHandle<Real> h2(std::move(h));
+            h2.wait();
+            ok = check("moved handle", s == ParallelDescriptor::NProcs()) && ok;
+        }
+
+        AMREX_ALWAYS_ASSERT(ok);
+        amrex::Print() << "ReduceHandle test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,269 @@
+//
+// Tests of the block compression used by the Compressed_v1 VisMF header
+// version.  Blocks of random, constant, smooth, non-finite and tiny data
+// are compressed with Compression::CompressBlock and decoded again:
+//
+//   * lossless blocks must decode to the same bits, after a round trip
+//     through the written RealDescriptor if that is not the native one;
+//   * quantized blocks must be within the tolerance, and blocks that
+//     cannot be quantized (non-finite values, too large a range) must be
+//     stored losslessly;
+//   * incompressible data must not grow by more than the method byte.
+//
+// The LZ stage is also tested on its own, including that truncated data
+// are rejected, and the byte order of the integers and of lo and step in
+// a quantized block is checked.  Finally, VisMF::AsyncWrite of a MultiFab
+// with the Compressed_v1 header version must write a compressed file.
+//
+
+#include <AMReX.H>
+#include <AMReX_AsyncOut.H>
+#include <AMReX_Compression.H>
+#include <AMReX_FPC.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_VisMF.H>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+
+using namespace amrex;
+
+namespace {
+
+const Real pi = 3.14159265358979323846;
+
+const char* method_name (int method)
+{
+    switch (method) {
+    case Compression::Raw:          return "raw";
+    case Compression::Shuffle_LZ:   return "shuffle+LZ";
+    case Compression::Quantized_LZ: return "quantized";
+    default:                        return "unknown";
+    }
+}
+
+// Compresses and decodes a block, checks the result and returns the method.
+int round_trip (const std::string& name, const Vector<Real>& data,
+                const RealDescriptor& rd, Real tol, bool verbose = true)
+{
+    const Long n = data.size();
+    Vector<char> out;
+    // ---- something before the block, as in a FAB with several blocks
+    out.push_back('x');
+    Compression::CompressBlock(data.data(), n, rd, tol, out);
+    AMREX_ALWAYS_ASSERT(out.size() >= 2 && out[0] == 'x');
+    const int method = static_cast<unsigned char>(out[1]);
+
+    Vector<Real> res(n, -1.0);
+    Compression::DecompressBlock(out.data() + 1, out.size() - 1, res.data(), n, rd);
+
+    const bool native = (rd == FPC::NativeRealDescriptor());
+    if (method == Compression::Quantized_LZ) {
+        AMREX_ALWAYS_ASSERT(tol > 0.0);
+        for (Long i = 0; i < n; ++i) {
+            AMREX_ALWAYS_ASSERT(std::abs(res[i] - data[i]) <= tol);
+        }
+    } else {
+        // ---- the same bits as the data written in the format rd
+        Vector<Real> expected(data);
+        if (!native) {
+            Vector<char> bytes(n * rd.numBytes());
+            RealDescriptor::convertFromNativeFormat(bytes.data(), n, data.data(), rd);
+            RealDescriptor::convertToNativeFormat(expected.data(), n, bytes.data(), rd);
+        }
+        AMREX_ALWAYS_ASSERT(std::memcmp(res.data(), expected.data(), n * sizeof(Real)) == 0);
+        AMREX_ALWAYS_ASSERT(static_cast<Long>(out.size()) - 1 <= 1 + n * rd.numBytes());
+    }
+
+    if (verbose) {
+        amrex::Print() << "  " << name << ", " << n << " values, tolerance " << tol
+                       << (native ? "" : ", non-native") << ": " << method_name(method)
+                       << ", " << out.size() - 1 << " bytes\n";
+    }
+    return method;
+}
+
+void test_lz (const std::string& name, const Vector<char>& in)
+{
+    const Long n = in.size();
+    Vector<char> out(Compression::LZBound(n));
+    const Long clen = Compression::LZCompress(in.data(), n, out.data());
+    AMREX_ALWAYS_ASSERT(clen > 0 && clen <= Compression::LZBound(n));
+
+    Vector<char> res(n + 1, 'y');
+    AMREX_ALWAYS_ASSERT(Compression::LZDecompress(out.data(), clen, res.data(), n));
+    AMREX_ALWAYS_ASSERT(std::memcmp(res.data(), in.data(), n) == 0 && res[n] == 'y');
+    // ---- truncated data, and data that decode to the wrong size
+    AMREX_ALWAYS_ASSERT(n == 0 || !Compression::LZDecompress(out.data(), clen-1, res.data(), n));
+    AMREX_ALWAYS_ASSERT(!Compression::LZDecompress(out.data(), clen, res.data(), n+1));
+
+    // ---- the hash table kept from an earlier call must not matter
+    Vector<char> out2(Compression::LZBound(n));
+    const Long clen2 = Compression::LZCompress(in.data(), n, out2.data());
+    AMREX_ALWAYS_ASSERT(clen2 == clen && std::memcmp(out.data(), out2.data(), clen) == 0);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        Long n = 10000;
+        Real tol = 1.e-6;
+        int n_cell = 32;
+        int max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("n", n);
+            pp.query("tolerance", tol);
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        std::mt19937_64 gen(42);
+
+        const RealDescriptor& native = FPC::NativeRealDescriptor();
+        const RealDescriptor& ieee64 = FPC::Ieee64NormalRealDescriptor();
+        const RealDescriptor& ieee32 = FPC::Ieee32NormalRealDescriptor();
+
+        amrex::Print() << "\nLZ\n";
+        {
+            for (Long m = 0; m <= 64; ++m) {
+                Vector<char> zeros(m, 0);
+                Vector<char> random(m);
+                for (auto& c : random) c = static_cast<char>(gen());
+                test_lz("zeros", zeros);
+                test_lz("random", random);
+            }
+            Vector<char> pattern(100000);
+            for (Long i = 0; i < pattern.size(); ++i) {
+                pattern[i] = "abcdefg"[i % 7] + static_cast<char>((i / 1000) % 3);
+            }
+            test_lz("pattern", pattern);
+            Vector<char> random(100000);
+            for (auto& c : random) c = static_cast<char>(gen());
+            test_lz("random", random);
+            amrex::Print() << "  round trips of zeros, random bytes and patterns passed\n";
+        }
+
+        amrex::Print() << "\nByte order\n";
+        {
+            char b[8];
+            Compression::PutInt64(0x0102030405060708LL, b);
+            for (int i = 0; i < 8; ++i) {
+                AMREX_ALWAYS_ASSERT(b[i] == 8-i);
+            }
+            AMREX_ALWAYS_ASSERT(Compression::GetInt64(b) == 0x0102030405060708LL);
+            Compression::PutInt64(-2, b);
+            AMREX_ALWAYS_ASSERT(Compression::GetInt64(b) == -2);
+
+            // ---- lo of a quantized block
+            Vector<Real> data{1.0, 1.0, 1.0, 1.0};
+            Vector<char> out;
+            Compression::CompressBlock(data.data(), data.size(), native, 0.5, out);
+            AMREX_ALWAYS_ASSERT(out[0] == Compression::Quantized_LZ);
+            const double lo = 1.0;
+            std::uint64_t bits;
+            std::memcpy(&bits, &lo, sizeof(double));
+            AMREX_ALWAYS_ASSERT(static_cast<std::uint64_t>(Compression::GetInt64(out.data()+1)) == bits);
+            amrex::Print() << "  passed\n";
+        }
+
+        amrex::Print() << "\nBlocks\n";
+        {
+            Vector<Real> random(n);
+            for (auto& x : random) {
+                // ---- random bits, except for non-finite values
+                do {
+                    const std::uint64_t u = gen();
+                    std::memcpy(&x, &u, sizeof(Real));
+                } while (!std::isfinite(x));
+            }
+            Vector<Real> constant(n, 3.25);
+            Vector<Real> smooth(n);
+            for (Long i = 0; i < n; ++i) {
+                smooth[i] = std::sin(2.0*pi*i/n) + 0.5*std::cos(6.0*pi*i/n);
+            }
+            Vector<Real> nonfinite(smooth);
+            nonfinite[n/3] = std::numeric_limits<Real>::quiet_NaN();
+            nonfinite[n/2] = std::numeric_limits<Real>::infinity();
+            nonfinite[n-1] = -std::numeric_limits<Real>::infinity();
+            Vector<Real> wide(smooth);
+            wide[n/2] = 1.e30;
+
+            AMREX_ALWAYS_ASSERT(round_trip("random", random, native, 0.0) == Compression::Raw);
+            AMREX_ALWAYS_ASSERT(round_trip("random", random, native, tol) == Compression::Raw);
+            AMREX_ALWAYS_ASSERT(round_trip("constant", constant, native, 0.0) == Compression::Shuffle_LZ);
+            AMREX_ALWAYS_ASSERT(round_trip("constant", constant, native, tol) == Compression::Quantized_LZ);
+            round_trip("smooth", smooth, native, 0.0);
+            AMREX_ALWAYS_ASSERT(round_trip("smooth", smooth, native, tol) == Compression::Quantized_LZ);
+            round_trip("NaN/Inf", nonfinite, native, 0.0);
+            AMREX_ALWAYS_ASSERT(round_trip("NaN/Inf", nonfinite, native, tol) != Compression::Quantized_LZ);
+            AMREX_ALWAYS_ASSERT(round_trip("wide range", wide, native, tol) != Compression::Quantized_LZ);
+
+            for (const RealDescriptor* rd : {&ieee64, &ieee32}) {
+                if (*rd == native) continue;
+                round_trip("random", random, *rd, 0.0);
+                round_trip("constant", constant, *rd, 0.0);
+                round_trip("smooth", smooth, *rd, 0.0);
+                round_trip("NaN/Inf", nonfinite, *rd, 0.0);
+                AMREX_ALWAYS_ASSERT(round_trip("smooth", smooth, *rd, tol) == Compression::Quantized_LZ);
+            }
+
+            // ---- tiny blocks, shorter than what the LZ stage can match
+            for (Long m = 0; m <= 12; ++m) {
+                Vector<Real> tiny(smooth.begin(), smooth.begin() + m);
+                Vector<Real> tiny_random(random.begin(), random.begin() + m);
+                for (const RealDescriptor* rd : {&native, &ieee64, &ieee32}) {
+                    round_trip("tiny", tiny, *rd, 0.0, false);
+                    round_trip("tiny", tiny, *rd, tol, false);
+                    round_trip("tiny random", tiny_random, *rd, 0.0, false);
+                }
+            }
+            amrex::Print() << "  round trips of blocks of 0 to 12 values passed\n";
+        }
+
+        amrex::Print() << "\nVisMF::AsyncWrite with the Compressed_v1 header version\n";
+        {
+            Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+            BoxArray ba(domain);
+            ba.maxSize(max_grid_size);
+            DistributionMapping dm(ba);
+            MultiFab mf(ba, dm, 2, 0);
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                Array4<Real> const& a = mf.array(mfi);
+                amrex::LoopOnCpu(mfi.validbox(), 2, [=] (int i, int j, int k, int c) noexcept
+                {
+                    a(i,j,k,c) = std::sin(0.1*i + 0.2*j + 0.3*k) + c;
+                });
+            }
+
+            const VisMF::Header::Version vers = VisMF::GetHeaderVersion();
+            VisMF::SetHeaderVersion(VisMF::Header::Compressed_v1);
+            VisMF::AsyncWrite(mf, "compressed_mf");
+            AsyncOut::Finish();
+            VisMF::SetHeaderVersion(vers);
+            ParallelDescriptor::Barrier();
+
+            int written_vers = -1;
+            std::ifstream ifs("compressed_mf_H");
+            ifs >> written_vers;
+            AMREX_ALWAYS_ASSERT(written_vers == VisMF::Header::Compressed_v1);
+
+            MultiFab mf2(ba, dm, 2, 0);
+            VisMF::Read(mf2, "compressed_mf");
+            MultiFab::Subtract(mf2, mf, 0, 0, 2, 0);
+            AMREX_ALWAYS_ASSERT(mf2.norm0(0) == 0.0 && mf2.norm0(1) == 0.0);
+            amrex::Print() << "  header version " << written_vers << ", data identical\n";
+        }
+
+        amrex::Print() << "\nCompression test passed\n";
+    }
+    amrex::Finalize();
+}
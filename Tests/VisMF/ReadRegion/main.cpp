@@ -0,0 +1,290 @@
+//
+// Round trip test of VisMF::readFABRegion and PlotFileData::findCells.
+//
+// A MultiFab with ghost cells is written with every VisMF header version
+// (with and without lossy compression) and with native and non-native
+// real formats.  Parts of each FAB read with readFABRegion, including its
+// ghost cells, must be identical to the data read with GetFab, and cells
+// outside the region must not be touched.
+//
+// The MultiFab is also written as a plotfile, and findCells must find the
+// same cells as a search of all of the data read back.  That only works
+// if the grid bounds it prunes with cover the values as they are on
+// disk, rounded to 32 bits or changed by lossy compression.
+//
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_VisMF.H>
+
+#include <cstdint>
+#include <limits>
+
+using namespace amrex;
+
+namespace {
+
+Real data_value (int i, int j, int k, int n)
+{
+    std::uint64_t h = static_cast<std::uint64_t>(i+7)*73856093ULL
+        ^ static_cast<std::uint64_t>(j+7)*19349663ULL
+        ^ static_cast<std::uint64_t>(k+7)*83492791ULL
+        ^ static_cast<std::uint64_t>(n+1)*2654435761ULL;
+    h ^= h >> 29;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 32;
+    // In (-0.9,0.9), times a different magnitude for each component
+    const Real v = 1.8*(static_cast<Real>(h % 1000003) / 1000003.0 - 0.5);
+    return v * std::pow(10.0, n-1);
+}
+
+void init_data (MultiFab& mf)
+{
+    const int ncomp = mf.nComp();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Array4<Real> const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = data_value(i,j,k,n);
+        });
+        // The largest value of the first component is just below 1, so
+        // that it rounds up to a larger value in 32 bits than the maximum
+        // recorded in the header.
+        const IntVect iv(AMREX_D_DECL(3,5,7));
+        if (mfi.validbox().contains(iv)) {
+            a(iv,0) = 1.0 - std::pow(2.0, -30);
+        }
+    }
+}
+
+// Returns the number of wrong values.
+Long check_regions (VisMF& vismf, const BoxArray& ba, int ngrow)
+{
+    const int ncomp = vismf.nComp();
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int myproc = ParallelDescriptor::MyProc();
+    const Real sentinel = -1.e200;
+    Long nerrors = 0;
+
+    for (int igrid = myproc; igrid < ba.size(); igrid += nprocs)
+    {
+        const Box vbx = ba[igrid];
+        const Box fbx = amrex::grow(vbx, ngrow);
+
+        Vector<Box> boxes;
+        boxes.push_back(fbx);                                         // all of it
+        boxes.push_back(vbx);                                         // valid cells
+        boxes.push_back(Box(fbx.smallEnd()-1, fbx.smallEnd()+2));     // a corner, partly outside
+        boxes.push_back(Box(fbx.bigEnd(), fbx.bigEnd()));             // one ghost cell
+        Box slab(fbx);
+        slab.setSmall(AMREX_SPACEDIM-1, vbx.smallEnd(AMREX_SPACEDIM-1)+1);
+        slab.setBig  (AMREX_SPACEDIM-1, vbx.smallEnd(AMREX_SPACEDIM-1)+1);
+        boxes.push_back(slab);                                        // a slice
+        Box pencil(vbx);
+        pencil.setSmall(0, vbx.smallEnd(0)+1).setBig(0, vbx.smallEnd(0)+1);
+        boxes.push_back(pencil);                                      // non-contiguous rows
+
+        for (int ib = 0; ib < boxes.size(); ++ib)
+        {
+            const Box& bx = boxes[ib];
+            // For the valid box, a destination that covers only part of it
+            Box dbx = amrex::grow(bx, 1);
+            if (ib == 1) {
+                dbx.setBig(0, vbx.smallEnd(0) + vbx.length(0)/2);
+            }
+
+            for (int srccomp = 0; srccomp < ncomp; ++srccomp)
+            {
+                const int numcomp = ncomp - srccomp;
+                FArrayBox dest(dbx, numcomp+1);
+                dest.setVal<RunOn::Host>(sentinel);
+                vismf.readFABRegion(dest, bx, igrid, srccomp, 1, numcomp);
+
+                const Box region = bx & fbx & dbx;
+                for (int n = 0; n < numcomp; ++n)
+                {
+                    const FArrayBox& ref = vismf.GetFab(igrid, srccomp+n);
+                    const auto& d = dest.const_array(1+n);
+                    const auto& r = ref.const_array();
+                    amrex::LoopOnCpu(dbx, [&] (int i, int j, int k) noexcept
+                    {
+                        const IntVect iv(AMREX_D_DECL(i,j,k));
+                        const Real expected = region.contains(iv) ? r(i,j,k) : sentinel;
+                        if (d(i,j,k) != expected) ++nerrors;
+                    });
+                }
+                const auto& d0 = dest.const_array(0);
+                amrex::LoopOnCpu(dbx, [&] (int i, int j, int k) noexcept
+                {
+                    if (d0(i,j,k) != sentinel) ++nerrors;
+                });
+            }
+        }
+
+        for (int n = 0; n < ncomp; ++n) {
+            vismf.clear(igrid, n);
+        }
+    }
+
+    ParallelDescriptor::ReduceLongSum(nerrors);
+    return nerrors;
+}
+
+// Returns the number of queries whose results differ from a search of all
+// of the data.
+int check_find_cells (const std::string& plotfile, int ncomp)
+{
+    PlotFileData pf(plotfile);
+    const Box& domain = pf.probDomain(0);
+    Box region(domain);
+    region.setBig(0, domain.smallEnd(0) + domain.length(0)/3);
+
+    int nerrors = 0;
+    for (int n = 0; n < ncomp; ++n)
+    {
+        const std::string var = "v" + std::to_string(n);
+        const MultiFab mf = pf.get(0, var);
+        const Real vmin = mf.min(0);
+        const Real vmax = mf.max(0);
+        const Real big = std::numeric_limits<Real>::max();
+
+        struct Query { Real lo, hi; Box region; };
+        const Query queries[] = {
+            {vmax, big, Box()},                     // only the largest value(s)
+            {-big, vmin, Box()},                    // only the smallest value(s)
+            {0.25*vmin, 0.25*vmax, Box()},
+            {vmin + 0.5*(vmax-vmin), big, region}
+        };
+
+        for (const auto& q : queries)
+        {
+            const PlotFileCells found = pf.findCells(0, var, q.lo, q.hi, q.region);
+            Long nfound = found.cells.size();
+            for (int i = 0; i < found.values.size(); ++i) {
+                if (found.values[i] < q.lo || found.values[i] > q.hi ||
+                    (q.region.ok() && !q.region.contains(found.cells[i]))) {
+                    ++nfound;   // counts a wrong cell twice, so the totals differ
+                }
+            }
+
+            Long nexpected = 0;
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                const Box bx = q.region.ok() ? (mfi.validbox() & q.region) : mfi.validbox();
+                const auto& a = mf.const_array(mfi);
+                amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+                {
+                    if (a(i,j,k) >= q.lo && a(i,j,k) <= q.hi) ++nexpected;
+                });
+            }
+
+            ParallelDescriptor::ReduceLongSum(nfound);
+            ParallelDescriptor::ReduceLongSum(nexpected);
+            if (nfound != nexpected || nexpected == 0) {
+                amrex::Print() << "    findCells " << var << " [" << q.lo << "," << q.hi
+                               << "]: found " << nfound << ", expected " << nexpected << "\n";
+                ++nerrors;
+            }
+        }
+    }
+    return nerrors;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 8;
+        int ncomp = 3;
+        int ngrow = 2;
+        Real tolerance = 1.e-4;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+            pp.query("ngrow", ngrow);
+            pp.query("tolerance", tolerance);
+        }
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab mf(ba, dm, ncomp, ngrow);
+        init_data(mf);
+        MultiFab mf_valid(ba, dm, ncomp, 0);
+        MultiFab::Copy(mf_valid, mf, 0, 0, ncomp, 0);
+
+        Vector<std::string> varnames;
+        for (int n = 0; n < ncomp; ++n) {
+            varnames.push_back("v" + std::to_string(n));
+        }
+
+        struct Case { VisMF::Header::Version version; Real tolerance; const char* name; };
+        const Case cases[] = {
+            {VisMF::Header::Version_v1,             0.0,       "Version_v1"},
+            {VisMF::Header::NoFabHeader_v1,         0.0,       "NoFabHeader_v1"},
+            {VisMF::Header::NoFabHeaderMinMax_v1,   0.0,       "NoFabHeaderMinMax_v1"},
+            {VisMF::Header::NoFabHeaderFAMinMax_v1, 0.0,       "NoFabHeaderFAMinMax_v1"},
+            {VisMF::Header::Compressed_v1,          0.0,       "Compressed_v1"},
+            {VisMF::Header::Compressed_v1,          tolerance, "Compressed_v1 (lossy)"}
+        };
+        struct Format { FABio::Format format; const char* name; };
+        const Format formats[] = {
+            {FABio::FAB_NATIVE,    "NATIVE"},
+            {FABio::FAB_NATIVE_32, "NATIVE_32"},
+            {FABio::FAB_IEEE_32,   "IEEE_32"}
+        };
+
+        const VisMF::Header::Version old_version = VisMF::GetHeaderVersion();
+        const Real old_tolerance = VisMF::GetCompressionTolerance();
+        const FABio::Format old_format = FArrayBox::getFormat();
+
+        int nfailed = 0;
+        for (const auto& c : cases)
+        {
+            for (const auto& f : formats)
+            {
+                VisMF::SetHeaderVersion(c.version);
+                VisMF::SetCompressionTolerance(c.tolerance);
+                FArrayBox::setFormat(f.format);
+
+                const std::string mf_name = "vismf_region_mf";
+                VisMF::Write(mf, mf_name);
+                const std::string plotfile = "vismf_region_plt";
+                WriteSingleLevelPlotfile(plotfile, mf_valid, varnames, geom, 0.0, 0);
+
+                Long nwrong;
+                {
+                    VisMF vismf(mf_name);
+                    nwrong = check_regions(vismf, ba, ngrow);
+                }
+                const int nbadqueries = check_find_cells(plotfile, ncomp);
+
+                amrex::Print() << "  " << c.name << ", " << f.name << ": "
+                               << nwrong << " wrong values from readFABRegion, "
+                               << nbadqueries << " wrong findCells queries\n";
+                if (nwrong != 0 || nbadqueries != 0) ++nfailed;
+            }
+        }
+
+        VisMF::SetHeaderVersion(old_version);
+        VisMF::SetCompressionTolerance(old_tolerance);
+        FArrayBox::setFormat(old_format);
+
+        AMREX_ALWAYS_ASSERT(nfailed == 0);
+        amrex::Print() << "ReadRegion test passed\n";
+    }
+    amrex::Finalize();
+}
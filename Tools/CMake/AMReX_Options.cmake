@@ -197,6 +197,11 @@ cmake_dependent_option(ENABLE_PETSC "Enable PETSc interfaces" OFF
    "ENABLE_LINEAR_SOLVERS" OFF )
 print_option(ENABLE_PETSC)
 
+# SWFFT
+cmake_dependent_option(ENABLE_SWFFT "Enable SWFFT interfaces" OFF
+   "ENABLE_LINEAR_SOLVERS" OFF )
+print_option(ENABLE_SWFFT)
+
 # HDF5
 option(ENABLE_HDF5 "Enable HDF5-based I/O" OFF)
 print_option(ENABLE_HDF5)
@@ -2,19 +2,266 @@
 #include <AMReX_Print.H>
 #include <AMReX_PlotFileUtil.H>
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <limits>
 #include <cmath>
 #include <cstdlib>
+#include <thread>
 
 using namespace amrex;
 
 struct ErrZone {
     Real max_abs_err = std::numeric_limits<Real>::lowest();
-    int level;
-    int grid_index;
+    int level = -1;
+    int grid_index = -1;
     IntVect cell;
 };
 
+// Like MultiFab::maxIndex, ties go to the last grid.
+void merge_zone (ErrZone& zone, Real max_abs_err, int grid_index, IntVect const& cell)
+{
+    if (max_abs_err > zone.max_abs_err or
+        (max_abs_err == zone.max_abs_err and grid_index > zone.grid_index)) {
+        zone.max_abs_err = max_abs_err;
+        zone.grid_index = grid_index;
+        zone.cell = cell;
+    }
+}
+
+// The cores of the node, shared among its processes.
+int default_nthreads ()
+{
+    int nprocs_on_node = 1;
+#ifdef BL_USE_MPI
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(ParallelDescriptor::Communicator(), MPI_COMM_TYPE_SHARED, 0,
+                        MPI_INFO_NULL, &node_comm);
+    MPI_Comm_size(node_comm, &nprocs_on_node);
+    MPI_Comm_free(&node_comm);
+#endif
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / nprocs_on_node);
+}
+
+// Run f(i, thread) for i = 0, ..., ntasks-1 on nthreads threads.
+void run_on_threads (int ntasks, int nthreads, std::function<void(int,int)> const& f)
+{
+    std::atomic<int> next(0);
+    auto worker = [&] (int ithread) {
+        for (int i = next++; i < ntasks; i = next++) {
+            f(i, ithread);
+        }
+    };
+    Vector<std::thread> threads;
+    for (int ithread = 1; ithread < nthreads; ++ithread) {
+        threads.emplace_back(worker, ithread);
+    }
+    worker(0);
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+struct LevelErrors {
+    explicit LevelErrors (int ncomp)
+        : aerror(ncomp, 0.0), denom(ncomp, 0.0), has_nan_a(ncomp, false), has_nan_b(ncomp, false) {}
+    Vector<Real> aerror;  // ||B - A||
+    Vector<Real> denom;   // ||A||
+    Vector<int> has_nan_a;
+    Vector<int> has_nan_b;
+    ErrZone zone;         // of the zone info variable
+    // a difference above the early exit threshold
+    int diff_grid = -1;
+    int diff_comp = -1;
+    IntVect diff_cell;
+    Real diff_a = 0.0;
+    Real diff_b = 0.0;
+};
+
+//
+// Compare a level grid by grid, reading only the grid being compared, one
+// component at a time, on each of nthreads threads.  If thresholds are
+// given, stop at the first difference above them.  The result is reduced
+// over the processes.  The sums of the 1 and 2 norms are taken per grid
+// and added in grid order, so they do not depend on the number of threads.
+//
+LevelErrors compare_level_streaming (PlotFileData& pf_a, PlotFileData& pf_b, int ilev,
+                                     Vector<int> const& ivar_b, int norm, int nthreads,
+                                     int zone_info_var, int save_var, MultiFab& mf_diff,
+                                     Vector<Real> const& thresholds)
+{
+    const int ncomp = ivar_b.size();
+    const BoxArray& ba = pf_a.boxArray(ilev);
+    const DistributionMapping& dmap = pf_a.DistributionMap(ilev);
+    const int myproc = ParallelDescriptor::MyProc();
+    Vector<int> grids;
+    for (int igrid = 0; igrid < ba.size(); ++igrid) {
+        if (dmap[igrid] == myproc) {
+            grids.push_back(igrid);
+        }
+    }
+    const bool early_exit = not thresholds.empty();
+
+    nthreads = std::max(1, std::min(nthreads, static_cast<int>(grids.size())));
+    Vector<LevelErrors> errs(nthreads, LevelErrors(ncomp));
+    Vector<Real> grid_aerror(grids.size()*ncomp, 0.0);
+    Vector<Real> grid_denom(grids.size()*ncomp, 0.0);
+    std::atomic<bool> found(false);
+
+    // fill looks up the grids with the hash maps of the BoxArrays, which
+    // are built on first use, not thread safely.
+    pf_a.boxArray(ilev).intersects(pf_a.probDomain(ilev));
+    pf_b.boxArray(ilev).intersects(pf_b.probDomain(ilev));
+
+    run_on_threads(grids.size(), nthreads, [&] (int i, int ithread)
+    {
+        if (found) {
+            return;
+        }
+        LevelErrors& e = errs[ithread];
+        const int gid = grids[i];
+        const Box& bx = ba[gid];
+        FArrayBox fab_a(bx, 1);
+        FArrayBox fab_b(bx, 1);
+        for (int icomp = 0; icomp < ncomp and not found; ++icomp) {
+            if (ivar_b[icomp] < 0) {
+                continue;
+            }
+            pf_a.fill(fab_a, ilev, icomp, 0, 1);
+            pf_b.fill(fab_b, ilev, ivar_b[icomp], 0, 1);
+            const auto& a = fab_a.const_array();
+            const auto& b = fab_b.const_array();
+            Array4<Real> diff;
+            if (icomp == save_var) {
+                diff = mf_diff[gid].array();
+            }
+            const Real threshold = early_exit ? thresholds[icomp] : 0.0;
+            Real aerr = 0.0;
+            Real denom = 0.0;
+            bool nan_a = false, nan_b = false;
+            Real zone_err = std::numeric_limits<Real>::lowest();
+            IntVect zone_cell;
+            amrex::LoopOnCpu(bx, [&] (int ii, int jj, int kk) noexcept
+            {
+                const Real va = a(ii,jj,kk);
+                const Real vb = b(ii,jj,kk);
+                const Real d = std::abs(vb - va);
+                if (norm == 1) {
+                    aerr += d;
+                    denom += std::abs(va);
+                } else if (norm == 2) {
+                    aerr += d*d;
+                    denom += va*va;
+                } else {
+                    aerr = std::max(aerr, d);
+                    denom = std::max(denom, std::abs(va));
+                }
+                nan_a = nan_a or std::isnan(va);
+                nan_b = nan_b or std::isnan(vb);
+                if (diff) {
+                    diff(ii,jj,kk) = d;
+                }
+                if (icomp == zone_info_var and d >= zone_err) {
+                    zone_err = d;
+                    zone_cell = IntVect(AMREX_D_DECL(ii,jj,kk));
+                }
+                if (early_exit and e.diff_grid < 0 and d > threshold) {
+                    e.diff_grid = gid;
+                    e.diff_comp = icomp;
+                    e.diff_cell = IntVect(AMREX_D_DECL(ii,jj,kk));
+                    e.diff_a = va;
+                    e.diff_b = vb;
+                    found = true;
+                }
+            });
+            grid_aerror[i*ncomp+icomp] = aerr;
+            grid_denom[i*ncomp+icomp] = denom;
+            e.has_nan_a[icomp] = e.has_nan_a[icomp] or nan_a;
+            e.has_nan_b[icomp] = e.has_nan_b[icomp] or nan_b;
+            if (icomp == zone_info_var) {
+                merge_zone(e.zone, zone_err, gid, zone_cell);
+            }
+        }
+    });
+
+    // combine the grids
+    LevelErrors r = errs[0];
+    for (int i = 0; i < grids.size(); ++i) {
+        for (int icomp = 0; icomp < ncomp; ++icomp) {
+            if (norm == 1 or norm == 2) {
+                r.aerror[icomp] += grid_aerror[i*ncomp+icomp];
+                r.denom[icomp] += grid_denom[i*ncomp+icomp];
+            } else {
+                r.aerror[icomp] = std::max(r.aerror[icomp], grid_aerror[i*ncomp+icomp]);
+                r.denom[icomp] = std::max(r.denom[icomp], grid_denom[i*ncomp+icomp]);
+            }
+        }
+    }
+
+    // and the threads
+    for (int ithread = 1; ithread < nthreads; ++ithread) {
+        const LevelErrors& e = errs[ithread];
+        for (int icomp = 0; icomp < ncomp; ++icomp) {
+            r.has_nan_a[icomp] = r.has_nan_a[icomp] or e.has_nan_a[icomp];
+            r.has_nan_b[icomp] = r.has_nan_b[icomp] or e.has_nan_b[icomp];
+        }
+        merge_zone(r.zone, e.zone.max_abs_err, e.zone.grid_index, e.zone.cell);
+        if (e.diff_grid >= 0 and (r.diff_grid < 0 or e.diff_grid < r.diff_grid)) {
+            r.diff_grid = e.diff_grid;
+            r.diff_comp = e.diff_comp;
+            r.diff_cell = e.diff_cell;
+            r.diff_a = e.diff_a;
+            r.diff_b = e.diff_b;
+        }
+    }
+
+    // and the processes
+    if (norm == 1 or norm == 2) {
+        ParallelDescriptor::ReduceRealSum(r.aerror.data(), ncomp);
+        ParallelDescriptor::ReduceRealSum(r.denom.data(), ncomp);
+        if (norm == 2) {
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                r.aerror[icomp] = std::sqrt(r.aerror[icomp]);
+                r.denom[icomp] = std::sqrt(r.denom[icomp]);
+            }
+        }
+    } else {
+        ParallelDescriptor::ReduceRealMax(r.aerror.data(), ncomp);
+        ParallelDescriptor::ReduceRealMax(r.denom.data(), ncomp);
+    }
+    ParallelDescriptor::ReduceIntMax(r.has_nan_a.data(), ncomp);
+    ParallelDescriptor::ReduceIntMax(r.has_nan_b.data(), ncomp);
+
+    if (zone_info_var >= 0) {
+        // ties go to the lowest process
+        Real max_abs_err = r.zone.max_abs_err;
+        ParallelDescriptor::ReduceRealMax(max_abs_err);
+        int owner = (r.zone.max_abs_err == max_abs_err) ? myproc : std::numeric_limits<int>::max();
+        ParallelDescriptor::ReduceIntMin(owner);
+        if (max_abs_err > std::numeric_limits<Real>::lowest()) {
+            ParallelDescriptor::Bcast(&r.zone.grid_index, 1, owner);
+            ParallelDescriptor::Bcast(r.zone.cell.begin(), AMREX_SPACEDIM, owner);
+            r.zone.max_abs_err = max_abs_err;
+            r.zone.level = ilev;
+        }
+    }
+
+    if (early_exit) {
+        int gid = (r.diff_grid >= 0) ? r.diff_grid : std::numeric_limits<int>::max();
+        ParallelDescriptor::ReduceIntMin(gid);
+        if (gid != std::numeric_limits<int>::max()) {
+            const int owner = dmap[gid];
+            ParallelDescriptor::Bcast(&r.diff_comp, 1, owner);
+            ParallelDescriptor::Bcast(r.diff_cell.begin(), AMREX_SPACEDIM, owner);
+            ParallelDescriptor::Bcast(&r.diff_a, 1, owner);
+            ParallelDescriptor::Bcast(&r.diff_b, 1, owner);
+            r.diff_grid = gid;
+        }
+    }
+
+    return r;
+}
+
 int main_main()
 {
     const int narg = amrex::command_argument_count();
@@ -36,6 +283,9 @@ int main_main()
     std::string zone_info_var_name;
     Vector<std::string> plot_names(1);
     bool abort_if_not_all_found = false;
+    bool streaming = false;
+    int nthreads = 0;  // the cores of the node per process
+    bool early_exit = false;
 
     int farg = 1;
     while (farg <= narg) {
@@ -58,6 +308,13 @@ int main_main()
             rtol = std::stod(amrex::get_command_argument(++farg));
         } else if (fname == "--abort_if_not_all_found") {
             abort_if_not_all_found = true;            
+        } else if (fname == "-s" or fname == "--streaming") {
+            streaming = true;
+        } else if (fname == "-t" or fname == "--threads") {
+            nthreads = std::max(1, std::stoi(amrex::get_command_argument(++farg)));
+        } else if (fname == "-e" or fname == "--early_exit") {
+            streaming = true;
+            early_exit = true;
         } else {
             break;
         }
@@ -79,7 +336,7 @@ int main_main()
             << " variable.\n"
             << "\n"
             << " usage:\n"
-            << "    fcompare [-g|--ghost] [-n|--norm num] [-d|--diffvar var] [-z|--zone_info var] [-a|--allow_diff_grids] [-r|rel_tol] file1 file2\n"
+            << "    fcompare [-g|--ghost] [-n|--norm num] [-d|--diffvar var] [-z|--zone_info var] [-a|--allow_diff_grids] [-r|rel_tol] [-s|--streaming] [-t|--threads num] [-e|--early_exit] file1 file2\n"
             << "\n"
             << " optional arguments:\n"
             << "    -g|--ghost            : compare the ghost cells too (if stored)\n"
@@ -90,10 +347,22 @@ int main_main()
             << "                            to the maximum error for the given variable\n"
             << "    -a|--allow_diff_grids : allow different BoxArrays covering the same domain\n"
             << "    -r|--rel_tol rtol     : relative tolerance (default is 0)\n"
+            << "    -s|--streaming        : compare grid by grid, on several threads, instead\n"
+            << "                            of reading whole levels\n"
+            << "    -t|--threads num      : the number of threads per process for --streaming\n"
+            << "                            (default is the cores of the node per process)\n"
+            << "    -e|--early_exit       : stop at the first difference that makes the\n"
+            << "                            comparison fail (implies --streaming); with a\n"
+            << "                            relative tolerance, this is only detected for the\n"
+            << "                            inf norm\n"
             << std::endl;
         return 0;
     }
 
+    if (streaming and nthreads <= 0) {
+        nthreads = default_nthreads();
+    }
+
     PlotFileData pf_a(plotfile_a);
     PlotFileData pf_b(plotfile_b);
     pf_b.syncDistributionMap(pf_a);
@@ -200,35 +469,96 @@ int main_main()
         Vector<Real> rerror_denom(ncomp_a, 0.0);
         Vector<int> has_nan_a(ncomp_a, false);
         Vector<int> has_nan_b(ncomp_a, false);
-        for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
-            if (ivar_b[icomp_a] >= 0) {
-                const MultiFab& mf_a = pf_a.get(ilev, names_a[icomp_a]);
-                MultiFab mf_b;
-                if (grids_match) {
-                    mf_b = pf_b.get(ilev, names_b[ivar_b[icomp_a]]);
-                } else {
-                    mf_b.define(mf_a.boxArray(), mf_a.DistributionMap(), 1, 0);
-                    MultiFab tmp = pf_b.get(ilev, names_b[ivar_b[icomp_a]]);
-                    mf_b.ParallelCopy(tmp);
+        if (streaming) {
+            Vector<Real> thresholds;
+            if (early_exit) {
+                // A difference above these makes the comparison fail.
+                thresholds.resize(ncomp_a, 0.0);
+                if (rtol > 0.0) {
+                    for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
+                        if (norm == 1 or norm == 2) {
+                            thresholds[icomp_a] = std::numeric_limits<Real>::max();
+                        } else if (ivar_b[icomp_a] >= 0) {
+                            const std::string& name = names_a[icomp_a];
+                            thresholds[icomp_a] = rtol * std::max(std::abs(pf_a.min(ilev, name)),
+                                                                  std::abs(pf_a.max(ilev, name)));
+                        }
+                    }
                 }
-                has_nan_a[icomp_a] = mf_a.contains_nan();
-                has_nan_b[icomp_a] = mf_b.contains_nan();
-                MultiFab::Subtract(mf_b,mf_a,0,0,1,0); // b = b - a
-                Real max_err = mf_b.norm0();
-                if (norm == 1) {
-                    aerror[icomp_a] = mf_b.norm1();
-                    rerror[icomp_a] = aerror[icomp_a];
-                    rerror_denom[icomp_a] = mf_a.norm1();
-                } else if (norm == 2) {
-                    aerror[icomp_a] = mf_b.norm2();
-                    rerror[icomp_a] = aerror[icomp_a];
-                    rerror_denom[icomp_a] = mf_a.norm2();
-                } else {
-                    aerror[icomp_a] = max_err;
-                    rerror[icomp_a] = aerror[icomp_a];
-                    rerror_denom[icomp_a] = mf_a.norm0();
+            }
+            LevelErrors e = compare_level_streaming(pf_a, pf_b, ilev, ivar_b, norm, nthreads,
+                                                    zone_info_var_a, save_var_a,
+                                                    mf_array[ilev], thresholds);
+            if (e.diff_grid >= 0) {
+                amrex::Print() << " level = " << ilev << "\n"
+                               << " " << std::setw(24) << std::left << names_a[e.diff_comp]
+                               << "  differs at (i,j,k) = " << e.diff_cell
+                               << std::setprecision(17) << ": " << e.diff_a << " vs " << e.diff_b
+                               << "\n";
+                return EXIT_FAILURE;
+            }
+            aerror = e.aerror;
+            rerror = e.aerror;
+            rerror_denom = e.denom;
+            has_nan_a = e.has_nan_a;
+            has_nan_b = e.has_nan_b;
+            if (e.zone.max_abs_err > err_zone.max_abs_err) {
+                err_zone = e.zone;
+            }
+        } else {
+            for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
+                if (ivar_b[icomp_a] >= 0) {
+                    const MultiFab& mf_a = pf_a.get(ilev, names_a[icomp_a]);
+                    MultiFab mf_b;
+                    if (grids_match) {
+                        mf_b = pf_b.get(ilev, names_b[ivar_b[icomp_a]]);
+                    } else {
+                        mf_b.define(mf_a.boxArray(), mf_a.DistributionMap(), 1, 0);
+                        MultiFab tmp = pf_b.get(ilev, names_b[ivar_b[icomp_a]]);
+                        mf_b.ParallelCopy(tmp);
+                    }
+                    has_nan_a[icomp_a] = mf_a.contains_nan();
+                    has_nan_b[icomp_a] = mf_b.contains_nan();
+                    MultiFab::Subtract(mf_b,mf_a,0,0,1,0); // b = b - a
+                    Real max_err = mf_b.norm0();
+                    if (norm == 1) {
+                        aerror[icomp_a] = mf_b.norm1();
+                        rerror[icomp_a] = aerror[icomp_a];
+                        rerror_denom[icomp_a] = mf_a.norm1();
+                    } else if (norm == 2) {
+                        aerror[icomp_a] = mf_b.norm2();
+                        rerror[icomp_a] = aerror[icomp_a];
+                        rerror_denom[icomp_a] = mf_a.norm2();
+                    } else {
+                        aerror[icomp_a] = max_err;
+                        rerror[icomp_a] = aerror[icomp_a];
+                        rerror_denom[icomp_a] = mf_a.norm0();
+                    }
+
+                    if (icomp_a == save_var_a or icomp_a == zone_info_var_a) {
+                        mf_b.abs(0,1);
+                    }
+
+                    if (icomp_a == save_var_a) {
+                        MultiFab::Copy(mf_array[ilev], mf_b, 0, 0, 1, 0);
+                    }
+
+                    if (icomp_a == zone_info_var_a) {
+                        if (max_err > err_zone.max_abs_err) {
+                            err_zone.max_abs_err = max_err;
+                            err_zone.level = ilev;
+                            err_zone.cell = mf_b.maxIndex(0);
+                            auto isects = pf_a.boxArray(ilev).intersections
+                                (Box(err_zone.cell,err_zone.cell), true, 0);
+                            err_zone.grid_index = isects[0].first;
+                        }
+                    }
                 }
+            }
+        }
 
+        for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
+            if (ivar_b[icomp_a] >= 0) {
                 if (norm == 0) {
                     rerror[icomp_a] /= rerror_denom[icomp_a];
                 } else {
@@ -240,25 +570,6 @@ int main_main()
                     aerror[icomp_a] *= std::pow(dv,1./static_cast<Real>(norm));
                     rerror[icomp_a] = rerror[icomp_a]/rerror_denom[icomp_a];
                 }
-
-                if (icomp_a == save_var_a or icomp_a == zone_info_var_a) {
-                    mf_b.abs(0,1);
-                }
-
-                if (icomp_a == save_var_a) {
-                    MultiFab::Copy(mf_array[ilev], mf_b, 0, 0, 1, 0);
-                }
-
-                if (icomp_a == zone_info_var_a) {
-                    if (max_err > err_zone.max_abs_err) {
-                        err_zone.max_abs_err = max_err;
-                        err_zone.level = ilev;
-                        err_zone.cell = mf_b.maxIndex(0);
-                        auto isects = pf_a.boxArray(ilev).intersections
-                            (Box(err_zone.cell,err_zone.cell), true, 0);
-                        err_zone.grid_index = isects[0].first;
-                    }
-                }
             }
         }
 
@@ -328,10 +639,10 @@ int main_main()
                                   << "   level = " << err_zone.level << " (i,j,k) = " << err_zone.cell << "\n";
             }
 
+            const Box cellbox(err_zone.cell, err_zone.cell);
             for (int icomp_a = 0; icomp_a < ncomp_a; ++icomp_a) {
-                const MultiFab& mf = pf_a.get(err_zone.level,names_a[icomp_a]);
                 if (owner_proc) {
-                    Real v = mf[err_zone.grid_index](err_zone.cell);
+                    Real v = pf_a.get(err_zone.level, names_a[icomp_a], cellbox)(err_zone.cell);
                     amrex::AllPrint() << " " << std::setw(24)
                                       << names_a[icomp_a] << "  "
                                       << std::setw(24) << std::right
@@ -170,15 +170,37 @@ void main_main()
 
         Array<Real,AMREX_SPACEDIM> dx = pf.cellSize(ilev);
 
+        IntVect ratio{1};
         if (ilev < fine_level) {
-            IntVect ratio{pf.refRatio(ilev)};
+            ratio = IntVect{pf.refRatio(ilev)};
             for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
                 ratio[idim] = 1;
             }
-            const iMultiFab mask = makeFineMask(pf.boxArray(ilev), pf.DistributionMap(ilev),
-                                                pf.boxArray(ilev+1), ratio);
+        }
+
+        // Only the parts of the grids on the slice are read.
+        BoxList slice_bl;
+        for (auto const& is : pf.boxArray(ilev).intersections(slice_box & pf.probDomain(ilev))) {
+            slice_bl.push_back(is.second);
+        }
+        if (slice_bl.isEmpty()) {
+            rr *= ratio;
+            continue;
+        }
+        const BoxArray slice_ba(std::move(slice_bl));
+        const DistributionMapping slice_dm(slice_ba);
+        MultiFab mf(slice_ba, slice_dm, 1, 0);
+        auto read_slice = [&] (std::string const& var_name)
+        {
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                pf.fill(mf[mfi], ilev, var_name);
+            }
+        };
+
+        if (ilev < fine_level) {
+            const iMultiFab mask = makeFineMask(slice_ba, slice_dm, pf.boxArray(ilev+1), ratio);
             for (int ivar = 0; ivar < var_names.size(); ++ivar) {
-                const MultiFab& mf = pf.get(ilev, var_names[ivar]);
+                read_slice(var_names[ivar]);
                 for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
                     const Box& bx = mfi.validbox() & slice_box;
                     if (bx.ok()) {
@@ -208,7 +230,7 @@ void main_main()
             rr *= ratio;
         } else {
             for (int ivar = 0; ivar < var_names.size(); ++ivar) {
-                const MultiFab& mf = pf.get(ilev, var_names[ivar]);
+                read_slice(var_names[ivar]);
                 for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
                     const Box& bx = mfi.validbox() & slice_box;
                     if (bx.ok()) {
@@ -0,0 +1,227 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <limits>
+#include <cmath>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+using namespace amrex;
+
+namespace {
+
+// Gather the cells found by all processes on the I/O processor.
+void gather_cells (PlotFileCells& r)
+{
+    ParallelDescriptor::ReduceIntSum(r.ngrids_read, ParallelDescriptor::IOProcessorNumber());
+#ifdef BL_USE_MPI
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+    const int n = r.values.size();
+    const std::vector<int> counts = ParallelDescriptor::Gather(n, ioproc);
+
+    std::vector<int> rc(nprocs,0), disp(nprocs,0), rciv(nprocs,0), dispiv(nprocs,0);
+    int ntot = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        for (int i = 0; i < nprocs; ++i) {
+            rc[i] = counts[i];
+            disp[i] = ntot;
+            rciv[i] = counts[i]*AMREX_SPACEDIM;
+            dispiv[i] = ntot*AMREX_SPACEDIM;
+            ntot += counts[i];
+        }
+    }
+
+    Vector<int> ivs;
+    ivs.reserve(n*AMREX_SPACEDIM);
+    for (auto const& iv : r.cells) {
+        ivs.insert(ivs.end(), iv.begin(), iv.end());
+    }
+    Vector<int> allivs(std::max(ntot*AMREX_SPACEDIM,1));
+    Vector<Real> allvalues(std::max(ntot,1));
+    ParallelDescriptor::Gatherv(ivs.data(), n*AMREX_SPACEDIM, allivs.data(), rciv, dispiv, ioproc);
+    ParallelDescriptor::Gatherv(r.values.data(), n, allvalues.data(), rc, disp, ioproc);
+
+    r.cells.resize(ntot);
+    r.values.resize(ntot);
+    for (int i = 0; i < ntot; ++i) {
+        r.cells[i] = IntVect(&allivs[i*AMREX_SPACEDIM]);
+        r.values[i] = allvalues[i];
+    }
+#endif
+}
+
+}
+
+void main_main()
+{
+    const int narg = amrex::command_argument_count();
+
+    std::string varname;
+    std::string region_arg;
+    Real vlo = std::numeric_limits<Real>::lowest();
+    Real vhi = std::numeric_limits<Real>::max();
+    int level = -1;
+    bool count_only = false;
+    bool cache = false;
+
+    int farg = 1;
+    while (farg <= narg) {
+        const std::string& name = amrex::get_command_argument(farg);
+        if (name == "-v" or name == "--variable") {
+            varname = amrex::get_command_argument(++farg);
+        } else if (name == "--min") {
+            vlo = std::stod(amrex::get_command_argument(++farg));
+        } else if (name == "--max") {
+            vhi = std::stod(amrex::get_command_argument(++farg));
+        } else if (name == "-r" or name == "--region") {
+            region_arg = amrex::get_command_argument(++farg);
+        } else if (name == "-l" or name == "--level") {
+            level = std::stoi(amrex::get_command_argument(++farg));
+        } else if (name == "-n" or name == "--count") {
+            count_only = true;
+        } else if (name == "-c" or name == "--cache") {
+            cache = true;
+        } else {
+            break;
+        }
+        ++farg;
+    }
+
+    if (varname.empty() or farg > narg) {
+        amrex::Print()
+            << "\n"
+            << " Find the cells of a plotfile in which a variable is in a range.\n"
+            << " Grids are skipped without being read if the min and max of the\n"
+            << " variable on them are outside the range.\n"
+            << "\n"
+            << " Usage:\n"
+            << "    fquery -v variable [--min lo] [--max hi] [-r region] [-l level] [-n] [-c] plotfile\n"
+            << "\n"
+            << " args [-v|--variable] varname : the variable to query\n"
+            << "      --min lo                : find values >= lo\n"
+            << "      --max hi                : find values <= hi\n"
+            << "      [-r|--region] \"lo hi\"   : only search the cells whose centers are in\n"
+            << "                                the box with physical corners lo and hi,\n"
+            << "                                given as a space separated string\n"
+            << "      [-l|--level] level      : only search this level; by default all\n"
+            << "                                levels are searched, skipping the cells\n"
+            << "                                covered by a finer level\n"
+            << "      [-n|--count]            : only report the numbers of cells found\n"
+            << "      [-c|--cache]            : if the headers do not have the min and\n"
+            << "                                max of each grid, cache them in files\n"
+            << "                                next to the data of each level\n"
+            << std::endl;
+        return;
+    }
+
+    const std::string& pltfile = amrex::get_command_argument(farg);
+    PlotFileData pf(pltfile);
+    pf.setIndexCaching(cache);
+    const int dim = pf.spaceDim();
+    const auto problo = pf.probLo();
+
+    Array<Real,AMREX_SPACEDIM> rlo = problo;
+    Array<Real,AMREX_SPACEDIM> rhi = pf.probHi();
+    if (not region_arg.empty()) {
+        std::istringstream is(region_arg);
+        Vector<Real> corners{std::istream_iterator<Real>{is}, std::istream_iterator<Real>{}};
+        if (corners.size() != 2*dim) {
+            amrex::Abort("fquery: the region needs "+std::to_string(2*dim)+" coordinates");
+        }
+        for (int idim = 0; idim < dim; ++idim) {
+            rlo[idim] = corners[idim];
+            rhi[idim] = corners[idim+dim];
+        }
+    }
+
+    const int lev_begin = (level >= 0) ? level : 0;
+    const int lev_end = (level >= 0) ? level : pf.finestLevel();
+    if (lev_begin > pf.finestLevel()) {
+        amrex::Abort("fquery: the plotfile has no level "+std::to_string(level));
+    }
+
+    amrex::Print() << "# plotfile = " << pltfile << "\n"
+                   << "# variable = " << varname << " in [" << vlo << ", " << vhi << "]\n";
+    if (not count_only) {
+        amrex::Print() << "# " << std::setw(5) << "level" << " "
+                       << std::setw(AMREX_SPACEDIM*6) << "cell";
+        for (int idim = 0; idim < dim; ++idim) {
+            amrex::Print() << " " << std::setw(20) << std::string(1,"xyz"[idim]);
+        }
+        amrex::Print() << " " << std::setw(20) << varname << "\n";
+    }
+
+    Long ntotal = 0;
+    for (int ilev = lev_begin; ilev <= lev_end; ++ilev) {
+        const auto dx = pf.cellSize(ilev);
+        IntVect lo(0), hi(0);
+        for (int idim = 0; idim < dim; ++idim) {
+            lo[idim] = static_cast<int>(std::ceil((rlo[idim]-problo[idim])/dx[idim] - 0.5));
+            hi[idim] = static_cast<int>(std::floor((rhi[idim]-problo[idim])/dx[idim] - 0.5));
+        }
+        const Box region = Box(lo,hi) & pf.probDomain(ilev);
+        if (not region.ok()) {
+            continue;
+        }
+
+        PlotFileCells r = pf.findCells(ilev, varname, vlo, vhi, region);
+
+        if (level < 0 and ilev < pf.finestLevel()) {
+            IntVect ratio{pf.refRatio(ilev)};
+            for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
+                ratio[idim] = 1;
+            }
+            const BoxArray& cfba = amrex::coarsen(pf.boxArray(ilev+1), ratio);
+            int n = 0;
+            for (int i = 0, N = r.cells.size(); i < N; ++i) {
+                if (not cfba.contains(r.cells[i])) {
+                    r.cells[n] = r.cells[i];
+                    r.values[n] = r.values[i];
+                    ++n;
+                }
+            }
+            r.cells.resize(n);
+            r.values.resize(n);
+        }
+
+        if (count_only) {
+            Long ncells = r.cells.size();
+            ParallelDescriptor::ReduceLongSum(ncells, ParallelDescriptor::IOProcessorNumber());
+            ParallelDescriptor::ReduceIntSum(r.ngrids_read, ParallelDescriptor::IOProcessorNumber());
+            ntotal += ncells;
+            amrex::Print() << "# level " << ilev << ": " << ncells << " cells, read "
+                           << r.ngrids_read << " of " << pf.boxArray(ilev).size() << " grids\n";
+        } else {
+            gather_cells(r);
+            ntotal += r.cells.size();
+            amrex::Print() << "# level " << ilev << ": " << r.cells.size() << " cells, read "
+                           << r.ngrids_read << " of " << pf.boxArray(ilev).size() << " grids\n";
+            std::ostringstream os;
+            os.precision(12);
+            for (int i = 0, N = r.cells.size(); i < N; ++i) {
+                const IntVect& iv = r.cells[i];
+                os << "  " << std::setw(5) << ilev << " ";
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    os << std::setw(6) << iv[idim];
+                }
+                for (int idim = 0; idim < dim; ++idim) {
+                    os << " " << std::setw(20) << problo[idim] + (iv[idim]+0.5)*dx[idim];
+                }
+                os << " " << std::setw(20) << r.values[i] << "\n";
+            }
+            amrex::Print() << os.str();
+        }
+    }
+    amrex::Print() << "# total: " << ntotal << " cells\n";
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::SetVerbose(0);
+    amrex::Initialize(argc, argv, false);
+    main_main();
+    amrex::Finalize();
+}
@@ -197,9 +197,31 @@ void main_main()
     Real gmn = std::numeric_limits<Real>::max();
 
     for (int ilev = 0; ilev <= max_level; ++ilev) {
-        const MultiFab& pltmf = pf.get(ilev, compname);
-        gmx = std::max(gmx, pltmf.max(0));
-        gmn = std::min(gmn, pltmf.min(0));
+        gmx = std::max(gmx, pf.max(ilev, compname));
+        gmn = std::min(gmn, pf.min(ilev, compname));
+
+        IntVect rrlev {rr[ilev]};
+        for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
+            rrlev[idim] = 1;
+        }
+
+        // Only the parts of the grids on the slices are read.
+        BoxList slice_bl;
+        for (int idir = ndir_begin; idir < ndir_end; ++idir) {
+            const Box& crsebox = amrex::coarsen(finebox[idir], rrlev);
+            for (auto const& is : pf.boxArray(ilev).intersections(crsebox)) {
+                slice_bl.push_back(is.second);
+            }
+        }
+        if (slice_bl.isEmpty()) {
+            continue;
+        }
+        const BoxArray slice_ba(std::move(slice_bl));
+        MultiFab pltmf(slice_ba, DistributionMapping{slice_ba}, 1, 0);
+        for (MFIter mfi(pltmf); mfi.isValid(); ++mfi) {
+            pf.fill(pltmf[mfi], ilev, compname);
+        }
+
         if (ilev < max_level) {
             IntVect ratio{pf.refRatio(ilev)};
             for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
@@ -210,10 +232,6 @@ void main_main()
                 const auto& m = mask.array(mfi);
                 const auto& plt = pltmf.array(mfi);
                 const Box& bx = mfi.validbox();
-                IntVect rrlev {rr[ilev]};
-                for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
-                    rrlev[idim] = 1;
-                }
                 for (int idir = ndir_begin; idir < ndir_end; ++idir) {
                     const Box& crsebox = amrex::coarsen(finebox[idir], rrlev);
                     const Box& ibox = bx & crsebox;